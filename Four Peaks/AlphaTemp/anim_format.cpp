@@ -0,0 +1,282 @@
+// ---------------------------------------------------------------------------
+// anim_format.cpp
+// ---------------------------------------------------------------------------
+//
+// Text source format (one directive per line, '#' starts a comment):
+//
+//   clip <name> <sheet> <seconds per frame> loop|hold
+//   frames <count>                         equal-width columns, full height
+//   frame <u0> <v0> <u1> <v1> [seconds]    one rect, in sheet fractions
+//   end
+// ---------------------------------------------------------------------------
+
+#include "anim_format.hpp"
+#include <cstring>
+#include <sstream>
+
+namespace game
+{
+    namespace
+    {
+        std::string trim(const std::string& s)
+        {
+            const size_t b = s.find_first_not_of(" \t\r\n");
+            if (b == std::string::npos)
+                return std::string();
+            const size_t e = s.find_last_not_of(" \t\r\n");
+            return s.substr(b, e - b + 1);
+        }
+
+        bool checkRange(size_t offset, size_t size, size_t total)
+        {
+            return offset <= total && size <= total - offset;
+        }
+
+        AnimFrame untrimmed(f32 u0, f32 v0, f32 u1, f32 v1, f32 duration)
+        {
+            return AnimFrame{ u0, v0, u1, v1, duration, 0.0f, 0.0f, 1.0f, 1.0f };
+        }
+
+        int findClip(const AnimSource& anim, const std::string& name)
+        {
+            for (size_t i = 0; i < anim.clips.size(); ++i)
+            {
+                if (anim.clips[i].name == name)
+                    return static_cast<int>(i);
+            }
+            return -1;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // parseAnimText
+    // -------------------------------------------------------------------
+    bool parseAnimText(const std::string& text, AnimSource& out, std::string& error)
+    {
+        out = AnimSource();
+
+        std::istringstream in(text);
+        std::string line;
+        int lineNo = 0;
+
+        auto fail = [&](const std::string& msg)
+        {
+            error = "line " + std::to_string(lineNo) + ": " + msg;
+            out = AnimSource();
+            return false;
+        };
+
+        while (std::getline(in, line))
+        {
+            ++lineNo;
+            line = trim(line);
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream words(line);
+            std::string key;
+            words >> key;
+            if (key != "clip")
+                return fail("unknown directive '" + key + "'");
+
+            AnimClipSource c;
+            std::string mode;
+            f32 frameTime = 0.0f;
+            if (!(words >> c.name >> c.sheet >> frameTime >> mode))
+                return fail("clip needs: name sheet seconds loop|hold");
+            if (c.name.size() >= kAnimNameMax)
+                return fail("clip name longer than " + std::to_string(kAnimNameMax - 1) + " characters");
+            if (!(frameTime > 0.0f))
+                return fail("frame time must be positive");
+            if (mode != "loop" && mode != "hold")
+                return fail("expected loop or hold, got '" + mode + "'");
+            if (findClip(out, c.name) >= 0)
+                return fail("clip '" + c.name + "' defined twice");
+
+            c.loop = mode == "loop";
+            c.firstFrame = static_cast<u32>(out.frames.size());
+
+            // Frame lines up to 'end'.
+            bool ended = false;
+            while (!ended && std::getline(in, line))
+            {
+                ++lineNo;
+                line = trim(line);
+                if (line.empty() || line[0] == '#')
+                    continue;
+
+                std::istringstream fw(line);
+                fw >> key;
+                if (key == "end")
+                {
+                    ended = true;
+                }
+                else if (key == "frames")
+                {
+                    int count = 0;
+                    if (!(fw >> count) || count <= 0 || count > 1024)
+                        return fail("bad frame count");
+
+                    const f32 w = 1.0f / count;
+                    for (int i = 0; i < count; ++i)
+                        out.frames.push_back(untrimmed(i * w, 0.0f, (i + 1) * w, 1.0f, frameTime));
+                }
+                else if (key == "frame")
+                {
+                    f32 u0, v0, u1, v1;
+                    if (!(fw >> u0 >> v0 >> u1 >> v1))
+                        return fail("frame needs: u0 v0 u1 v1 [seconds]");
+                    // A failed float read stores 0, so the optional time is
+                    // read as a word and must be a whole positive number.
+                    f32 t = frameTime;
+                    std::string seconds;
+                    if (fw >> seconds)
+                    {
+                        std::istringstream sw(seconds);
+                        if (!(sw >> t) || sw.peek() != std::char_traits<char>::eof() || !(t > 0.0f))
+                            return fail("frame time must be a positive number, got '" + seconds + "'");
+                    }
+                    out.frames.push_back(untrimmed(u0, v0, u1, v1, t));
+                }
+                else
+                {
+                    return fail("unknown clip directive '" + key + "'");
+                }
+            }
+
+            if (!ended)
+                return fail("clip '" + c.name + "' has no 'end'");
+
+            c.frameCount = static_cast<u32>(out.frames.size()) - c.firstFrame;
+            if (c.frameCount == 0)
+                return fail("clip '" + c.name + "' has no frames");
+            out.clips.push_back(c);
+        }
+
+        if (out.clips.empty())
+            return fail("no clips");
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // cooked image
+    // -------------------------------------------------------------------
+    bool isAnimImage(const u8* data, size_t size)
+    {
+        return size >= sizeof(AnimFileHeader) && std::memcmp(data, kAnimMagic, sizeof(kAnimMagic)) == 0;
+    }
+
+    bool buildAnimImage(const AnimSource& anim, const std::vector<u8>& atlas,
+        std::vector<u8>& out, std::string& error)
+    {
+        if (anim.clips.empty() || anim.clips.size() > 0xFFFF)
+        {
+            error = "bad clip count";
+            return false;
+        }
+
+        AnimFileHeader hdr{};
+        std::memcpy(hdr.magic, kAnimMagic, sizeof(hdr.magic));
+        hdr.version = kAnimVersion;
+        hdr.clipCount = static_cast<u16>(anim.clips.size());
+        hdr.frameCount = static_cast<u32>(anim.frames.size());
+        hdr.atlasOffset = static_cast<u32>(sizeof(AnimFileHeader) +
+            anim.clips.size() * sizeof(AnimClipRecord) + anim.frames.size() * sizeof(AnimFrame));
+        hdr.atlasSize = static_cast<u32>(atlas.size());
+
+        out.resize(hdr.atlasOffset + atlas.size());
+        u8* p = out.data();
+        std::memcpy(p, &hdr, sizeof(hdr));
+        p += sizeof(hdr);
+
+        for (const AnimClipSource& c : anim.clips)
+        {
+            if (c.name.size() >= kAnimNameMax)
+            {
+                error = "clip name '" + c.name + "' too long";
+                return false;
+            }
+            AnimClipRecord rec{};
+            std::memcpy(rec.name, c.name.c_str(), c.name.size());
+            rec.firstFrame = c.firstFrame;
+            rec.frameCount = c.frameCount;
+            rec.flags = c.loop ? kAnimClipLoop : 0;
+            std::memcpy(p, &rec, sizeof(rec));
+            p += sizeof(rec);
+        }
+
+        if (!anim.frames.empty())
+            std::memcpy(p, anim.frames.data(), anim.frames.size() * sizeof(AnimFrame));
+        if (!atlas.empty())
+            std::memcpy(out.data() + hdr.atlasOffset, atlas.data(), atlas.size());
+        return true;
+    }
+
+    bool readAnimImage(const u8* data, size_t size, AnimSource& out,
+        const u8*& atlas, size_t& atlasSize, std::string& error)
+    {
+        out = AnimSource();
+        atlas = nullptr;
+        atlasSize = 0;
+
+        auto fail = [&](const char* msg)
+        {
+            error = msg;
+            out = AnimSource();
+            return false;
+        };
+
+        if (!isAnimImage(data, size))
+            return fail("not a cooked animation");
+
+        AnimFileHeader hdr;
+        std::memcpy(&hdr, data, sizeof(hdr));
+        if (hdr.version != kAnimVersion)
+            return fail("unsupported animation version");
+
+        const size_t clipsAt = sizeof(AnimFileHeader);
+        const size_t framesAt = clipsAt + hdr.clipCount * sizeof(AnimClipRecord);
+        if (!checkRange(clipsAt, hdr.clipCount * sizeof(AnimClipRecord), size) ||
+            !checkRange(framesAt, static_cast<size_t>(hdr.frameCount) * sizeof(AnimFrame), size) ||
+            !checkRange(hdr.atlasOffset, hdr.atlasSize, size))
+            return fail("truncated animation");
+
+        TextureBlobHeader tex;
+        if (hdr.atlasSize < sizeof(tex))
+            return fail("animation has no atlas");
+        std::memcpy(&tex, data + hdr.atlasOffset, sizeof(tex));
+        if (std::memcmp(tex.magic, kTextureMagic, sizeof(tex.magic)) != 0 || tex.format != 0 ||
+            (hdr.atlasSize - sizeof(tex)) / 4 / (tex.width ? tex.width : 1) < tex.height)
+            return fail("bad animation atlas");
+
+        out.clips.resize(hdr.clipCount);
+        for (u16 i = 0; i < hdr.clipCount; ++i)
+        {
+            AnimClipRecord rec;
+            std::memcpy(&rec, data + clipsAt + i * sizeof(rec), sizeof(rec));
+            rec.name[kAnimNameMax - 1] = '\0';
+            if (rec.frameCount == 0 || rec.firstFrame > hdr.frameCount ||
+                rec.frameCount > hdr.frameCount - rec.firstFrame)
+                return fail("clip frame range out of bounds");
+
+            AnimClipSource& c = out.clips[i];
+            c.name = rec.name;
+            c.firstFrame = rec.firstFrame;
+            c.frameCount = rec.frameCount;
+            c.loop = (rec.flags & kAnimClipLoop) != 0;
+        }
+
+        out.frames.resize(hdr.frameCount);
+        if (hdr.frameCount > 0)
+            std::memcpy(out.frames.data(), data + framesAt, hdr.frameCount * sizeof(AnimFrame));
+        for (const AnimFrame& f : out.frames)
+        {
+            if (!(f.duration > 0.0f))
+                return fail("frame time must be positive");   // the animator would never advance
+        }
+
+        atlas = data + hdr.atlasOffset;
+        atlasSize = hdr.atlasSize;
+        return true;
+    }
+}
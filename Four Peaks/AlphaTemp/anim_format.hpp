@@ -0,0 +1,111 @@
+// ---------------------------------------------------------------------------
+// anim_format.hpp
+// ---------------------------------------------------------------------------
+//
+// Sprite animation data: the .anim text source and its cooked binary form.
+//
+// The text source (see Assets/player/male_hero.anim) lists clips, each
+// naming a sprite sheet and its frame rects in sheet fractions.
+//
+// The cook (Tools/assetcook) trims every frame to the bounding box of its
+// visible pixels and packs the trimmed frames of all clips into one atlas
+// stored in the same file. Each frame keeps where its visible rect sat in
+// the untrimmed frame, so a quad sized and offset by it covers exactly the
+// pixels the full frame would have: pivots and feet alignment are
+// unchanged, only the transparent border is no longer stored or drawn.
+//
+// Cooked file layout (little-endian, offsets from the start of the file):
+//
+//   AnimFileHeader
+//   AnimClipRecord[clipCount]
+//   AnimFrame[frameCount]
+//   TextureBlobHeader + RGBA8 pixels     (the atlas, at atlasOffset)
+//
+
+#ifndef ANIM_FORMAT_HPP
+#define ANIM_FORMAT_HPP
+
+#include "asset_pack.hpp"
+#include <AETypes.h>   // u8, u16, u32, f32
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    static const char kAnimMagic[4] = { 'F', 'P', 'A', 'N' };
+    static const u16  kAnimVersion = 1;
+
+    // One frame; stored as is in the cooked file.
+    struct AnimFrame
+    {
+        f32 u0, v0, u1, v1;     // in the clip's sheet, or the atlas once cooked
+        f32 duration;           // seconds
+
+        // Visible rect in the untrimmed frame, in fractions of the frame
+        // with y up: centre offset from the frame centre, and size.
+        // Untrimmed frames are { 0, 0, 1, 1 }.
+        f32 offsetX, offsetY;
+        f32 width, height;
+    };
+
+    struct AnimClipSource
+    {
+        std::string name;
+        std::string sheet;      // asset path; empty once cooked (atlas)
+        u32 firstFrame;         // into AnimSource::frames
+        u32 frameCount;
+        bool loop;              // false = hold the last frame
+    };
+
+    struct AnimSource
+    {
+        std::vector<AnimClipSource> clips;
+        std::vector<AnimFrame> frames;  // every clip's frames, back to back
+    };
+
+    struct AnimFileHeader
+    {
+        char magic[4];          // "FPAN"
+        u16  version;
+        u16  clipCount;
+        u32  frameCount;
+        u32  atlasOffset;
+        u32  atlasSize;         // TextureBlobHeader + pixels
+    };
+
+    static const size_t kAnimNameMax = 24;  // including the terminator
+
+    struct AnimClipRecord
+    {
+        char name[kAnimNameMax];
+        u32  firstFrame;
+        u32  frameCount;
+        u32  flags;             // kAnimClipLoop
+    };
+
+    static const u32 kAnimClipLoop = 1;
+
+    static_assert(sizeof(AnimFileHeader) == 20, "AnimFileHeader layout changed");
+    static_assert(sizeof(AnimClipRecord) == 36, "AnimClipRecord layout changed");
+    static_assert(sizeof(AnimFrame) == 36, "AnimFrame layout changed");
+
+    // Text source -> clips with untrimmed frames. On error reports
+    // "line N: ...".
+    bool parseAnimText(const std::string& text, AnimSource& out, std::string& error);
+
+    // True if data starts like a cooked .anim.
+    bool isAnimImage(const u8* data, size_t size);
+
+    // Cooked image from frames that already point into the atlas.
+    // atlas is a TextureBlobHeader + RGBA8 blob.
+    bool buildAnimImage(const AnimSource& anim, const std::vector<u8>& atlas,
+        std::vector<u8>& out, std::string& error);
+
+    // Validates a cooked image and fills out (sheets left empty); atlas
+    // points at the TextureBlobHeader inside data.
+    bool readAnimImage(const u8* data, size_t size, AnimSource& out,
+        const u8*& atlas, size_t& atlasSize, std::string& error);
+}
+
+#endif // ANIM_FORMAT_HPP
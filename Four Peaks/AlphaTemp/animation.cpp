@@ -0,0 +1,278 @@
+// ---------------------------------------------------------------------------
+// animation.cpp
+// ---------------------------------------------------------------------------
+
+#include "animation.hpp"
+#include "graphics.hpp"
+#include "vfs_loaders.hpp"
+#include <cstring>
+
+namespace game
+{
+    // ===================================================================
+    // AnimationSet
+    // ===================================================================
+    AnimationSet::~AnimationSet()
+    {
+        clear();
+    }
+
+    void AnimationSet::freeGpu()
+    {
+        for (AEGfxVertexList* m : meshes)
+        {
+            if (m)
+                AEGfxMeshFree(m);
+        }
+        meshes.clear();
+
+        for (AEGfxTexture* t : textures)
+        {
+            if (t)
+                AEGfxTextureUnload(t);
+        }
+        textures.clear();
+    }
+
+    void AnimationSet::clear()
+    {
+        freeGpu();
+        clips.clear();
+        frames.clear();
+        durations.clear();
+        sheets.clear();
+        atlas.clear();
+    }
+
+    int AnimationSet::find(const char* name) const
+    {
+        for (size_t i = 0; i < clips.size(); ++i)
+        {
+            if (clips[i].name == name)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    AEGfxTexture* AnimationSet::texture(int clip) const
+    {
+        if (clip < 0 || clip >= clipCount())
+            return nullptr;
+        const u32 t = clips[clip].texture;
+        return t < textures.size() ? textures[t] : nullptr;
+    }
+
+    AEGfxVertexList* AnimationSet::mesh(u32 frame, bool flipped) const
+    {
+        const size_t i = static_cast<size_t>(frame) * 2 + (flipped ? 1 : 0);
+        return i < meshes.size() ? meshes[i] : nullptr;
+    }
+
+    // -------------------------------------------------------------------
+    // load
+    // -------------------------------------------------------------------
+    bool AnimationSet::load(const u8* data, size_t size, std::string& error)
+    {
+        clear();
+
+        AnimSource src;
+        const u8* blob = nullptr;
+        size_t blobSize = 0;
+        if (isAnimImage(data, size))
+        {
+            if (!readAnimImage(data, size, src, blob, blobSize, error))
+                return false;
+
+            // Copied: the cache may drop the file before upload() runs.
+            atlas.assign(blob, blob + blobSize);
+        }
+        else if (!parseAnimText(std::string(reinterpret_cast<const char*>(data), size), src, error))
+        {
+            return false;
+        }
+
+        clips.reserve(src.clips.size());
+        for (const AnimClipSource& c : src.clips)
+        {
+            // Cooked clips all share the atlas.
+            u32 tex = 0;
+            if (!c.sheet.empty())
+            {
+                while (tex < sheets.size() && sheets[tex] != c.sheet)
+                    ++tex;
+                if (tex == sheets.size())
+                    sheets.push_back(c.sheet);
+            }
+            clips.push_back(AnimClip{ c.name, c.firstFrame, c.frameCount, c.loop, tex });
+        }
+
+        frames = std::move(src.frames);
+        durations.reserve(frames.size());
+        for (const AnimFrame& f : frames)
+            durations.push_back(f.duration);
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // upload
+    // -------------------------------------------------------------------
+    void AnimationSet::upload()
+    {
+        freeGpu();
+
+        if (!atlas.empty())
+        {
+            TextureBlobHeader hdr;
+            std::memcpy(&hdr, atlas.data(), sizeof(hdr));
+            textures.push_back(AEGfxTextureLoadFromMemory(atlas.data() + sizeof(hdr), hdr.width, hdr.height));
+
+            // AE keeps its own copy.
+            std::vector<u8>().swap(atlas);
+        }
+        else
+        {
+            for (const std::string& sheet : sheets)
+                textures.push_back(vfs::loadTexture(sheet.c_str()));
+        }
+
+        // Quad coordinates are fractions of the untrimmed frame, which the
+        // draw scales to the sprite size.
+        meshes.reserve(frames.size() * 2);
+        for (const AnimFrame& f : frames)
+        {
+            const f32 x0 = f.offsetX - f.width * 0.5f;
+            const f32 x1 = f.offsetX + f.width * 0.5f;
+            const f32 y0 = f.offsetY - f.height * 0.5f;
+            const f32 y1 = f.offsetY + f.height * 0.5f;
+            meshes.push_back(gfx::buildSpriteMesh(x0, y0, x1, y1, f.u0, f.v0, f.u1, f.v1));
+            meshes.push_back(gfx::buildSpriteMesh(-x1, y0, -x0, y1, f.u1, f.v0, f.u0, f.v1));
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // replace
+    // -------------------------------------------------------------------
+    void AnimationSet::replace(AnimationSet& fresh)
+    {
+        clear();
+        clips.swap(fresh.clips);
+        frames.swap(fresh.frames);
+        durations.swap(fresh.durations);
+        sheets.swap(fresh.sheets);
+        atlas.swap(fresh.atlas);
+        upload();
+    }
+
+    // ===================================================================
+    // Animator
+    // ===================================================================
+    Animator::Animator(const AnimationSet& animations)
+        : set(animations)
+    {
+    }
+
+    u32 Animator::add(int c)
+    {
+        const u32 slot = static_cast<u32>(frame.size());
+        clip.push_back(-1);
+        frame.push_back(0);
+        first.push_back(0);
+        last.push_back(0);
+        loop.push_back(0);
+        timer.push_back(0.0f);
+        play(slot, c);
+        return slot;
+    }
+
+    void Animator::clear()
+    {
+        clip.clear();
+        frame.clear();
+        first.clear();
+        last.clear();
+        loop.clear();
+        timer.clear();
+    }
+
+    void Animator::play(u32 slot, int c)
+    {
+        if (clip[slot] == c || c < 0 || c >= set.clipCount())
+            return;
+
+        const AnimClip& ac = set.clip(c);
+        clip[slot] = c;
+        first[slot] = ac.firstFrame;
+        last[slot] = ac.firstFrame + ac.frameCount - 1;
+        loop[slot] = ac.loop ? 1 : 0;
+        frame[slot] = ac.firstFrame;
+        timer[slot] = 0.0f;
+    }
+
+    void Animator::restart()
+    {
+        for (u32 slot = 0; slot < clip.size(); ++slot)
+        {
+            int c = clip[slot];
+            if (c < 0 || c >= set.clipCount())
+                c = 0;
+
+            clip[slot] = -1;
+            first[slot] = last[slot] = frame[slot] = 0;
+            loop[slot] = 1;
+            timer[slot] = 0.0f;
+            play(slot, c);
+        }
+    }
+
+    bool Animator::finished(u32 slot) const
+    {
+        return !loop[slot] && frame[slot] == last[slot];
+    }
+
+    // -------------------------------------------------------------------
+    // update
+    // -------------------------------------------------------------------
+    void Animator::update(f32 dt)
+    {
+        if (set.frameCount() == 0)
+            return;
+
+        const f32* dur = set.durationTable();
+        const size_t n = frame.size();
+
+        u32* fr = frame.data();
+        f32* tm = timer.data();
+        const u32* lo = first.data();
+        const u32* hi = last.data();
+        const u8* lp = loop.data();
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            u32 f = fr[i];
+            f32 t = tm[i] + dt;
+            f32 d = dur[f];
+            while (t >= d)
+            {
+                // Loaders reject these; never spin on one that slips by.
+                if (!(d > 0.0f))
+                {
+                    t = 0.0f;
+                    break;
+                }
+                if (f < hi[i])
+                    ++f;
+                else if (lp[i])
+                    f = lo[i];
+                else
+                {
+                    t = 0.0f;   // hold the last frame
+                    break;
+                }
+                t -= d;
+                d = dur[f];
+            }
+            fr[i] = f;
+            tm[i] = t;
+        }
+    }
+}
@@ -0,0 +1,140 @@
+// ---------------------------------------------------------------------------
+// animation.hpp
+// ---------------------------------------------------------------------------
+//
+// Data-driven sprite animation.
+//
+// AnimationSet holds clips loaded from a .anim file (see anim_format.hpp):
+// per clip its frame rects, frame durations and whether it loops or holds
+// the last frame. The cooked form has every frame trimmed to its visible
+// pixels and packed into one atlas; the text source (loose files) points at
+// whole sprite sheets. upload() creates the textures and bakes one AE quad
+// per frame and facing, sized and offset to the frame's visible rect, so
+// drawing a frame is a lookup rather than a mesh rebuild and the
+// transparent border costs no fill.
+//
+// Animator plays clips for any number of entities. Its state is kept as
+// structure-of-arrays (current frame, timer, clip range), and update()
+// advances all of them in one loop over contiguous data. Gameplay code
+// decides which clip an entity should show and calls play() every frame;
+// play() only restarts when the clip actually changes, so it doubles as the
+// state machine's transition.
+//
+
+#ifndef ANIMATION_HPP
+#define ANIMATION_HPP
+
+#include "AEEngine.h"
+#include "anim_format.hpp"
+#include <string>
+#include <vector>
+
+namespace game
+{
+    struct AnimClip
+    {
+        std::string name;
+        u32 firstFrame;     // into the set's frame tables
+        u32 frameCount;
+        bool loop;          // false = hold the last frame
+        u32 texture;        // into the set's textures
+    };
+
+    // -------------------------------------------------------------------
+    // AnimationSet
+    // -------------------------------------------------------------------
+    class AnimationSet
+    {
+    public:
+        AnimationSet() = default;
+        ~AnimationSet();
+        AnimationSet(const AnimationSet&) = delete;
+        AnimationSet& operator=(const AnimationSet&) = delete;
+
+        // Replaces the clips with a cooked image or the text source. On
+        // error leaves the set empty and reports why in error.
+        bool load(const u8* data, size_t size, std::string& error);
+
+        // Main thread, after load(): the atlas (or sheets) and one quad per
+        // frame and facing.
+        void upload();
+        void clear();
+
+        // Main thread: takes over fresh's clips (loaded, not uploaded) and
+        // uploads them in place of ours, so pointers to the set stay valid.
+        // Animators playing it need restart() after. Leaves fresh empty.
+        void replace(AnimationSet& fresh);
+
+        bool empty() const { return clips.empty(); }
+        int find(const char* name) const;  // -1 if there is no such clip
+        int clipCount() const { return static_cast<int>(clips.size()); }
+        const AnimClip& clip(int index) const { return clips[index]; }
+
+        // Frame tables, indexed by set-wide frame number.
+        u32 frameCount() const { return static_cast<u32>(frames.size()); }
+        const AnimFrame& frame(u32 index) const { return frames[index]; }
+        f32 duration(u32 frame) const { return durations[frame]; }
+        const f32* durationTable() const { return durations.data(); }
+
+        // nullptr before upload(). flipped = facing left.
+        AEGfxTexture* texture(int clip) const;
+        AEGfxVertexList* mesh(u32 frame, bool flipped) const;
+
+        // Text source only: the sheet each texture is loaded from (hot
+        // reload watches them). Empty for the cooked atlas.
+        const std::vector<std::string>& sheetPaths() const { return sheets; }
+
+    private:
+        std::vector<AnimClip> clips;
+        std::vector<AnimFrame> frames;          // every clip's frames, back to back
+        std::vector<f32> durations;             // seconds, parallel to frames
+        std::vector<std::string> sheets;        // text source: one texture per sheet
+        std::vector<u8> atlas;                  // cooked: TextureBlobHeader + pixels until upload()
+        std::vector<AEGfxTexture*> textures;
+        std::vector<AEGfxVertexList*> meshes;   // 2 per frame: facing right, left
+
+        void freeGpu();
+    };
+
+    // -------------------------------------------------------------------
+    // Animator
+    // -------------------------------------------------------------------
+    class Animator
+    {
+    public:
+        explicit Animator(const AnimationSet& set);
+
+        // Returns the new entity's slot.
+        u32 add(int clip);
+        void clear();
+        size_t size() const { return frame.size(); }
+
+        // Starts clip from its first frame unless it is already playing.
+        void play(u32 slot, int clip);
+
+        // Advances every entity.
+        void update(f32 dt);
+
+        // After the set is replaced: restarts every entity's clip from its
+        // first frame, since the frame ranges may have moved. Entities whose
+        // clip no longer exists fall back to clip 0.
+        void restart();
+
+        int clipOf(u32 slot) const { return clip[slot]; }
+        u32 frameOf(u32 slot) const { return frame[slot]; }   // set-wide
+        bool finished(u32 slot) const;                          // hold clip on its last frame
+
+    private:
+        const AnimationSet& set;
+
+        // One entry per entity.
+        std::vector<s32> clip;
+        std::vector<u32> frame;
+        std::vector<u32> first;     // clip range, copied so update() never
+        std::vector<u32> last;      // has to look at the clip table
+        std::vector<u8> loop;
+        std::vector<f32> timer;
+    };
+}
+
+#endif // ANIMATION_HPP
@@ -0,0 +1,29 @@
+// ---------------------------------------------------------------------------
+// asset_id.cpp
+// ---------------------------------------------------------------------------
+
+#include "asset_id.hpp"
+
+#if FP_ASSET_NAMES
+#define ASSET_IDS_NAME_TABLE
+#include "asset_ids.hpp"
+#include <algorithm>
+#include <iterator>
+#endif
+
+namespace game
+{
+    const char* assetName(AssetId id)
+    {
+#if FP_ASSET_NAMES
+        const assets::NameEntry* begin = std::begin(assets::kNameTable);
+        const assets::NameEntry* end = std::end(assets::kNameTable);
+        const assets::NameEntry* it = std::lower_bound(begin, end, id.value(),
+            [](const assets::NameEntry& e, u64 value) { return e.id < value; });
+        return (it != end && it->id == id.value()) ? it->path : nullptr;
+#else
+        (void)id;
+        return nullptr;
+#endif
+    }
+}
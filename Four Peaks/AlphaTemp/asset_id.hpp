@@ -0,0 +1,90 @@
+// ---------------------------------------------------------------------------
+// asset_id.hpp
+// ---------------------------------------------------------------------------
+//
+// Compile-time hashed asset IDs.
+//
+// An AssetId is the 64-bit FNV-1a hash of the normalised asset path (same
+// rules as hashAssetPath in asset_pack.hpp, which is what the pack's table
+// of contents is sorted by). assetId() is constexpr, so
+//
+//     constexpr game::AssetId kIdle = game::assetId("Assets/player/idle.png");
+//
+// costs nothing at runtime and every lookup after that is an integer
+// compare. The IDs of all cooked assets are generated into asset_ids.hpp by
+// Tools/assetcook.
+//
+// assetName() maps an ID back to its path for logging and hot reload. The
+// table behind it is only compiled in when FP_ASSET_NAMES is non-zero
+// (defaults to debug builds); otherwise it returns nullptr.
+//
+
+#ifndef ASSET_ID_HPP
+#define ASSET_ID_HPP
+
+#include <AETypes.h>   // u64
+
+#ifndef FP_ASSET_NAMES
+#ifdef _DEBUG
+#define FP_ASSET_NAMES 1
+#else
+#define FP_ASSET_NAMES 0
+#endif
+#endif
+
+namespace game
+{
+    // -------------------------------------------------------------------
+    // hashing (constexpr, C++14)
+    // -------------------------------------------------------------------
+    constexpr char foldAssetChar(char c)
+    {
+        return c == '\\' ? '/' : (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    constexpr u64 hashAssetPathConst(const char* path)
+    {
+        // skip leading "./" segments
+        while (path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+            path += 2;
+
+        u64 h = 14695981039346656037ull;
+        for (; *path; ++path)
+        {
+            h ^= static_cast<u8>(foldAssetChar(*path));
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // -------------------------------------------------------------------
+    // AssetId
+    // -------------------------------------------------------------------
+    class AssetId
+    {
+    public:
+        constexpr AssetId() : id(0) {}
+        constexpr explicit AssetId(u64 hash) : id(hash) {}
+
+        constexpr u64 value() const { return id; }
+        constexpr bool valid() const { return id != 0; }
+
+        constexpr bool operator==(AssetId o) const { return id == o.id; }
+        constexpr bool operator!=(AssetId o) const { return id != o.id; }
+        constexpr bool operator<(AssetId o) const { return id < o.id; }
+
+    private:
+        u64 id;
+    };
+
+    constexpr AssetId assetId(const char* path)
+    {
+        return AssetId(hashAssetPathConst(path));
+    }
+
+    // Reverse lookup for debugging; nullptr if unknown or names are
+    // compiled out.
+    const char* assetName(AssetId id);
+}
+
+#endif // ASSET_ID_HPP
@@ -0,0 +1,107 @@
+// ---------------------------------------------------------------------------
+// asset_ids.hpp
+// ---------------------------------------------------------------------------
+//
+// Generated by Tools/assetcook from the asset manifest. Do not edit, rerun
+//   assetcook -g AlphaTemp/asset_ids.hpp
+// after adding, renaming or removing assets.
+//
+
+#ifndef ASSET_IDS_HPP
+#define ASSET_IDS_HPP
+
+#include "asset_id.hpp"
+
+namespace assets
+{
+    constexpr game::AssetId kPlanetTexture = game::assetId("Assets/PlanetTexture.png");
+    constexpr game::AssetId kSuperMellow = game::assetId("Assets/Super Mellow.ttf");
+    constexpr game::AssetId kAme = game::assetId("Assets/ame.png");
+    constexpr game::AssetId kBackgroundDesertDungeon = game::assetId("Assets/background_/desertDungeon_.png");
+    constexpr game::AssetId kBackgroundDungeon = game::assetId("Assets/background_/dungeon_.png");
+    constexpr game::AssetId kBackgroundSky = game::assetId("Assets/background_/sky_.png");
+    constexpr game::AssetId kBackgroundTerrain = game::assetId("Assets/background_/terrain_.png");
+    constexpr game::AssetId kBorder = game::assetId("Assets/border.png");
+    constexpr game::AssetId kBouken = game::assetId("Assets/bouken.mp3");
+    constexpr game::AssetId kBuggyFont = game::assetId("Assets/buggy-font.ttf");
+    constexpr game::AssetId kEffectsSeasons = game::assetId("Assets/effects/seasons.fx");
+    constexpr game::AssetId kForegroundForeground = game::assetId("Assets/foreground_/foreground_.png");
+    constexpr game::AssetId kIcon = game::assetId("Assets/icon.ico");
+    constexpr game::AssetId kLevelsSummerS1 = game::assetId("Assets/levels/summer_s1.lvl");
+    constexpr game::AssetId kLiberationMono = game::assetId("Assets/liberation-mono.ttf");
+    constexpr game::AssetId kMidgroundAutumn = game::assetId("Assets/midground_/autumn_.png");
+    constexpr game::AssetId kMidgroundBlackout = game::assetId("Assets/midground_/blackout_.png");
+    constexpr game::AssetId kMidgroundDesertDungeon = game::assetId("Assets/midground_/desertDungeon_.png");
+    constexpr game::AssetId kMidgroundDungeon = game::assetId("Assets/midground_/dungeon_.png");
+    constexpr game::AssetId kMidgroundSpring = game::assetId("Assets/midground_/spring_.png");
+    constexpr game::AssetId kMidgroundSummer = game::assetId("Assets/midground_/summer_.png");
+    constexpr game::AssetId kMidgroundWinter = game::assetId("Assets/midground_/winter_.png");
+    constexpr game::AssetId kObjectsBeehives = game::assetId("Assets/objects_/beehives_.png");
+    constexpr game::AssetId kObjectsCoin = game::assetId("Assets/objects_/coin_.png");
+    constexpr game::AssetId kObjectsEventBlock = game::assetId("Assets/objects_/eventBlock_.png");
+    constexpr game::AssetId kObjectsItems = game::assetId("Assets/objects_/items_.png");
+    constexpr game::AssetId kObjectsStaticObjects = game::assetId("Assets/objects_/staticObjects_.png");
+    constexpr game::AssetId kOre = game::assetId("Assets/ore.mp3");
+    constexpr game::AssetId kPlayerMaleHeroFallLoop = game::assetId("Assets/player/male_hero-fall_loop.png");
+    constexpr game::AssetId kPlayerMaleHeroIdle = game::assetId("Assets/player/male_hero-idle.png");
+    constexpr game::AssetId kPlayerMaleHeroJump = game::assetId("Assets/player/male_hero-jump.png");
+    constexpr game::AssetId kPlayerMaleHeroRun = game::assetId("Assets/player/male_hero-run.png");
+    constexpr game::AssetId kPlayerMaleHeroRunTurn = game::assetId("Assets/player/male_hero-run_turn.png");
+    constexpr game::AssetId kPlayerMaleHero = game::assetId("Assets/player/male_hero.anim");
+}
+
+#endif // ASSET_IDS_HPP
+
+// Reverse table for game::assetName(); only asset_id.cpp asks for it.
+#if defined(ASSET_IDS_NAME_TABLE) && !defined(ASSET_IDS_NAME_TABLE_DEFINED)
+#define ASSET_IDS_NAME_TABLE_DEFINED
+
+namespace assets
+{
+    struct NameEntry
+    {
+        u64 id;
+        const char* path;
+    };
+
+    // sorted by id
+    static const NameEntry kNameTable[] =
+    {
+        { 0x084a5c7d7a67c2dfull, "Assets/player/male_hero-idle.png" },
+        { 0x0af0a2a2f94ad9a9ull, "Assets/player/male_hero-fall_loop.png" },
+        { 0x1c0d845c24b41c0full, "Assets/objects_/staticObjects_.png" },
+        { 0x21eacb56c43ac60dull, "Assets/buggy-font.ttf" },
+        { 0x23d278c450a1797bull, "Assets/midground_/spring_.png" },
+        { 0x264cac41216782e2ull, "Assets/midground_/autumn_.png" },
+        { 0x2706d204ce27cf0cull, "Assets/liberation-mono.ttf" },
+        { 0x2799fe6c93477848ull, "Assets/objects_/coin_.png" },
+        { 0x3ff8dc60b63371d3ull, "Assets/levels/summer_s1.lvl" },
+        { 0x40e621e7e75daa38ull, "Assets/background_/sky_.png" },
+        { 0x43f82686f96d7873ull, "Assets/icon.ico" },
+        { 0x45a7e20ab174dfc3ull, "Assets/midground_/blackout_.png" },
+        { 0x4f6a2e7def4b588aull, "Assets/midground_/dungeon_.png" },
+        { 0x51d0443c36099791ull, "Assets/objects_/items_.png" },
+        { 0x560247ad8b125eabull, "Assets/ore.mp3" },
+        { 0x606df5d4a5a265ceull, "Assets/border.png" },
+        { 0x6ce0130386bd82ecull, "Assets/player/male_hero-run.png" },
+        { 0x7288ea6f1e1d991cull, "Assets/objects_/eventBlock_.png" },
+        { 0x8323197f08555145ull, "Assets/bouken.mp3" },
+        { 0x865e4877512815b1ull, "Assets/foreground_/foreground_.png" },
+        { 0x929b140192c73500ull, "Assets/player/male_hero.anim" },
+        { 0x96cf6cb33af59fb3ull, "Assets/midground_/summer_.png" },
+        { 0x9faf93ee4acb1304ull, "Assets/background_/terrain_.png" },
+        { 0xa0cc7843a50360afull, "Assets/midground_/winter_.png" },
+        { 0xa6fad30211cf94adull, "Assets/player/male_hero-jump.png" },
+        { 0xb4a061d31a0d7e9dull, "Assets/background_/dungeon_.png" },
+        { 0xbad218bff272827eull, "Assets/objects_/beehives_.png" },
+        { 0xbd7598c3df05f99cull, "Assets/effects/seasons.fx" },
+        { 0xc9f6f6e0b1bace53ull, "Assets/ame.png" },
+        { 0xd0649d235bf2c36full, "Assets/midground_/desertDungeon_.png" },
+        { 0xdd631d68f2bd4053ull, "Assets/PlanetTexture.png" },
+        { 0xe672519bb168c8f0ull, "Assets/background_/desertDungeon_.png" },
+        { 0xf0a32026efa2c274ull, "Assets/Super Mellow.ttf" },
+        { 0xf7c7f27eee65bbb4ull, "Assets/player/male_hero-run_turn.png" },
+    };
+}
+
+#endif // ASSET_IDS_NAME_TABLE
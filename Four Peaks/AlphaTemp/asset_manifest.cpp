@@ -0,0 +1,164 @@
+// ---------------------------------------------------------------------------
+// asset_manifest.cpp
+// ---------------------------------------------------------------------------
+
+#include "asset_manifest.hpp"
+#include "asset_pack.hpp"
+#include "vfs.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace game
+{
+    namespace
+    {
+        bool lessById(const AssetManifest::Entry& e, u64 id) { return e.id < id; }
+
+        // Splits "a\tb\tc" into at most n fields; the last one keeps any tabs.
+        int splitTabs(const std::string& line, std::string* fields, int n)
+        {
+            int count = 0;
+            size_t start = 0;
+            while (count < n - 1)
+            {
+                size_t tab = line.find('\t', start);
+                if (tab == std::string::npos)
+                    break;
+                fields[count++] = line.substr(start, tab - start);
+                start = tab + 1;
+            }
+            fields[count++] = line.substr(start);
+            return count;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // load
+    // -------------------------------------------------------------------
+    bool AssetManifest::load(const char* path)
+    {
+        entries.clear();
+
+        vfs::File file;
+        if (!vfs::open(path, file))
+            return false;
+
+        std::string error;
+        return parse(reinterpret_cast<const char*>(file.data()), file.size(), error);
+    }
+
+    // -------------------------------------------------------------------
+    // parse
+    // -------------------------------------------------------------------
+    bool AssetManifest::parse(const char* text, size_t size, std::string& error)
+    {
+        entries.clear();
+
+        bool sawVersion = false;
+        int lineNo = 0;
+        size_t pos = 0;
+        while (pos < size)
+        {
+            const char* nl = static_cast<const char*>(std::memchr(text + pos, '\n', size - pos));
+            size_t end = nl ? static_cast<size_t>(nl - text) : size;
+            std::string line(text + pos, end - pos);
+            pos = end + 1;
+            ++lineNo;
+
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            if (line.compare(0, 8, "version ") == 0)
+            {
+                if (std::atoi(line.c_str() + 8) != kManifestVersion)
+                {
+                    error = "unsupported manifest version";
+                    entries.clear();
+                    return false;
+                }
+                sawVersion = true;
+                continue;
+            }
+
+            std::string f[5];
+            if (!sawVersion || splitTabs(line, f, 5) != 5 || f[4].empty())
+            {
+                error = "bad manifest line " + std::to_string(lineNo);
+                entries.clear();
+                return false;
+            }
+
+            Entry e;
+            e.id = std::strtoull(f[0].c_str(), nullptr, 16);
+            e.type = static_cast<u16>(std::strtoul(f[1].c_str(), nullptr, 10));
+            e.size = static_cast<u32>(std::strtoul(f[2].c_str(), nullptr, 10));
+            e.contentHash = std::strtoull(f[3].c_str(), nullptr, 16);
+            e.path = f[4];
+
+            // The id is derived, so a mismatch means a hand-edited or
+            // corrupt file. Don't trust it.
+            if (e.id != hashAssetPath(e.path.c_str()))
+            {
+                error = "id mismatch on manifest line " + std::to_string(lineNo);
+                entries.clear();
+                return false;
+            }
+            entries.push_back(e);
+        }
+
+        std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.id < b.id; });
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // serialise
+    // -------------------------------------------------------------------
+    std::string AssetManifest::serialise() const
+    {
+        // Path order reads better in diffs than id order.
+        std::vector<const Entry*> byPath;
+        for (const Entry& e : entries)
+            byPath.push_back(&e);
+        std::sort(byPath.begin(), byPath.end(),
+            [](const Entry* a, const Entry* b) { return a->path < b->path; });
+
+        std::string out = "# Four Peaks asset manifest, generated by assetcook. Do not edit.\n";
+        out += "version " + std::to_string(kManifestVersion) + "\n";
+        char buf[96];
+        for (const Entry* e : byPath)
+        {
+            std::snprintf(buf, sizeof(buf), "%016llx\t%u\t%u\t%016llx\t",
+                static_cast<unsigned long long>(e->id), static_cast<unsigned>(e->type),
+                static_cast<unsigned>(e->size), static_cast<unsigned long long>(e->contentHash));
+            out += buf;
+            out += e->path;
+            out += '\n';
+        }
+        return out;
+    }
+
+    void AssetManifest::add(const Entry& entry)
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), entry.id, lessById);
+        if (it != entries.end() && it->id == entry.id)
+            *it = entry;
+        else
+            entries.insert(it, entry);
+    }
+
+    const AssetManifest::Entry* AssetManifest::find(u64 id) const
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), id, lessById);
+        return (it != entries.end() && it->id == id) ? &*it : nullptr;
+    }
+
+    const AssetManifest::Entry* AssetManifest::find(const char* path) const
+    {
+        return find(hashAssetPath(path));
+    }
+}
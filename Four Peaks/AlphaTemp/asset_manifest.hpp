@@ -0,0 +1,65 @@
+// ---------------------------------------------------------------------------
+// asset_manifest.hpp
+// ---------------------------------------------------------------------------
+//
+// List of every cooked asset, written by Tools/assetcook and stored in the
+// pack as "Assets/assets.manifest".
+//
+// The runtime uses it to answer "does this asset exist, what type is it,
+// how big is it" without touching the file system. It is a plain text file
+// so diffs between cooks are readable:
+//
+//   # comment
+//   version 1
+//   <id hex>\t<type>\t<size>\t<content hash hex>\t<path>
+//
+// id is hashAssetPath(path); size is the cooked (runtime) size in bytes.
+//
+
+#ifndef ASSET_MANIFEST_HPP
+#define ASSET_MANIFEST_HPP
+
+#include <AETypes.h>   // u16, u32, u64
+#include <string>
+#include <vector>
+
+namespace game
+{
+    static const char* const kManifestPath = "Assets/assets.manifest";
+    static const int kManifestVersion = 1;
+
+    class AssetManifest
+    {
+    public:
+        struct Entry
+        {
+            u64 id;
+            u16 type;           // PackEntryType
+            u32 size;
+            u64 contentHash;
+            std::string path;
+        };
+
+        // Reads the manifest through the VFS. An absent manifest is not an
+        // error for the game (loose assets only), so check empty().
+        bool load(const char* path = kManifestPath);
+        bool parse(const char* text, size_t size, std::string& error);
+        std::string serialise() const;
+
+        // Replaces an entry with the same id.
+        void add(const Entry& entry);
+        void clear() { entries.clear(); }
+
+        const Entry* find(u64 id) const;
+        const Entry* find(const char* path) const;
+
+        bool empty() const { return entries.empty(); }
+        size_t count() const { return entries.size(); }
+        const Entry& entry(size_t i) const { return entries[i]; }
+
+    private:
+        std::vector<Entry> entries;   // sorted by id
+    };
+}
+
+#endif // ASSET_MANIFEST_HPP
@@ -0,0 +1,237 @@
+// ---------------------------------------------------------------------------
+// asset_pack.cpp
+// ---------------------------------------------------------------------------
+
+#include "asset_pack.hpp"
+#include "lz4.hpp"
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace game
+{
+    std::string normaliseAssetPath(const char* path)
+    {
+        std::string out(path);
+        for (char& c : out)
+        {
+            if (c == '\\') c = '/';
+            else if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        }
+        while (out.compare(0, 2, "./") == 0)
+            out.erase(0, 2);
+        return out;
+    }
+
+    u64 hashAssetPath(const char* path)
+    {
+        return hashAssetPathConst(path);
+    }
+
+    u64 hashBytes(const u8* data, size_t size, u64 seed)
+    {
+        u64 h = seed;
+        for (size_t i = 0; i < size; ++i)
+        {
+            h ^= data[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // ===================================================================
+    // PackFile
+    // ===================================================================
+
+    bool PackFile::open(const char* path)
+    {
+        close();
+
+        if (!file.open(path))
+            return false;
+
+        const size_t total = file.size();
+        PackHeader hdr{};
+        if (total < sizeof(hdr))
+        {
+            close();
+            return false;
+        }
+        std::memcpy(&hdr, file.data(), sizeof(hdr));
+
+        const u64 tocSize = static_cast<u64>(hdr.entryCount) * sizeof(PackEntry);
+        if (std::memcmp(hdr.magic, kPackMagic, sizeof(kPackMagic)) != 0 ||
+            hdr.version != kPackVersion ||
+            hdr.tocOffset > total || tocSize > total - hdr.tocOffset ||
+            hdr.namesOffset > total || hdr.namesSize > total - hdr.namesOffset)
+        {
+            close();
+            return false;
+        }
+
+        entries.resize(hdr.entryCount);
+        std::memcpy(entries.data(), file.data() + hdr.tocOffset, static_cast<size_t>(tocSize));
+
+        for (const PackEntry& e : entries)
+        {
+            if (e.offset > total || e.size > total - e.offset ||
+                (hdr.namesSize > 0 && e.nameOffset >= hdr.namesSize))
+            {
+                close();
+                return false;
+            }
+        }
+
+        names = reinterpret_cast<const char*>(file.data() + hdr.namesOffset);
+        namesSize = static_cast<size_t>(hdr.namesSize);
+        return true;
+    }
+
+    void PackFile::close()
+    {
+        file.close();
+        entries.clear();
+        names = nullptr;
+        namesSize = 0;
+    }
+
+    const PackEntry* PackFile::find(u64 hash) const
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), hash,
+            [](const PackEntry& e, u64 h) { return e.hash < h; });
+        return (it != entries.end() && it->hash == hash) ? &*it : nullptr;
+    }
+
+    const char* PackFile::entryName(const PackEntry& e) const
+    {
+        return (names && e.nameOffset < namesSize) ? names + e.nameOffset : "";
+    }
+
+    bool PackFile::extract(const PackEntry& e, u8* dst) const
+    {
+        switch (static_cast<PackCompression>(e.compression))
+        {
+        case PackCompression::Raw:
+            if (e.size != e.rawSize)
+                return false;
+            std::memcpy(dst, entryData(e), e.size);
+            return true;
+
+        case PackCompression::Lz4:
+            return lz4::decompress(entryData(e), e.size, dst, e.rawSize);
+
+        default:
+            return false;
+        }
+    }
+
+    // ===================================================================
+    // PackWriter
+    // ===================================================================
+
+    PackWriter::PackWriter(u32 align)
+        : alignment(align < 1 ? 1 : align)
+    {
+    }
+
+    bool PackWriter::add(const std::string& path, const std::vector<u8>& bytes,
+        PackEntryType type, f32 minSavings)
+    {
+        Pending p;
+        p.name = normaliseAssetPath(path.c_str());
+        p.entry = PackEntry{};
+        p.entry.hash = hashAssetPath(p.name.c_str());
+        p.entry.rawSize = static_cast<u32>(bytes.size());
+        p.entry.type = static_cast<u16>(type);
+
+        for (const Pending& other : pending)
+        {
+            if (other.entry.hash == p.entry.hash)
+                return false;
+        }
+
+        std::vector<u8> packed;
+        lz4::compress(bytes.data(), bytes.size(), packed);
+
+        if (!bytes.empty() && packed.size() <= bytes.size() * (1.0f - minSavings))
+        {
+            p.entry.compression = static_cast<u16>(PackCompression::Lz4);
+            p.data.swap(packed);
+        }
+        else
+        {
+            p.entry.compression = static_cast<u16>(PackCompression::Raw);
+            p.data = bytes;
+        }
+        p.entry.size = static_cast<u32>(p.data.size());
+
+        pending.push_back(p);
+        return true;
+    }
+
+    bool PackWriter::write(const char* path, std::string& error) const
+    {
+        std::vector<Pending> sorted(pending);
+        std::sort(sorted.begin(), sorted.end(),
+            [](const Pending& a, const Pending& b) { return a.entry.hash < b.entry.hash; });
+
+        std::vector<u8> image(sizeof(PackHeader), 0);
+        std::vector<PackEntry> toc;
+        std::string nameTable;
+
+        for (const Pending& p : sorted)
+        {
+            // pad so the entry starts on an aligned offset
+            size_t aligned = (image.size() + alignment - 1) / alignment * alignment;
+            image.resize(aligned, 0);
+
+            PackEntry e = p.entry;
+            e.offset = image.size();
+            e.nameOffset = static_cast<u32>(nameTable.size());
+            nameTable += p.name;
+            nameTable.push_back('\0');
+
+            image.insert(image.end(), p.data.begin(), p.data.end());
+            toc.push_back(e);
+        }
+
+        image.resize((image.size() + 7) / 8 * 8, 0);
+
+        PackHeader hdr{};
+        std::memcpy(hdr.magic, kPackMagic, sizeof(kPackMagic));
+        hdr.version = kPackVersion;
+        hdr.entryCount = static_cast<u32>(toc.size());
+        hdr.alignment = alignment;
+        hdr.tocOffset = image.size();
+        hdr.namesOffset = hdr.tocOffset + toc.size() * sizeof(PackEntry);
+        hdr.namesSize = nameTable.size();
+
+        const u8* tocBytes = reinterpret_cast<const u8*>(toc.data());
+        image.insert(image.end(), tocBytes, tocBytes + toc.size() * sizeof(PackEntry));
+        image.insert(image.end(), nameTable.begin(), nameTable.end());
+        std::memcpy(image.data(), &hdr, sizeof(hdr));
+
+        // temp + replaceFile, like writeLevelFile
+        const std::string temp = std::string(path) + ".tmp";
+        {
+            std::ofstream out(temp.c_str(), std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+            if (!out)
+            {
+                error = std::string("cannot write ") + temp;
+                return false;
+            }
+        }
+
+        // The game may have the pack mapped.
+        if (!replaceFile(temp.c_str(), path))
+        {
+            std::remove(temp.c_str());
+            error = std::string("cannot replace ") + path;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,151 @@
+// ---------------------------------------------------------------------------
+// asset_pack.hpp
+// ---------------------------------------------------------------------------
+//
+// Packed asset archive (.pak).
+//
+// File layout (little-endian):
+//
+//   PackHeader
+//   entry data            (each entry starts on a PackHeader::alignment
+//                          boundary so uncompressed entries can be used
+//                          straight from the mapping)
+//   PackEntry[entryCount] (at tocOffset, sorted by hash)
+//   name table            (zero-terminated paths, for tools / debugging)
+//
+// Entries are looked up by the 64-bit FNV-1a hash of the normalised path
+// (lower case, forward slashes, no leading "./"), so a lookup is a binary
+// search over integers. Each entry is stored raw or LZ4 compressed.
+//
+
+#ifndef ASSET_PACK_HPP
+#define ASSET_PACK_HPP
+
+#include "asset_id.hpp"
+#include "mapped_file.hpp"
+#include <AETypes.h>   // u8, u16, u32, u64
+#include <string>
+#include <vector>
+
+namespace game
+{
+    static const char kPackMagic[4] = { 'F', 'P', 'A', 'K' };
+    static const u16  kPackVersion = 1;
+
+    enum class PackCompression : u16
+    {
+        Raw = 0,
+        Lz4 = 1
+    };
+
+    struct PackHeader
+    {
+        char magic[4];      // "FPAK"
+        u16  version;
+        u16  reserved;
+        u32  entryCount;
+        u32  alignment;     // entry data alignment in bytes (power of two)
+        u64  tocOffset;
+        u64  namesOffset;
+        u64  namesSize;
+    };
+
+    struct PackEntry
+    {
+        u64 hash;           // hashAssetPath(name)
+        u64 offset;         // data offset from the start of the file
+        u32 size;           // stored size
+        u32 rawSize;        // size after decompression
+        u32 nameOffset;     // into the name table
+        u16 compression;    // PackCompression
+        u16 type;           // asset type tag (see PackEntryType)
+    };
+
+    enum class PackEntryType : u16
+    {
+        Blob = 0,           // opaque bytes (png, ttf, mp3, lvl, ...)
+        Texture = 1         // cooked texture: TextureBlobHeader + RGBA8 pixels
+    };
+
+    // Payload of a PackEntryType::Texture entry.
+    struct TextureBlobHeader
+    {
+        char magic[4];      // "FTEX"
+        u32  width;
+        u32  height;
+        u32  format;        // 0 = RGBA8, rows top first
+    };
+
+    static const char kTextureMagic[4] = { 'F', 'T', 'E', 'X' };
+
+    static_assert(sizeof(TextureBlobHeader) == 16, "TextureBlobHeader layout changed");
+    static_assert(sizeof(PackHeader) == 40, "PackHeader layout changed");
+    static_assert(sizeof(PackEntry) == 32, "PackEntry layout changed");
+
+    // Normalises a path the way the pack stores it.
+    std::string normaliseAssetPath(const char* path);
+    // 64-bit FNV-1a of the normalised path (runtime form of assetId()).
+    u64 hashAssetPath(const char* path);
+    // 64-bit FNV-1a of raw bytes (content hashes for the cook cache).
+    u64 hashBytes(const u8* data, size_t size, u64 seed = 14695981039346656037ull);
+
+    // -------------------------------------------------------------------
+    // Reader
+    // -------------------------------------------------------------------
+    class PackFile
+    {
+    public:
+        bool open(const char* path);
+        void close();
+        bool isOpen() const { return file.isOpen(); }
+
+        // nullptr if not present.
+        const PackEntry* find(u64 hash) const;
+        const PackEntry* find(const char* path) const { return find(hashAssetPath(path)); }
+
+        // Stored bytes of an entry (compressed if compression != Raw).
+        const u8* entryData(const PackEntry& e) const { return file.data() + e.offset; }
+        const char* entryName(const PackEntry& e) const;
+
+        // Decompresses (or copies) an entry into dst (rawSize bytes).
+        bool extract(const PackEntry& e, u8* dst) const;
+
+        size_t entryCount() const { return entries.size(); }
+        const PackEntry& entry(size_t i) const { return entries[i]; }
+
+    private:
+        MappedFile file;
+        std::vector<PackEntry> entries; // copied out of the mapping, sorted
+        const char* names = nullptr;
+        size_t namesSize = 0;
+    };
+
+    // -------------------------------------------------------------------
+    // Writer (tools)
+    // -------------------------------------------------------------------
+    class PackWriter
+    {
+    public:
+        explicit PackWriter(u32 alignment = 16);
+
+        // Compresses with LZ4 when that saves at least minSavings of the size.
+        // Returns false on a hash collision with an existing entry.
+        bool add(const std::string& path, const std::vector<u8>& bytes,
+            PackEntryType type = PackEntryType::Blob, f32 minSavings = 0.1f);
+
+        bool write(const char* path, std::string& error) const;
+
+    private:
+        struct Pending
+        {
+            PackEntry entry;
+            std::string name;
+            std::vector<u8> data;
+        };
+
+        u32 alignment;
+        std::vector<Pending> pending;
+    };
+}
+
+#endif // ASSET_PACK_HPP
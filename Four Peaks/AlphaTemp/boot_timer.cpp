@@ -0,0 +1,89 @@
+// ---------------------------------------------------------------------------
+// boot_timer.cpp
+// ---------------------------------------------------------------------------
+
+#include "boot_timer.hpp"
+#include "AEEngine.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <vector>
+
+namespace boot
+{
+    namespace
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        const char* const kLogPath = "startup.log";
+
+        struct Phase
+        {
+            const char* name;
+            double end;     // seconds since begin()
+        };
+
+        Clock::time_point gStart = Clock::now();
+        std::vector<Phase> gPhases;
+        bool gReported = false;
+    }
+
+    void begin()
+    {
+        gStart = Clock::now();
+        gPhases.clear();
+        gReported = false;
+    }
+
+    double elapsed()
+    {
+        return std::chrono::duration<double>(Clock::now() - gStart).count();
+    }
+
+    void mark(const char* phase)
+    {
+        if (!gReported)
+            gPhases.push_back(Phase{ phase, elapsed() });
+    }
+
+    void report()
+    {
+        if (gReported)
+            return;
+        gReported = true;
+
+        std::ofstream log(kLogPath, std::ios::app);
+        if (log)
+        {
+            char stamp[32] = {};
+            const std::time_t now = std::time(nullptr);
+            std::tm local = {};
+#ifdef _WIN32
+            localtime_s(&local, &now);
+#else
+            localtime_r(&now, &local);
+#endif
+            std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+            log << "startup " << stamp << "\n";
+        }
+
+        double prev = 0.0;
+        for (const Phase& p : gPhases)
+        {
+            char line[128];
+            std::snprintf(line, sizeof(line), "  %-24s %8.1f ms  (at %8.1f ms)\n",
+                p.name, (p.end - prev) * 1000.0, p.end * 1000.0);
+            PRINT("%s", line);
+            if (log)
+                log << line;
+            prev = p.end;
+        }
+
+        char total[96];
+        std::snprintf(total, sizeof(total), "  %-24s %8.1f ms\n", "total", prev * 1000.0);
+        PRINT("%s", total);
+        if (log)
+            log << total;
+    }
+}
@@ -0,0 +1,30 @@
+// ---------------------------------------------------------------------------
+// boot_timer.hpp
+// ---------------------------------------------------------------------------
+//
+// Startup time breakdown.
+//
+// mark() closes the current phase under the given name; report() prints
+// every phase with its duration and the total, and appends the same lines to
+// startup.log next to the executable's working directory so runs can be
+// compared. Only the first report() does anything, so it can sit on a path
+// that runs more than once (e.g. entering the menu).
+//
+
+#ifndef BOOT_TIMER_HPP
+#define BOOT_TIMER_HPP
+
+namespace boot
+{
+    // Call first thing in wWinMain; phases are timed from here.
+    void begin();
+
+    // Main thread only.
+    void mark(const char* phase);
+    void report();
+
+    // Seconds since begin().
+    double elapsed();
+}
+
+#endif // BOOT_TIMER_HPP
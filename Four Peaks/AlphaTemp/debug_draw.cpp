@@ -0,0 +1,211 @@
+// ---------------------------------------------------------------------------
+// debug_draw.cpp
+// ---------------------------------------------------------------------------
+
+#include "debug_draw.hpp"
+#include "view.hpp"
+
+#if FP_DEBUG_DRAW
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace debugdraw
+{
+    namespace
+    {
+        struct Vertex
+        {
+            gfx::Vec2 p;
+            u32 color;
+        };
+
+        struct Label
+        {
+            gfx::Vec2 pos;
+            u32 color;
+            std::string text;
+        };
+
+        // Grid and colliders were always drawn before; keep that default.
+        u32 gEnabled = (1u << static_cast<u32>(Category::Grid)) | (1u << static_cast<u32>(Category::Colliders));
+
+        std::vector<Vertex> gTris;      // 3 per triangle
+        std::vector<Label> gLabels;
+
+        void tri(gfx::Vec2 a, gfx::Vec2 b, gfx::Vec2 c, u32 color)
+        {
+            gTris.push_back(Vertex{ a, color });
+            gTris.push_back(Vertex{ b, color });
+            gTris.push_back(Vertex{ c, color });
+        }
+
+        void quad(gfx::Vec2 a, gfx::Vec2 b, gfx::Vec2 c, gfx::Vec2 d, u32 color)
+        {
+            tri(a, b, c, color);
+            tri(a, c, d, color);
+        }
+
+        void segment(gfx::Vec2 a, gfx::Vec2 b, u32 color, f32 thickness)
+        {
+            const gfx::Vec2 dir = gfx::normalize(b - a);
+            if (dir.x == 0.0f && dir.y == 0.0f)
+                return;
+            const gfx::Vec2 n = gfx::Vec2{ -dir.y, dir.x } * (thickness * 0.5f);
+            quad(a - n, b - n, b + n, a + n, color);
+        }
+    }
+
+    void setEnabled(Category c, bool on)
+    {
+        const u32 bit = 1u << static_cast<u32>(c);
+        gEnabled = on ? (gEnabled | bit) : (gEnabled & ~bit);
+    }
+
+    bool enabled(Category c)
+    {
+        return (gEnabled & (1u << static_cast<u32>(c))) != 0;
+    }
+
+    void toggle(Category c)
+    {
+        setEnabled(c, !enabled(c));
+    }
+
+    // -------------------------------------------------------------------
+    // shapes
+    // -------------------------------------------------------------------
+    void line(gfx::Vec2 a, gfx::Vec2 b, u32 color, Category c, f32 thickness)
+    {
+        if (enabled(c))
+            segment(a, b, color, thickness);
+    }
+
+    void box(gfx::Vec2 center, gfx::Vec2 size, u32 color, Category c, bool filled)
+    {
+        if (!enabled(c))
+            return;
+
+        const gfx::Vec2 h = size * 0.5f;
+        const gfx::Vec2 bl{ center.x - h.x, center.y - h.y };
+        const gfx::Vec2 br{ center.x + h.x, center.y - h.y };
+        const gfx::Vec2 tr{ center.x + h.x, center.y + h.y };
+        const gfx::Vec2 tl{ center.x - h.x, center.y + h.y };
+        if (filled)
+        {
+            quad(bl, br, tr, tl, color);
+            return;
+        }
+
+        // Edges inset by half the thickness so the corners don't overlap.
+        const f32 t = kDefaultThickness * 0.5f;
+        segment(gfx::Vec2{ bl.x, bl.y + t }, gfx::Vec2{ br.x, br.y + t }, color, kDefaultThickness);
+        segment(gfx::Vec2{ tl.x, tl.y - t }, gfx::Vec2{ tr.x, tr.y - t }, color, kDefaultThickness);
+        segment(gfx::Vec2{ bl.x + t, bl.y + t * 2 }, gfx::Vec2{ tl.x + t, tl.y - t * 2 }, color, kDefaultThickness);
+        segment(gfx::Vec2{ br.x - t, br.y + t * 2 }, gfx::Vec2{ tr.x - t, tr.y - t * 2 }, color, kDefaultThickness);
+    }
+
+    void circle(gfx::Vec2 center, f32 radius, u32 color, Category c, int segments)
+    {
+        if (!enabled(c) || segments < 3)
+            return;
+
+        const f32 step = 6.28318530718f / segments;
+        gfx::Vec2 prev{ center.x + radius, center.y };
+        for (int i = 1; i <= segments; ++i)
+        {
+            const gfx::Vec2 next{ center.x + std::cos(i * step) * radius, center.y + std::sin(i * step) * radius };
+            segment(prev, next, color, kDefaultThickness);
+            prev = next;
+        }
+    }
+
+    void arrow(gfx::Vec2 from, gfx::Vec2 to, u32 color, Category c)
+    {
+        if (!enabled(c))
+            return;
+
+        const f32 len = gfx::length(to - from);
+        if (len <= 0.0f)
+            return;
+
+        // Head a quarter of the length, capped.
+        const gfx::Vec2 dir = (to - from) / len;
+        const f32 head = len * 0.25f < 12.0f ? len * 0.25f : 12.0f;
+        const gfx::Vec2 base = to - dir * head;
+        const gfx::Vec2 side = gfx::Vec2{ -dir.y, dir.x } * (head * 0.5f);
+
+        segment(from, base, color, kDefaultThickness);
+        tri(base - side, to, base + side, color);
+    }
+
+    void text(gfx::Vec2 pos, u32 color, const char* format, ...)
+    {
+        if (!enabled(Category::Labels))
+            return;
+
+        char buf[128];
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        gLabels.push_back(Label{ pos, color, buf });
+    }
+
+    // -------------------------------------------------------------------
+    // flush
+    // -------------------------------------------------------------------
+    void flush(s8 font)
+    {
+        if (gTris.size() >= 3)
+        {
+            AEGfxMeshStart();
+            for (size_t i = 0; i + 2 < gTris.size(); i += 3)
+            {
+                const Vertex& a = gTris[i];
+                const Vertex& b = gTris[i + 1];
+                const Vertex& c = gTris[i + 2];
+                AEGfxTriAdd(a.p.x, a.p.y, a.color, 0.0f, 0.0f,
+                    b.p.x, b.p.y, b.color, 0.0f, 0.0f,
+                    c.p.x, c.p.y, c.color, 0.0f, 0.0f);
+            }
+            AEGfxVertexList* mesh = AEGfxMeshEnd();
+
+            if (mesh)
+            {
+                AEGfxSetRenderMode(AE_GFX_RM_COLOR);
+                AEGfxSetBlendMode(AE_GFX_BM_BLEND);
+                AEGfxSetTransparency(1.0f);
+
+                // Vertex colors as they are; vertices are in world space.
+                AEGfxSetBlendColor(0.0f, 0.0f, 0.0f, 0.0f);
+                AEGfxSetColorToMultiply(1.0f, 1.0f, 1.0f, 1.0f);
+                AEGfxSetColorToAdd(0.0f, 0.0f, 0.0f, 0.0f);
+
+                AEMtx33 m = gfx::toAE(view::metrics().worldToScreen);
+                AEGfxSetTransform(m.m);
+                AEGfxMeshDraw(mesh, AE_GFX_MDM_TRIANGLES);
+                AEGfxMeshFree(mesh);
+            }
+        }
+        gTris.clear();
+
+        if (font >= 0 && !gLabels.empty())
+        {
+            // AEGfxPrint wants normalised window coordinates.
+            for (const Label& l : gLabels)
+            {
+                const gfx::Vec2 at = view::toNormalized(l.pos);
+                AEGfxPrint(font, l.text.c_str(), at.x, at.y, 0.5f,
+                    ((l.color >> 16) & 0xFF) / 255.0f, ((l.color >> 8) & 0xFF) / 255.0f,
+                    (l.color & 0xFF) / 255.0f, ((l.color >> 24) & 0xFF) / 255.0f);
+            }
+        }
+        gLabels.clear();
+    }
+}
+
+#endif // FP_DEBUG_DRAW
@@ -0,0 +1,74 @@
+// ---------------------------------------------------------------------------
+// debug_draw.hpp
+// ---------------------------------------------------------------------------
+//
+// Immediate-mode debug shapes: lines, boxes, circles, arrows and text
+// labels, in world coordinates.
+//
+// Calls only append to a per-frame buffer; flush() (main, after the frame's
+// draw list) turns everything into one triangle mesh and one draw call,
+// then prints the labels. A category that is switched off costs a flag
+// test per call.
+//
+// Compiled in with FP_DEBUG_DRAW (on in Debug builds). Without it every
+// function is an empty inline, so call sites need no #if.
+//
+
+#ifndef DEBUG_DRAW_HPP
+#define DEBUG_DRAW_HPP
+
+#include "AEEngine.h"
+#include "math2d.hpp"
+
+#ifndef FP_DEBUG_DRAW
+#ifdef _DEBUG
+#define FP_DEBUG_DRAW 1
+#else
+#define FP_DEBUG_DRAW 0
+#endif
+#endif
+
+namespace debugdraw
+{
+    enum class Category : u8
+    {
+        Grid,
+        Colliders,
+        Probes,         // ground checks, velocities, ...
+        Labels,         // text()
+        Count
+    };
+
+    static const f32 kDefaultThickness = 2.0f;    // world units
+
+#if FP_DEBUG_DRAW
+    void setEnabled(Category c, bool on);
+    bool enabled(Category c);
+    void toggle(Category c);
+
+    void line(gfx::Vec2 a, gfx::Vec2 b, u32 color, Category c, f32 thickness = kDefaultThickness);
+    void box(gfx::Vec2 center, gfx::Vec2 size, u32 color, Category c, bool filled = false);
+    void circle(gfx::Vec2 center, f32 radius, u32 color, Category c, int segments = 16);
+    void arrow(gfx::Vec2 from, gfx::Vec2 to, u32 color, Category c);
+    // printf style; always in the Labels category
+    void text(gfx::Vec2 pos, u32 color, const char* format, ...);
+
+    // Main thread, once per frame after gfx::flushQueue(). font < 0 skips
+    // the labels.
+    void flush(s8 font);
+#else
+    inline void setEnabled(Category, bool) {}
+    inline bool enabled(Category) { return false; }
+    inline void toggle(Category) {}
+
+    inline void line(gfx::Vec2, gfx::Vec2, u32, Category, f32 = kDefaultThickness) {}
+    inline void box(gfx::Vec2, gfx::Vec2, u32, Category, bool = false) {}
+    inline void circle(gfx::Vec2, f32, u32, Category, int = 16) {}
+    inline void arrow(gfx::Vec2, gfx::Vec2, u32, Category) {}
+    inline void text(gfx::Vec2, u32, const char*, ...) {}
+
+    inline void flush(s8) {}
+#endif
+}
+
+#endif // DEBUG_DRAW_HPP
@@ -0,0 +1,164 @@
+// ---------------------------------------------------------------------------
+// deferred.cpp
+// ---------------------------------------------------------------------------
+
+#include "deferred.hpp"
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace deferred
+{
+    namespace
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        struct Entry
+        {
+            const char* name;
+            Priority priority;
+            bool hasDeadline;
+            Clock::time_point deadline;
+            Task task;
+            const void* owner;
+            u64 order;          // submission order, breaks ties
+            f64 estimate;       // last slice, seconds
+        };
+
+        std::mutex gLock;
+        std::vector<Entry> gTasks;
+        u64 gNextOrder = 0;
+
+        f64 seconds(Clock::duration d)
+        {
+            return std::chrono::duration<f64>(d).count();
+        }
+
+        bool overdue(const Entry& e, Clock::time_point now)
+        {
+            return e.hasDeadline && e.deadline <= now;
+        }
+
+        // True if a should run before b.
+        bool before(const Entry& a, const Entry& b)
+        {
+            if (a.priority != b.priority)
+                return a.priority > b.priority;
+            if (a.hasDeadline != b.hasDeadline)
+                return a.hasDeadline;
+            if (a.hasDeadline && a.deadline != b.deadline)
+                return a.deadline < b.deadline;
+            return a.order < b.order;
+        }
+
+        // Index of the next task to run, or -1. forced: picks an overdue
+        // task regardless of fit. Caller holds gLock.
+        int pick(Clock::time_point now, f64 remaining, bool forced)
+        {
+            int best = -1;
+            for (size_t i = 0; i < gTasks.size(); ++i)
+            {
+                const Entry& e = gTasks[i];
+                if (forced ? !overdue(e, now) : e.estimate > remaining)
+                    continue;
+                if (best < 0 || before(e, gTasks[best]))
+                    best = static_cast<int>(i);
+            }
+            return best;
+        }
+
+        // Runs one slice of the task at index and puts it back if it isn't
+        // done. Takes and releases gLock.
+        void runSlice(std::unique_lock<std::mutex>& guard, int index)
+        {
+            Entry entry = std::move(gTasks[index]);
+            gTasks.erase(gTasks.begin() + index);
+            guard.unlock();
+
+            const Clock::time_point start = Clock::now();
+            const bool done = entry.task();
+            entry.estimate = seconds(Clock::now() - start);
+
+            guard.lock();
+            if (!done)
+                gTasks.push_back(std::move(entry));
+        }
+    }
+
+    void submit(const char* name, Priority priority, f64 deadline, Task task, const void* owner)
+    {
+        Entry e;
+        e.name = name;
+        e.priority = priority;
+        e.hasDeadline = deadline > 0.0;
+        e.deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<f64>(deadline > 0.0 ? deadline : 0.0));
+        e.task = task;
+        e.owner = owner;
+        e.estimate = 0.0;
+
+        std::lock_guard<std::mutex> guard(gLock);
+        e.order = gNextOrder++;
+        gTasks.push_back(std::move(e));
+    }
+
+    void cancel(const void* owner)
+    {
+        std::lock_guard<std::mutex> guard(gLock);
+        for (size_t i = 0; i < gTasks.size();)
+        {
+            if (gTasks[i].owner == owner)
+                gTasks.erase(gTasks.begin() + i);
+            else
+                ++i;
+        }
+    }
+
+    size_t pendingCount()
+    {
+        std::lock_guard<std::mutex> guard(gLock);
+        return gTasks.size();
+    }
+
+    // -------------------------------------------------------------------
+    // run
+    // -------------------------------------------------------------------
+    void run(f64 slack)
+    {
+        const Clock::time_point start = Clock::now();
+        std::unique_lock<std::mutex> guard(gLock);
+
+        // Past their deadline: one slice, budget or not.
+        const int forced = pick(start, 0.0, true);
+        if (forced >= 0)
+            runSlice(guard, forced);
+
+        // Then whatever fits in what's left.
+        for (;;)
+        {
+            const f64 remaining = slack - kPresentReserve - seconds(Clock::now() - start);
+            if (remaining <= 0.0)
+                break;
+
+            const int next = pick(Clock::now(), remaining, false);
+            if (next < 0)
+                break;
+            runSlice(guard, next);
+        }
+    }
+
+    void flush()
+    {
+        std::unique_lock<std::mutex> guard(gLock);
+        while (!gTasks.empty())
+        {
+            int best = 0;
+            for (size_t i = 1; i < gTasks.size(); ++i)
+            {
+                if (before(gTasks[i], gTasks[best]))
+                    best = static_cast<int>(i);
+            }
+            runSlice(guard, best);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+// ---------------------------------------------------------------------------
+// deferred.hpp
+// ---------------------------------------------------------------------------
+//
+// Background chores run in the frame's leftover time.
+//
+// Systems submit tasks that don't have to happen this frame (hot reload
+// swaps, resource eviction, log writes, ...). run() is called after draw and
+// before AESysFrameEnd() with the time left in the frame budget, and runs
+// tasks, highest priority first and then by deadline, while they fit. A
+// late frame gets nothing.
+//
+// A task returns true when it's done, or false to be called again later, so
+// long jobs can do one slice per call and spread over frames. Each task's
+// last slice time is remembered and a slice only starts if it fits.
+//
+// Once a task's deadline has passed it runs even without slack, but only
+// one forced slice per frame, so a backlog can't turn into a hitch.
+//
+// submit() and cancel() are thread-safe; tasks always run on the main thread.
+//
+
+#ifndef DEFERRED_HPP
+#define DEFERRED_HPP
+
+#include "AEEngine.h"
+#include <functional>
+
+namespace deferred
+{
+    enum class Priority : u8
+    {
+        Low,
+        Normal,
+        High
+    };
+
+    // True when finished.
+    typedef std::function<bool()> Task;
+
+    // Kept back for AESysFrameEnd() itself.
+    static const f64 kPresentReserve = 0.001;
+
+    // deadline: seconds from now, 0 = none. Tasks submitted with an owner
+    // can be dropped together with cancel(owner).
+    void submit(const char* name, Priority priority, f64 deadline, Task task,
+        const void* owner = nullptr);
+    void cancel(const void* owner);
+
+    // Main thread, between draw and AESysFrameEnd(). slack = seconds left in
+    // the frame budget.
+    void run(f64 slack);
+
+    // Runs everything to completion, ignoring budgets (shutdown).
+    void flush();
+
+    size_t pendingCount();
+}
+
+#endif // DEFERRED_HPP
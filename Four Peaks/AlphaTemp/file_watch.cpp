@@ -0,0 +1,195 @@
+// ---------------------------------------------------------------------------
+// file_watch.cpp
+// ---------------------------------------------------------------------------
+
+#include "file_watch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace game
+{
+    namespace
+    {
+        const int kSettleMs = 50; // wait for writers to finish
+
+        std::string parentDir(const std::string& path)
+        {
+            size_t slash = path.find_last_of("/\\");
+            return slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+        }
+
+        std::string normalise(std::string path)
+        {
+            std::replace(path.begin(), path.end(), '\\', '/');
+            if (path.compare(0, 2, "./") == 0)
+                path.erase(0, 2);
+            return path;
+        }
+    }
+
+    FileWatcher::FileWatcher()
+        : inotifyFd(-1)
+    {
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+#ifdef __linux__
+        if (inotifyFd >= 0)
+            close(inotifyFd);
+#endif
+    }
+
+    FileWatcher::Stamp FileWatcher::stampOf(const std::string& path)
+    {
+        Stamp s{ -1, -1 };
+#ifdef _WIN32
+        struct _stat64 st {};
+        if (_stat64(path.c_str(), &st) == 0)
+#else
+        struct stat st {};
+        if (stat(path.c_str(), &st) == 0)
+#endif
+        {
+            s.mtime = static_cast<int64_t>(st.st_mtime);
+            s.size = static_cast<int64_t>(st.st_size);
+        }
+        return s;
+    }
+
+    // -------------------------------------------------------------------
+    // add / remove
+    // -------------------------------------------------------------------
+    void FileWatcher::add(const std::string& rawPath)
+    {
+        const std::string path = normalise(rawPath);
+        std::lock_guard<std::mutex> guard(lock);
+
+        files[path] = stampOf(path);
+
+#ifdef __linux__
+        if (inotifyFd >= 0)
+        {
+            const std::string dir = parentDir(path);
+            for (const auto& w : dirWatches)
+            {
+                if (w.second == dir)
+                    return;
+            }
+
+            int wd = inotify_add_watch(inotifyFd, dir.c_str(),
+                IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (wd >= 0)
+                dirWatches[wd] = dir;
+        }
+#endif
+    }
+
+    void FileWatcher::remove(const std::string& rawPath)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        files.erase(normalise(rawPath));
+        // Directory watches are kept; events for unknown files are ignored.
+    }
+
+    // -------------------------------------------------------------------
+    // poll
+    // -------------------------------------------------------------------
+    void FileWatcher::poll(std::vector<std::string>& changed, int timeoutMs)
+    {
+        changed.clear();
+
+        if (inotifyFd >= 0)
+        {
+            readInotify(changed, timeoutMs);
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            pollStamps(changed);
+        }
+
+        if (changed.empty())
+            return;
+
+        // Let the writer finish, then fold in anything that arrived meanwhile.
+        std::this_thread::sleep_for(std::chrono::milliseconds(kSettleMs));
+        std::vector<std::string> more;
+        if (inotifyFd >= 0)
+            readInotify(more, 0);
+        changed.insert(changed.end(), more.begin(), more.end());
+
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+        // Refresh stamps so the polling path doesn't report them again.
+        std::lock_guard<std::mutex> guard(lock);
+        for (const std::string& path : changed)
+        {
+            auto it = files.find(path);
+            if (it != files.end())
+                it->second = stampOf(path);
+        }
+    }
+
+    void FileWatcher::pollStamps(std::vector<std::string>& changed)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto& entry : files)
+        {
+            Stamp now = stampOf(entry.first);
+            if (now.mtime != entry.second.mtime || now.size != entry.second.size)
+            {
+                entry.second = now;
+                if (now.size >= 0) // ignore deletions
+                    changed.push_back(entry.first);
+            }
+        }
+    }
+
+    void FileWatcher::readInotify(std::vector<std::string>& changed, int timeoutMs)
+    {
+#ifdef __linux__
+        pollfd pfd{ inotifyFd, POLLIN, 0 };
+        if (::poll(&pfd, 1, timeoutMs) <= 0)
+            return;
+
+        alignas(inotify_event) char buffer[4096];
+        for (;;)
+        {
+            ssize_t len = read(inotifyFd, buffer, sizeof(buffer));
+            if (len <= 0)
+                break;
+
+            std::lock_guard<std::mutex> guard(lock);
+            for (char* p = buffer; p < buffer + len;)
+            {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                p += sizeof(inotify_event) + ev->len;
+
+                auto dir = dirWatches.find(ev->wd);
+                if (dir == dirWatches.end() || ev->len == 0)
+                    continue;
+
+                std::string path = normalise(dir->second + "/" + ev->name);
+                if (files.count(path))
+                    changed.push_back(path);
+            }
+        }
+#else
+        (void)changed;
+        (void)timeoutMs;
+#endif
+    }
+}
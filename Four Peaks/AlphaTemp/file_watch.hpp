@@ -0,0 +1,61 @@
+// ---------------------------------------------------------------------------
+// file_watch.hpp
+// ---------------------------------------------------------------------------
+//
+// Watches a set of files for modification.
+//
+// Linux uses inotify on each file's parent directory (so editors that save
+// by writing a temp file and renaming it over the original are caught).
+// Everywhere else, or if inotify is unavailable, it falls back to polling
+// each file's modification time and size.
+//
+// poll() blocks for at most timeoutMs and reports each changed path once,
+// after a short settle delay so half-written files are not picked up.
+//
+
+#ifndef FILE_WATCH_HPP
+#define FILE_WATCH_HPP
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    class FileWatcher
+    {
+    public:
+        FileWatcher();
+        ~FileWatcher();
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        void add(const std::string& path);
+        void remove(const std::string& path);
+
+        // Fills `changed` (cleared first) with modified paths.
+        void poll(std::vector<std::string>& changed, int timeoutMs);
+
+        bool usingInotify() const { return inotifyFd >= 0; }
+
+    private:
+        struct Stamp
+        {
+            int64_t mtime;
+            int64_t size;
+        };
+
+        std::mutex lock;
+        std::map<std::string, Stamp> files;     // watched path -> last stamp
+        std::map<int, std::string> dirWatches;  // inotify wd -> directory
+        int inotifyFd;
+
+        static Stamp stampOf(const std::string& path);
+        void pollStamps(std::vector<std::string>& changed);
+        void readInotify(std::vector<std::string>& changed, int timeoutMs);
+    };
+}
+
+#endif // FILE_WATCH_HPP
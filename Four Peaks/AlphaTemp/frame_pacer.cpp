@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------------
+// frame_pacer.cpp
+// ---------------------------------------------------------------------------
+
+#include "frame_pacer.hpp"
+#include <windows.h>
+#include <mmsystem.h>
+#include <chrono>
+#include <cmath>
+
+namespace pacing
+{
+    namespace
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        // Wake for anything that can change a static screen; mouse moves
+        // are left in the queue.
+        const DWORD kWakeMask = QS_KEY | QS_MOUSEBUTTON | QS_PAINT | QS_POSTMESSAGE | QS_SENDMESSAGE;
+
+        // Sleep statistics only follow this many recent samples, so the
+        // estimate adapts if the system timer changes under us.
+        const f64 kMaxSamples = 64.0;
+        const int kCalibrationSleeps = 8;
+
+        f64 gInterval = 1.0 / 60.0;
+        Clock::time_point gLast = Clock::now();
+        bool gTimerRaised = false;
+
+        // Welford running mean / variance of observed Sleep(1) durations.
+        f64 gSleepMean = 0.002;
+        f64 gSleepM2 = 0.0;
+        f64 gSleepCount = 1.0;
+        f64 gSlack = 0.002;
+
+        f64 seconds(Clock::duration d)
+        {
+            return std::chrono::duration<f64>(d).count();
+        }
+
+        void sleepOnce()
+        {
+            const Clock::time_point start = Clock::now();
+            Sleep(1);
+            const f64 observed = seconds(Clock::now() - start);
+
+            if (gSleepCount < kMaxSamples)
+                gSleepCount += 1.0;
+            const f64 delta = observed - gSleepMean;
+            gSleepMean += delta / gSleepCount;
+            gSleepM2 += delta * (observed - gSleepMean);
+            if (gSleepCount >= kMaxSamples)
+                gSleepM2 *= (kMaxSamples - 1.0) / kMaxSamples;
+
+            gSlack = gSleepMean + std::sqrt(gSleepM2 / gSleepCount);
+        }
+
+        // Sleeps while it's safe to, then spins to the deadline.
+        void waitUntil(Clock::time_point deadline, bool spin)
+        {
+            while (seconds(deadline - Clock::now()) > gSlack)
+                sleepOnce();
+
+            if (!spin)
+                return;
+            while (Clock::now() < deadline)
+                YieldProcessor();
+        }
+
+        // Blocks until a wake-worthy message is queued or the time is up.
+        void waitForMessage(Clock::time_point deadline)
+        {
+            const f64 remaining = seconds(deadline - Clock::now());
+            if (remaining <= 0.0)
+                return;
+
+            const DWORD ms = static_cast<DWORD>(remaining * 1000.0) + 1;
+            MsgWaitForMultipleObjectsEx(0, nullptr, ms, kWakeMask, MWMO_INPUTAVAILABLE);
+        }
+    }
+
+    void init(u32 targetHz)
+    {
+        gInterval = 1.0 / (targetHz ? targetHz : 60);
+        gTimerRaised = timeBeginPeriod(1) == TIMERR_NOERROR;
+
+        gSleepMean = 0.0;
+        gSleepM2 = 0.0;
+        gSleepCount = 0.0;
+        for (int i = 0; i < kCalibrationSleeps; ++i)
+            sleepOnce();
+
+        gLast = Clock::now();
+    }
+
+    void shutdown()
+    {
+        if (gTimerRaised)
+            timeEndPeriod(1);
+        gTimerRaised = false;
+    }
+
+    f64 sleepSlack()
+    {
+        return gSlack;
+    }
+
+    // -------------------------------------------------------------------
+    // waitForFrame
+    // -------------------------------------------------------------------
+    void waitForFrame(bool animated)
+    {
+        const bool focused = AESysIsFocus() != 0;
+        const f64 interval = focused ? gInterval : 1.0 / kBackgroundHz;
+        const Clock::time_point due = gLast + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<f64>(interval));
+
+        if (!animated)
+        {
+            waitForMessage(gLast + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<f64>(kIdleHeartbeat)));
+        }
+
+        // Still capped at the frame rate (key repeat, message bursts).
+        waitUntil(due, focused);
+
+        // Keep a steady cadence, but don't try to catch up after a stall or
+        // an idle wait.
+        const Clock::time_point now = Clock::now();
+        gLast = seconds(now - due) > interval ? now : (due > now ? now : due);
+    }
+}
@@ -0,0 +1,45 @@
+// ---------------------------------------------------------------------------
+// frame_pacer.hpp
+// ---------------------------------------------------------------------------
+//
+// Frame rate limiting that doesn't burn a core.
+//
+// waitForFrame() runs before AESysFrameStart() and blocks until the next
+// frame is due. Waits sleep while the remaining time is longer than Sleep's
+// measured overshoot (mean + one deviation of recent Sleep(1) calls, with
+// the timer resolution raised to 1 ms) and spin only the last stretch, so
+// in-game pacing stays tight at a fraction of the CPU.
+//
+// States that only change in response to input (menus) are not animated:
+// their frames run when a key, mouse button or window message arrives, or
+// on a slow heartbeat so hot reload and the like still land. Without focus
+// the loop drops to kBackgroundHz and never spins.
+//
+// AE's own frame rate controller busy-waits, so AESysInit gets
+// kEngineFrameCap to keep it out of the way; dt still comes from
+// AEFrameRateControllerGetFrameTime().
+//
+
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include "AEEngine.h"
+
+namespace pacing
+{
+    static const u32 kEngineFrameCap = 1000;
+    static const u32 kBackgroundHz = 10;
+    static const f64 kIdleHeartbeat = 0.5;     // seconds between frames on a static screen
+
+    // After AESysInit. Raises the timer resolution and calibrates Sleep.
+    void init(u32 targetHz);
+    void shutdown();
+
+    // Main thread, before AESysFrameStart().
+    void waitForFrame(bool animated);
+
+    // Current Sleep overshoot estimate, in seconds.
+    f64 sleepSlack();
+}
+
+#endif // FRAME_PACER_HPP
@@ -1,12 +1,17 @@
 #ifndef GAME_STATE_HPP
 #define GAME_STATE_HPP
 
+#include "animation.hpp"
 #include "player.hpp"
 
 struct GameState
 {
     Player player;
-    
+
+    // Hero clips and playback for everything drawn with them; the animator
+    // advances all of them in one pass per frame.
+    game::AnimationSet heroAnims;
+    game::Animator heroAnimator{ heroAnims };
 };
 
 // One global world object (declared here)
@@ -5,15 +5,13 @@
 #include "AEEngine.h"   
 #include <cmath>
 #include <cstdint>
+#include <vector>
 
 
 
 #ifndef AE_PI
 #define AE_PI 3.14159265358979323846f
 #endif
-    // player sprite mesh
-    static AEGfxVertexList* spriteMesh = nullptr;
-
     static int circleSegments = 40;
 
 namespace gfx
@@ -22,42 +20,19 @@ namespace gfx
     {
         AEGfxVertexList* rectMesh{};
         AEGfxVertexList* triMesh{};
-        AEGfxVertexList* circleMesh{};
-        int circleSegmentsBuilt{};
-    }
 
-    namespace
-    {
-        void setTintColor(u32 color)
+        // One per segment count used; queued draws may still point at them
+        // until the flush, so they are kept until shutdown.
+        struct CircleMesh
         {
-            u8 a = static_cast<u8>((color >> 24) & 0xFF);  // Alpha
-            u8 r = static_cast<u8>((color >> 16) & 0xFF);  // Red
-            u8 g = static_cast<u8>((color >> 8) & 0xFF);   // Green
-            u8 b = static_cast<u8>((color >> 0) & 0xFF);   // Blue
-            AEGfxSetBlendColor(r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f);
-        }
+            int segments;
+            AEGfxVertexList* mesh;
+        };
+        std::vector<CircleMesh> circleMeshes;
     }
 
 
 
-    AEMtx33 makeTransform(Vec2 position, f32 rotationRad, Vec2 scale)
-    {
-        AEMtx33 scaleMtx{};
-        AEMtx33 rotMtx{};
-        AEMtx33 transMtx{};
-        AEMtx33 result{};
-
-        AEMtx33Scale(&scaleMtx, scale.x, scale.y);
-        AEMtx33Rot(&rotMtx, rotationRad);
-        AEMtx33Trans(&transMtx, position.x, position.y);
-
-        // result = trans * rot * scale
-        AEMtx33Concat(&result, &rotMtx, &scaleMtx);
-        AEMtx33Concat(&result, &transMtx, &result);
-
-        return result;
-    }
-
     static u8 getA(u32 c) { return static_cast<u8>((c >> 24) & 0xFF); }
     static u8 getR(u32 c) { return static_cast<u8>((c >> 16) & 0xFF); }
     static u8 getG(u32 c) { return static_cast<u8>((c >> 8) & 0xFF); }
@@ -72,22 +47,27 @@ namespace gfx
     }
 
 
-    static AEGfxVertexList* buildSpriteMesh(f32 u0, f32 v0, f32 u1, f32 v1)
+    AEGfxVertexList* buildSpriteMesh(f32 u0, f32 v0, f32 u1, f32 v1)
+    {
+        return buildSpriteMesh(-0.5f, -0.5f, 0.5f, 0.5f, u0, v0, u1, v1);
+    }
+
+    AEGfxVertexList* buildSpriteMesh(f32 x0, f32 y0, f32 x1, f32 y1, f32 u0, f32 v0, f32 u1, f32 v1)
     {
         AEGfxMeshStart();
         const u32 white = 0xFFFFFFFF;
 
-        // 2 triangles, unit quad centered at origin
+        // 2 triangles, (x0, y0) bottom left
         AEGfxTriAdd(
-            -0.5f, -0.5f, white, u0, v1,
-            0.5f, -0.5f, white, u1, v1,
-            -0.5f, 0.5f, white, u0, v0
+            x0, y0, white, u0, v1,
+            x1, y0, white, u1, v1,
+            x0, y1, white, u0, v0
         );
 
         AEGfxTriAdd(
-            0.5f, -0.5f, white, u1, v1,
-            0.5f, 0.5f, white, u1, v0,
-            -0.5f, 0.5f, white, u0, v0
+            x1, y0, white, u1, v1,
+            x1, y1, white, u1, v0,
+            x0, y1, white, u0, v0
         );
 
         return AEGfxMeshEnd();
@@ -116,17 +96,17 @@ namespace gfx
             0.5f, -0.5f, 0xFFFFFFFF, 1.0f, 0.0f);
         triMesh = AEGfxMeshEnd();
 
-        // Circle mesh built lazily (first drawCircle call)
-        circleMesh = nullptr;
-        circleSegmentsBuilt = 0;
+        // Circle meshes built lazily (first drawCircle call per segment count)
+        circleMeshes.clear();
     }
 
     void shutdown()
     {
         if (rectMesh) { AEGfxMeshFree(rectMesh); rectMesh = nullptr; }
         if (triMesh) { AEGfxMeshFree(triMesh); triMesh = nullptr; }
-        if (circleMesh) { AEGfxMeshFree(circleMesh); circleMesh = nullptr; }
-        if (spriteMesh) { AEGfxMeshFree(spriteMesh); spriteMesh = nullptr; }
+        for (CircleMesh& c : circleMeshes)
+            AEGfxMeshFree(c.mesh);
+        circleMeshes.clear();
     }
 
     f32 degToRad(f32 degrees)
@@ -135,46 +115,30 @@ namespace gfx
         return degrees * (pi / 180.0f);
     }
 
-    void drawRectangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color)
+    void drawRectangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color, s32 layer)
     {
-        AEGfxSetRenderMode(AE_GFX_RM_COLOR);
-        AEGfxSetBlendMode(AE_GFX_BM_BLEND);
-
-        u8 a = static_cast<u8>((color >> 24) & 0xFF);
-        u8 r = static_cast<u8>((color >> 16) & 0xFF);
-        u8 g = static_cast<u8>((color >> 8) & 0xFF);
-        u8 b = static_cast<u8>((color >> 0) & 0xFF);
-
-        AEGfxSetBlendColor(r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f);
-        AEGfxSetTransparency(a / 255.0f);
-
-        AEMtx33 m = makeTransform(position, rotationRad, size);
-        AEGfxSetTransform(m.m);
-        AEGfxMeshDraw(rectMesh, AE_GFX_MDM_TRIANGLES);
+        submit(flatColor(color), rectMesh, Mat2x3::trs(position, rotationRad, size), layer);
     }
 
 
-    void drawTriangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color)
+    void drawTriangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color, s32 layer)
     {
-        AEGfxSetRenderMode(AE_GFX_RM_COLOR);
-        AEGfxSetBlendMode(AE_GFX_BM_BLEND);
-
-        AEMtx33 m = makeTransform(position, rotationRad, size);
-        AEGfxSetTransform(m.m);
-
-        setTintColor(color);
-        AEGfxMeshDraw(triMesh, AE_GFX_MDM_TRIANGLES);
+        submit(flatColor(color), triMesh, Mat2x3::trs(position, rotationRad, size), layer);
     }
 
-    void drawCircle(Vec2 position, f32 rotationRad, f32 radius, u32 color, int segments)
+    void drawCircle(Vec2 position, f32 rotationRad, f32 radius, u32 color, int segments, s32 layer)
     {
         if (segments <= 0) segments = 32;
 
-        // Rebuild mesh only if segment count changes
-        if (!circleMesh || circleSegmentsBuilt != segments)
+        AEGfxVertexList* circleMesh = nullptr;
+        for (const CircleMesh& c : circleMeshes)
         {
-            if (circleMesh) AEGfxMeshFree(circleMesh);
+            if (c.segments == segments)
+                circleMesh = c.mesh;
+        }
 
+        if (!circleMesh)
+        {
             AEGfxMeshStart();
             const float step = 2.0f * static_cast<float>(AE_PI) / segments;
 
@@ -194,42 +158,30 @@ namespace gfx
             }
 
             circleMesh = AEGfxMeshEnd();
-            circleSegmentsBuilt = segments;
+            circleMeshes.push_back(CircleMesh{ segments, circleMesh });
         }
 
-        AEGfxSetRenderMode(AE_GFX_RM_COLOR);
-        AEGfxSetBlendMode(AE_GFX_BM_BLEND);
-
         Vec2 scale{ radius * 2.0f, radius * 2.0f };
-        AEMtx33 m = makeTransform(position, rotationRad, scale);
-        AEGfxSetTransform(m.m);
-
-        setTintColor(color);
-        AEGfxMeshDraw(circleMesh, AE_GFX_MDM_TRIANGLES);
+        submit(flatColor(color), circleMesh, Mat2x3::trs(position, rotationRad, scale), layer);
     }
 
     void drawSprite(AEGfxTexture* tex, Vec2 position, f32 rotationRad, Vec2 size,
-        f32 u0, f32 v0, f32 u1, f32 v1)
+        f32 u0, f32 v0, f32 u1, f32 v1, s32 layer)
     {
         if (!tex) return;
 
-        // rebuild mesh for these UVs (simple + clear for now)
-        if (spriteMesh) { AEGfxMeshFree(spriteMesh); spriteMesh = nullptr; }
-        spriteMesh = buildSpriteMesh(u0, v0, u1, v1);
+        // one-off mesh for these UVs, freed once it has been drawn
+        AEGfxVertexList* mesh = buildSpriteMesh(u0, v0, u1, v1);
+        releaseAfterFlush(mesh);
 
-        AEGfxSetRenderMode(AE_GFX_RM_TEXTURE);
-        AEGfxSetBlendMode(AE_GFX_BM_BLEND);
-        AEGfxSetTransparency(1.0f);
-
-        // White = no tint
-        AEGfxSetColorToMultiply(1, 1, 1, 1);
-        AEGfxSetColorToAdd(0, 0, 0, 0);
+        drawSpriteMesh(tex, mesh, position, rotationRad, size, layer);
+    }
 
-        AEGfxTextureSet(tex, 0, 0);
+    void drawSpriteMesh(AEGfxTexture* tex, AEGfxVertexList* mesh, Vec2 position, f32 rotationRad, Vec2 size, s32 layer)
+    {
+        if (!tex || !mesh) return;
 
-        // ✅ MISSING PART (THIS IS THE BUG)
-        AEMtx33 m = makeTransform(position, rotationRad, size);
-        AEGfxSetTransform(m.m);
-        AEGfxMeshDraw(spriteMesh, AE_GFX_MDM_TRIANGLES);
+        // Sprites have transparent edges.
+        submit(textured(tex, Opacity::Blended), mesh, Mat2x3::trs(position, rotationRad, size), layer);
     }
 }
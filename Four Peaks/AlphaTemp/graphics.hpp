@@ -8,26 +8,38 @@
 
 #include <AETypes.h>   // f32, u32
 #include <AEMtx33.h>   // AEMtx33
+#include "math2d.hpp"  // Vec2, Mat2x3 (inline, no DLL calls)
+#include "render_queue.hpp"
 
 namespace gfx
 {
-    struct Vec2
-    {
-        f32 x{};
-        f32 y{};
-    };
-
     // These functions are implemented in graphics.cpp
     void init();
     void shutdown();
 
     f32 degToRad(f32 degrees);
-    AEMtx33 makeTransform(Vec2 position, f32 rotationRad, Vec2 scale);
 
-    void drawRectangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color);
-    void drawTriangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color);
-    void drawCircle(Vec2 position, f32 rotationRad, f32 radius, u32 color, int segments = 0);
+    // translate * rotate * scale, converted to AE's type for AEGfxSetTransform.
+    inline AEMtx33 makeTransform(Vec2 position, f32 rotationRad, Vec2 scale)
+    {
+        return toAE(Mat2x3::trs(position, rotationRad, scale));
+    }
+
+    // The draw helpers queue their draw (render_queue.hpp); it happens at
+    // the next flushQueue(). Colors with alpha 255 are drawn opaque.
+    void drawRectangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color, s32 layer = kLayerEntities);
+    void drawTriangle(Vec2 position, f32 rotationRad, Vec2 size, u32 color, s32 layer = kLayerEntities);
+    void drawCircle(Vec2 position, f32 rotationRad, f32 radius, u32 color, int segments = 0, s32 layer = kLayerEntities);
 
     // draw player sprite
-    void drawSprite(AEGfxTexture* tex, Vec2 position, f32 rotationRad, Vec2 size, f32 u0, f32 v0, f32 u1, f32 v1);
+    void drawSprite(AEGfxTexture* tex, Vec2 position, f32 rotationRad, Vec2 size, f32 u0, f32 v0, f32 u1, f32 v1,
+        s32 layer = kLayerEntities);
+
+    // Unit quad centered at the origin with the given UVs (caller frees).
+    AEGfxVertexList* buildSpriteMesh(f32 u0, f32 v0, f32 u1, f32 v1);
+    // Quad over [x0, x1] x [y0, y1] of that unit square (trimmed frames).
+    AEGfxVertexList* buildSpriteMesh(f32 x0, f32 y0, f32 x1, f32 y1, f32 u0, f32 v0, f32 u1, f32 v1);
+    // Same as drawSprite with a prebuilt quad (animation frames).
+    void drawSpriteMesh(AEGfxTexture* tex, AEGfxVertexList* mesh, Vec2 position, f32 rotationRad, Vec2 size,
+        s32 layer = kLayerEntities);
 }
@@ -0,0 +1,205 @@
+// ---------------------------------------------------------------------------
+// hot_reload.cpp
+// ---------------------------------------------------------------------------
+
+#include "hot_reload.hpp"
+#include "deferred.hpp"
+#include "file_watch.hpp"
+#include "vfs_loaders.hpp"
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hotreload
+{
+    namespace
+    {
+        struct Watch
+        {
+            std::string path;
+            ReloadFn reload;
+        };
+
+        std::unique_ptr<game::FileWatcher> watcher;
+        std::thread worker;
+        std::atomic<bool> running{ false };
+
+        std::mutex lock;
+        std::map<int, Watch> watches;
+        std::vector<std::pair<int, ApplyFn>> pending; // (watch handle, apply)
+        int nextHandle = 1;
+
+        // Swaps are for development; a quarter second is soon enough.
+        const f64 kApplyDeadline = 0.25;
+
+        // Main thread. Runs the oldest queued apply; true if more remain.
+        bool applyNext()
+        {
+            std::pair<int, ApplyFn> next;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (pending.empty())
+                    return false;
+                next = pending.front();
+                pending.erase(pending.begin());
+            }
+
+            next.second();
+
+            std::lock_guard<std::mutex> guard(lock);
+            return !pending.empty();
+        }
+
+        void workerMain()
+        {
+            std::vector<std::string> changed;
+            while (running)
+            {
+                watcher->poll(changed, 250);
+
+                for (const std::string& path : changed)
+                {
+                    // Copy the reload functions so user code runs unlocked.
+                    std::vector<std::pair<int, ReloadFn>> fns;
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        for (const auto& w : watches)
+                        {
+                            if (w.second.path == path)
+                                fns.push_back(std::make_pair(w.first, w.second.reload));
+                        }
+                    }
+
+                    for (const auto& fn : fns)
+                    {
+                        ApplyFn apply = fn.second(path);
+                        if (!apply)
+                            continue;
+
+                        // Dropped if the watch went away while reloading.
+                        {
+                            std::lock_guard<std::mutex> guard(lock);
+                            if (!watches.count(fn.first))
+                                continue;
+                            PRINT("hotreload: %s\n", path.c_str());
+                            pending.push_back(std::make_pair(fn.first, apply));
+                        }
+                        deferred::submit("hot reload", deferred::Priority::Normal, kApplyDeadline,
+                            []() { return !applyNext(); });
+                    }
+                }
+            }
+        }
+
+        std::string normalise(std::string path)
+        {
+            for (char& c : path)
+            {
+                if (c == '\\') c = '/';
+            }
+            return path;
+        }
+    }
+
+    void init()
+    {
+#if FP_HOT_RELOAD
+        if (running)
+            return;
+
+        watcher.reset(new game::FileWatcher());
+        running = true;
+        worker = std::thread(workerMain);
+#endif
+    }
+
+    void shutdown()
+    {
+        if (!running)
+            return;
+
+        running = false;
+        worker.join();
+        watcher.reset();
+
+        std::lock_guard<std::mutex> guard(lock);
+        watches.clear();
+        pending.clear();
+    }
+
+    int watch(const std::string& rawPath, ReloadFn reload)
+    {
+        if (!running)
+            return 0;
+
+        const std::string path = normalise(rawPath);
+        watcher->add(path);
+
+        std::lock_guard<std::mutex> guard(lock);
+        int handle = nextHandle++;
+        watches[handle] = Watch{ path, reload };
+        return handle;
+    }
+
+    void unwatch(int handle)
+    {
+        if (handle == 0 || !running)
+            return;
+
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = watches.find(handle);
+        if (it == watches.end())
+            return;
+
+        const std::string path = it->second.path;
+        watches.erase(it);
+
+        // Never run an apply for a watch its owner already released.
+        for (size_t i = 0; i < pending.size();)
+        {
+            if (pending[i].first == handle)
+                pending.erase(pending.begin() + i);
+            else
+                ++i;
+        }
+
+        for (const auto& w : watches)
+        {
+            if (w.second.path == path)
+                return;
+        }
+        watcher->remove(path);
+    }
+
+    int watchTexture(const std::string& path, AEGfxTexture** slot)
+    {
+        return watch(path, [slot](const std::string& changed) -> ApplyFn
+        {
+            // AE only loads textures from a path on the render thread, so the
+            // worker just checks the file is complete and readable.
+            std::ifstream probe(changed, std::ios::binary | std::ios::ate);
+            if (!probe || probe.tellg() <= 0)
+                return ApplyFn();
+
+            return [slot, changed]()
+            {
+                AEGfxTexture* fresh = vfs::loadTexture(changed.c_str());
+                if (!fresh)
+                    return;
+                if (*slot)
+                    AEGfxTextureUnload(*slot);
+                *slot = fresh;
+            };
+        });
+    }
+
+    int watchTexture(game::AssetId id, AEGfxTexture** slot)
+    {
+        const char* path = game::assetName(id);
+        return path ? watchTexture(path, slot) : 0;
+    }
+}
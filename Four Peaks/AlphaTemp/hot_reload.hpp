@@ -0,0 +1,54 @@
+// ---------------------------------------------------------------------------
+// hot_reload.hpp
+// ---------------------------------------------------------------------------
+//
+// Live reload of assets while the game runs (development builds).
+//
+// watch() registers a reload function for a file. When the file changes, the
+// reload function runs on the hot reload thread (parse/decode off the main
+// thread) and returns an apply function. Apply functions run on the main
+// thread as deferred tasks, one per slice, in the slack after draw, so
+// nothing is swapped mid-update or mid-draw and a burst of changed files
+// doesn't land in a single frame.
+//
+// Enabled when FP_HOT_RELOAD is non-zero (defaults to debug builds only);
+// otherwise every call is a no-op.
+//
+
+#ifndef HOT_RELOAD_HPP
+#define HOT_RELOAD_HPP
+
+#include "AEEngine.h"
+#include "asset_id.hpp"
+#include <functional>
+#include <string>
+
+#ifndef FP_HOT_RELOAD
+#ifdef _DEBUG
+#define FP_HOT_RELOAD 1
+#else
+#define FP_HOT_RELOAD 0
+#endif
+#endif
+
+namespace hotreload
+{
+    typedef std::function<void()> ApplyFn;
+    // Runs on the hot reload thread. Return an empty ApplyFn to skip.
+    typedef std::function<ApplyFn(const std::string& path)> ReloadFn;
+
+    void init();
+    void shutdown();
+
+    // Returns a handle for unwatch(); 0 if hot reload is disabled.
+    int watch(const std::string& path, ReloadFn reload);
+    void unwatch(int handle);
+
+    // Reloads a texture in place: *slot is swapped to the new texture and the
+    // old one unloaded. The slot must stay valid until unwatch().
+    int watchTexture(const std::string& path, AEGfxTexture** slot);
+    // Same, by ID. Needs the asset name table (FP_ASSET_NAMES), 0 otherwise.
+    int watchTexture(game::AssetId id, AEGfxTexture** slot);
+}
+
+#endif // HOT_RELOAD_HPP
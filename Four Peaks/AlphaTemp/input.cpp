@@ -0,0 +1,302 @@
+// ---------------------------------------------------------------------------
+// input.cpp
+// ---------------------------------------------------------------------------
+
+#include "input.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+namespace input
+{
+    namespace
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        struct Event
+        {
+            f64 time;
+            u8 key;         // 0 = focus lost, release everything
+            bool down;
+            f64 arrived;    // frame time it was drained in
+        };
+
+        // Single producer (capture thread), single consumer (beginFrame).
+        const u32 kRingSize = 256;     // power of two
+        Event gRing[kRingSize];
+        std::atomic<u32> gHead(0);
+        std::atomic<u32> gTail(0);
+
+        std::thread gThread;
+        std::atomic<DWORD> gThreadId(0);
+        std::atomic<int> gCapture(0);   // 0 starting, 1 running, -1 unavailable
+        bool gFocused = true;
+
+        Clock::time_point gOrigin = Clock::now();
+        f64 gFrameTime = 0.0;
+
+        bool gDown[256];
+        bool gPressed[256];
+        bool gReleased[256];
+        f64 gConsumed[256];             // presses at or before this are used
+        std::deque<Event> gHistory;     // applied transitions, oldest first
+
+        void push(u8 key, bool down, f64 time)
+        {
+            const u32 head = gHead.load(std::memory_order_relaxed);
+            if (head - gTail.load(std::memory_order_acquire) >= kRingSize)
+                return;     // a full frame's worth; drop rather than block
+
+            gRing[head & (kRingSize - 1)] = Event{ time, key, down, 0.0 };
+            gHead.store(head + 1, std::memory_order_release);
+        }
+
+        void readRawInput(HRAWINPUT handle, f64 time, HWND game)
+        {
+            RAWINPUT raw;
+            UINT size = sizeof(raw);
+            if (GetRawInputData(handle, RID_INPUT, &raw, &size, sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1))
+                return;
+
+            // Registered as a sink so it arrives whatever has focus; only
+            // the game's own input counts.
+            if (GetForegroundWindow() != game)
+                return;
+
+            if (raw.header.dwType == RIM_TYPEKEYBOARD)
+            {
+                // 255 marks the fake keys of escaped sequences. Auto-repeat
+                // comes through as more downs; apply() drops those.
+                const RAWKEYBOARD& k = raw.data.keyboard;
+                if (k.VKey > 0 && k.VKey < 255)
+                    push(static_cast<u8>(k.VKey), !(k.Flags & RI_KEY_BREAK), time);
+            }
+            else if (raw.header.dwType == RIM_TYPEMOUSE)
+            {
+                const USHORT b = raw.data.mouse.usButtonFlags;
+                if (b & RI_MOUSE_LEFT_BUTTON_DOWN)   push(VK_LBUTTON, true, time);
+                if (b & RI_MOUSE_LEFT_BUTTON_UP)     push(VK_LBUTTON, false, time);
+                if (b & RI_MOUSE_RIGHT_BUTTON_DOWN)  push(VK_RBUTTON, true, time);
+                if (b & RI_MOUSE_RIGHT_BUTTON_UP)    push(VK_RBUTTON, false, time);
+                if (b & RI_MOUSE_MIDDLE_BUTTON_DOWN) push(VK_MBUTTON, true, time);
+                if (b & RI_MOUSE_MIDDLE_BUTTON_UP)   push(VK_MBUTTON, false, time);
+            }
+        }
+
+        // Owns a message-only window that receives raw keyboard and mouse
+        // input. It sleeps in GetMessage, so an event is stamped as soon as
+        // Windows delivers it rather than when AE next pumps its queue.
+        void captureThread(HWND game)
+        {
+            const HINSTANCE instance = GetModuleHandleA(NULL);
+            WNDCLASSA wc{};
+            wc.lpfnWndProc = DefWindowProcA;
+            wc.hInstance = instance;
+            wc.lpszClassName = "FourPeaksInput";
+            RegisterClassA(&wc);
+
+            HWND sink = CreateWindowExA(0, wc.lpszClassName, "", 0, 0, 0, 0, 0, HWND_MESSAGE, NULL, instance, NULL);
+            RAWINPUTDEVICE devices[2] = {
+                { 0x01, 0x06, RIDEV_INPUTSINK, sink },     // generic desktop: keyboard
+                { 0x01, 0x02, RIDEV_INPUTSINK, sink },     // generic desktop: mouse
+            };
+            if (!sink || !RegisterRawInputDevices(devices, 2, sizeof(devices[0])))
+            {
+                if (sink)
+                    DestroyWindow(sink);
+                UnregisterClassA(wc.lpszClassName, instance);
+                gCapture.store(-1);
+                return;
+            }
+            gCapture.store(1);
+
+            MSG msg;
+            while (GetMessageA(&msg, NULL, 0, 0) > 0)
+            {
+                if (msg.message == WM_INPUT)
+                    readRawInput(reinterpret_cast<HRAWINPUT>(msg.lParam), now(), game);
+                DispatchMessageA(&msg);     // WM_INPUT cleanup is DefWindowProc's
+            }
+
+            devices[0].dwFlags = devices[1].dwFlags = RIDEV_REMOVE;
+            devices[0].hwndTarget = devices[1].hwndTarget = NULL;
+            RegisterRawInputDevices(devices, 2, sizeof(devices[0]));
+            DestroyWindow(sink);
+            UnregisterClassA(wc.lpszClassName, instance);
+        }
+
+        void apply(const Event& ev)
+        {
+            if (ev.key == 0)
+            {
+                for (int k = 1; k < 256; ++k)
+                {
+                    if (gDown[k])
+                        apply(Event{ ev.time, static_cast<u8>(k), false, ev.arrived });
+                }
+                return;
+            }
+
+            if (gDown[ev.key] == ev.down)
+                return;     // repeat or missed transition
+
+            gDown[ev.key] = ev.down;
+            if (ev.down)
+                gPressed[ev.key] = true;
+            else
+                gReleased[ev.key] = true;
+            gHistory.push_back(ev);
+            gHistory.back().arrived = gFrameTime;
+        }
+    }
+
+    void init()
+    {
+        gOrigin = Clock::now();
+        gFrameTime = 0.0;
+        std::memset(gDown, 0, sizeof(gDown));
+        std::memset(gPressed, 0, sizeof(gPressed));
+        std::memset(gReleased, 0, sizeof(gReleased));
+        for (f64& c : gConsumed)
+            c = -1.0;
+        gHistory.clear();
+        gTail.store(gHead.load());
+    }
+
+    f64 now()
+    {
+        return std::chrono::duration<f64>(Clock::now() - gOrigin).count();
+    }
+
+    f64 frameTime()
+    {
+        return gFrameTime;
+    }
+
+    // -------------------------------------------------------------------
+    // start / shutdown - the capture thread
+    // -------------------------------------------------------------------
+    void start(HWND window)
+    {
+        if (gThread.joinable())
+            return;
+
+        gCapture.store(0);
+        gThread = std::thread([window]()
+        {
+            gThreadId.store(GetCurrentThreadId());
+            captureThread(window);
+        });
+
+        // Until it's up (or failed) beginFrame can't tell which path to use.
+        while (gCapture.load() == 0)
+            std::this_thread::yield();
+    }
+
+    void shutdown()
+    {
+        if (!gThread.joinable())
+            return;
+        if (gCapture.load() > 0)
+            PostThreadMessageA(gThreadId.load(), WM_QUIT, 0, 0);
+        gThread.join();
+        gCapture.store(0);
+    }
+
+    // -------------------------------------------------------------------
+    // beginFrame
+    // -------------------------------------------------------------------
+    void beginFrame()
+    {
+        // Everything queued so far happened before the frame time; later
+        // events wait for the next frame.
+        const u32 head = gHead.load(std::memory_order_acquire);
+        gFrameTime = now();
+        std::memset(gPressed, 0, sizeof(gPressed));
+        std::memset(gReleased, 0, sizeof(gReleased));
+
+        if (gCapture.load(std::memory_order_relaxed) > 0)
+        {
+            u32 tail = gTail.load(std::memory_order_relaxed);
+            for (; tail != head; ++tail)
+                apply(gRing[tail & (kRingSize - 1)]);
+            gTail.store(tail, std::memory_order_release);
+
+            // Key ups go to whoever has focus now.
+            const bool focused = AESysIsFocus() != 0;
+            if (gFocused && !focused)
+                apply(Event{ gFrameTime, 0, false, gFrameTime });
+            gFocused = focused;
+        }
+        else
+        {
+            // No callback: diff AE's key state, stamped with the frame start.
+            for (int k = 1; k < 256; ++k)
+                apply(Event{ gFrameTime, static_cast<u8>(k), AEInputCheckCurr(static_cast<u8>(k)) != 0, gFrameTime });
+        }
+
+        while (!gHistory.empty() && gHistory.front().time < gFrameTime - kHistorySeconds)
+            gHistory.pop_front();
+    }
+
+    // -------------------------------------------------------------------
+    // queries
+    // -------------------------------------------------------------------
+    bool held(u8 key) { return gDown[key]; }
+    bool pressed(u8 key) { return gPressed[key]; }
+    bool released(u8 key) { return gReleased[key]; }
+
+    bool heldAt(u8 key, f64 time)
+    {
+        // Walk back from the current state, undoing newer transitions.
+        bool state = gDown[key];
+        for (auto it = gHistory.rbegin(); it != gHistory.rend(); ++it)
+        {
+            if (it->key != key)
+                continue;
+            if (it->time <= time)
+                return it->down;
+            state = !it->down;
+        }
+        return state;
+    }
+
+    bool pressedBetween(u8 key, f64 from, f64 to)
+    {
+        // The history is short; look at all of it.
+        for (const Event& ev : gHistory)
+        {
+            if (ev.key == key && ev.down && ev.time > from && ev.time <= to && ev.time > gConsumed[key])
+                return true;
+        }
+        return false;
+    }
+
+    bool lastPress(u8 key, f64 upTo, f64& time, f64& arrived)
+    {
+        bool found = false;
+        for (const Event& ev : gHistory)
+        {
+            if (ev.key == key && ev.down && ev.time <= upTo && (!found || ev.time >= time))
+            {
+                time = ev.time;
+                arrived = ev.arrived;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    bool buffered(u8 key, f64 window, f64 at)
+    {
+        return pressedBetween(key, at - window, at);
+    }
+
+    void consume(u8 key, f64 upTo)
+    {
+        if (upTo > gConsumed[key])
+            gConsumed[key] = upTo;
+    }
+}
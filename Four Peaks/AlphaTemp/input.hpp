@@ -0,0 +1,74 @@
+// ---------------------------------------------------------------------------
+// input.hpp
+// ---------------------------------------------------------------------------
+//
+// Timestamped keyboard / mouse button input.
+//
+// A capture thread receives raw keyboard and mouse input (WM_INPUT) for the
+// game window and stamps every key transition on the now() clock (QPC) as
+// Windows delivers it, so times are accurate to well under a millisecond
+// and a press that lands mid-frame carries its real time. Events go into a
+// lock-free ring buffer. beginFrame() drains the ring once per frame and
+// builds the frame's snapshot; everything else reads that snapshot instead
+// of polling the AE DLL again from update and draw.
+//
+// Message times (GetMessageTime) aren't used: they move in system timer
+// ticks (~15.6 ms), and AE only pumps its queue at frame start.
+//
+// Fixed-step code asks per tick: pressedBetween() over the tick's time slice
+// and heldAt() its end, so each event lands on the tick it happened in.
+// A short history (kHistorySeconds) is kept so a tick can look back past the
+// start of the current frame.
+//
+// Jump buffering: buffered() reports a press within a window before a given
+// time that hasn't been consume()d yet, so an early press still jumps on
+// landing.
+//
+// If raw input can't be registered, beginFrame() falls back to diffing
+// AEInputCheckCurr (timestamps are then the frame start).
+//
+// Times are seconds on the now() clock. Keys are AEVK_* codes.
+//
+
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include "AEEngine.h"
+
+namespace input
+{
+    static const f64 kHistorySeconds = 0.5;
+
+    // Call before AESysInit.
+    void init();
+
+    // After AESysInit, with AESysGetWindowHandle(); shutdown() before
+    // AESysExit.
+    void start(HWND window);
+    void shutdown();
+
+    // Main thread, right after AESysFrameStart().
+    void beginFrame();
+
+    f64 now();
+    f64 frameTime();        // when beginFrame() ran
+
+    // This frame's snapshot.
+    bool held(u8 key);
+    bool pressed(u8 key);   // went down since the last frame
+    bool released(u8 key);  // went up since the last frame
+
+    // Sub-frame queries over the recent history.
+    bool heldAt(u8 key, f64 time);
+    bool pressedBetween(u8 key, f64 from, f64 to);   // (from, to], unconsumed
+
+    // Newest press at or before upTo: when it happened and the frame time
+    // beginFrame() picked it up (latency measurement).
+    bool lastPress(u8 key, f64 upTo, f64& time, f64& arrived);
+
+    // Jump buffering.
+    bool buffered(u8 key, f64 window, f64 at);       // unconsumed press in [at - window, at]
+    void consume(u8 key, f64 upTo);                  // presses up to upTo are used
+}
+
+#endif // INPUT_HPP
@@ -0,0 +1,218 @@
+// ---------------------------------------------------------------------------
+// job_system.cpp
+// ---------------------------------------------------------------------------
+
+#include "job_system.hpp"
+
+namespace game
+{
+    namespace
+    {
+        // Which system / worker the calling thread belongs to.
+        thread_local const JobSystem* tOwner = nullptr;
+        thread_local int tWorker = -1;
+    }
+
+    JobSystem::JobSystem(unsigned workerCount)
+        : queued(0)
+        , quit(false)
+    {
+        if (workerCount == 0)
+        {
+            const unsigned cores = std::thread::hardware_concurrency();
+            workerCount = cores > 1 ? cores - 1 : 1;
+        }
+
+        for (unsigned i = 0; i <= workerCount; ++i)
+            queues.emplace_back(new Queue());
+
+        for (unsigned i = 0; i < workerCount; ++i)
+            workers.emplace_back(&JobSystem::workerMain, this, i);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        // Let everything already queued run; it may own resources.
+        while (helpOne())
+        {
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers)
+            t.join();
+    }
+
+    int JobSystem::currentWorker() const
+    {
+        return tOwner == this ? tWorker : -1;
+    }
+
+    // -------------------------------------------------------------------
+    // submit
+    // -------------------------------------------------------------------
+    void JobSystem::run(Job job, JobCounter* counter)
+    {
+        if (counter)
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        push(Item{ std::move(job), counter });
+    }
+
+    void JobSystem::runAfter(JobCounter& after, Job job, JobCounter* counter)
+    {
+        if (counter)
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            // finish() drops the count under this lock, so either we see
+            // zero here or it sees our continuation.
+            std::lock_guard<std::mutex> guard(after.lock);
+            if (after.pending.load(std::memory_order_acquire) != 0)
+            {
+                after.continuations.push_back(JobCounter::Continuation{ std::move(job), counter });
+                return;
+            }
+        }
+
+        push(Item{ std::move(job), counter });
+    }
+
+    void JobSystem::push(Item item)
+    {
+        const int self = currentWorker();
+        Queue& q = *queues[self >= 0 ? static_cast<size_t>(self) : workers.size()];
+        queued.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> guard(q.lock);
+            q.items.push_back(std::move(item));
+        }
+
+        // Taking the sleep lock orders this against a worker that checked
+        // `queued` just before we bumped it.
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+        }
+        wake.notify_one();
+    }
+
+    // -------------------------------------------------------------------
+    // pop - own queue (newest), shared queue, then steal (oldest)
+    // -------------------------------------------------------------------
+    bool JobSystem::pop(Item& out)
+    {
+        if (queued.load(std::memory_order_acquire) == 0)
+            return false;
+
+        const int self = currentWorker();
+        const size_t shared = workers.size();
+
+        if (self >= 0)
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (!own.items.empty())
+            {
+                out = std::move(own.items.back());
+                own.items.pop_back();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Start after ourselves so thieves spread over the victims.
+        const size_t count = queues.size();
+        const size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : shared;
+        for (size_t n = 0; n < count; ++n)
+        {
+            const size_t i = (start + n) % count;
+            if (static_cast<int>(i) == self)
+                continue;
+
+            Queue& q = *queues[i];
+            std::lock_guard<std::mutex> guard(q.lock);
+            if (!q.items.empty())
+            {
+                out = std::move(q.items.front());
+                q.items.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // -------------------------------------------------------------------
+    // execute / finish
+    // -------------------------------------------------------------------
+    void JobSystem::execute(Item& item)
+    {
+        item.job();
+        item.job = nullptr;     // release captures before signalling
+        if (item.counter)
+            finish(*item.counter);
+    }
+
+    void JobSystem::finish(JobCounter& counter)
+    {
+        std::vector<JobCounter::Continuation> ready;
+        {
+            std::lock_guard<std::mutex> guard(counter.lock);
+            if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            ready.swap(counter.continuations);
+        }
+        // The counter may be gone from here on (its waiter can return).
+
+        for (JobCounter::Continuation& c : ready)
+            push(Item{ std::move(c.job), c.counter });
+    }
+
+    bool JobSystem::helpOne()
+    {
+        Item item;
+        if (!pop(item))
+            return false;
+        execute(item);
+        return true;
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        while (!counter.done())
+        {
+            if (!helpOne())
+                std::this_thread::yield();
+        }
+
+        // Wait out a finish() still holding the lock before the caller is
+        // allowed to destroy the counter.
+        std::lock_guard<std::mutex> guard(counter.lock);
+    }
+
+    // -------------------------------------------------------------------
+    // workerMain
+    // -------------------------------------------------------------------
+    void JobSystem::workerMain(unsigned index)
+    {
+        tOwner = this;
+        tWorker = static_cast<int>(index);
+
+        for (;;)
+        {
+            Item item;
+            if (pop(item))
+            {
+                execute(item);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this]() { return quit || queued.load(std::memory_order_acquire) > 0; });
+            if (quit && queued.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+}
@@ -0,0 +1,165 @@
+// ---------------------------------------------------------------------------
+// job_system.hpp
+// ---------------------------------------------------------------------------
+//
+// Work-stealing job system shared by loading, streaming, baking and the
+// tools.
+//
+// Every worker owns a deque: it pushes and pops its own jobs at the back
+// (newest first, cache warm) and, when it runs dry, steals the oldest job
+// from the front of another worker's deque. Threads that aren't workers (the
+// main thread, tool threads) submit into a shared queue the workers also
+// drain.
+//
+// Completion is tracked with JobCounters: run(job, &counter) bumps the
+// counter and the job drops it when done. wait() doesn't block idle - the
+// waiting thread runs queued jobs until the counter reaches zero, so the
+// main thread helps instead of stalling. runAfter() chains a job onto a
+// counter for simple dependencies.
+//
+// Jobs must not call Alpha Engine graphics functions (AE is single
+// threaded). No AE dependency here, so the tools link it on Linux too.
+//
+
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game
+{
+    typedef std::function<void()> Job;
+
+    class JobCounter
+    {
+    public:
+        JobCounter() : pending(0) {}
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        // Polling is fine; call JobSystem::wait() before destroying a
+        // counter that may still have jobs in flight.
+        bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        struct Continuation
+        {
+            Job job;
+            JobCounter* counter;
+        };
+
+        std::atomic<int> pending;
+        std::mutex lock;                          // held while dropping to zero
+        std::vector<Continuation> continuations;  // run once pending hits zero
+    };
+
+    class JobSystem
+    {
+    public:
+        // 0 = one per core, leaving one for the main thread.
+        explicit JobSystem(unsigned workerCount = 0);
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // Queues a job. counter (optional) is bumped now and dropped when
+        // the job has finished.
+        void run(Job job, JobCounter* counter = nullptr);
+
+        // Queues job once `after` reaches zero (straight away if it already
+        // has). counter, as for run(), is bumped now.
+        void runAfter(JobCounter& after, Job job, JobCounter* counter = nullptr);
+
+        // Runs queued jobs on the calling thread until counter is zero.
+        void wait(JobCounter& counter);
+
+        // Runs one queued job on the calling thread, if there is one.
+        bool helpOne();
+
+        // Calls fn(i) for every i in [begin, end), `grain` indices per job
+        // (0 = pick from the worker count), and waits for all of them.
+        template <typename Fn>
+        void parallelFor(size_t begin, size_t end, size_t grain, const Fn& fn);
+
+        unsigned workerCount() const { return static_cast<unsigned>(workers.size()); }
+
+    private:
+        struct Item
+        {
+            Job job;
+            JobCounter* counter;
+        };
+
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque<Item> items;
+        };
+
+        std::vector<std::thread> workers;
+        // One per worker, then the shared queue for everyone else.
+        std::vector<std::unique_ptr<Queue>> queues;
+
+        std::atomic<int> queued;        // items across all queues
+        std::mutex sleepLock;
+        std::condition_variable wake;
+        bool quit;
+
+        void push(Item item);
+        bool pop(Item& out);
+        void execute(Item& item);
+        void finish(JobCounter& counter);
+        void workerMain(unsigned index);
+        int currentWorker() const;
+    };
+
+    // -------------------------------------------------------------------
+    // parallelFor
+    // -------------------------------------------------------------------
+    template <typename Fn>
+    void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, const Fn& fn)
+    {
+        if (begin >= end)
+            return;
+
+        const size_t count = end - begin;
+        if (grain == 0)
+        {
+            // A few batches per thread so stealing can even out the load.
+            const size_t batches = (workers.size() + 1) * 4;
+            grain = std::max<size_t>(1, (count + batches - 1) / batches);
+        }
+
+        if (count <= grain)
+        {
+            for (size_t i = begin; i < end; ++i)
+                fn(i);
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t first = begin; first < end; first += grain)
+        {
+            const size_t last = std::min(end, first + grain);
+            run([&fn, first, last]()
+            {
+                for (size_t i = first; i < last; ++i)
+                    fn(i);
+            }, &counter);
+        }
+        wait(counter);
+    }
+}
+
+#endif // JOB_SYSTEM_HPP
@@ -0,0 +1,183 @@
+// ---------------------------------------------------------------------------
+// latency.cpp
+// ---------------------------------------------------------------------------
+
+#include "latency.hpp"
+#include "input.hpp"
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if FP_LATENCY
+
+namespace latency
+{
+    namespace
+    {
+        const char* const kLogPath = "latency.log";
+        const char* const kStageNames[kStageCount] = { "queue", "simulate", "render", "present", "total" };
+
+        const int kBuckets = 100;      // 1 ms each; the last one is 99 ms and up
+
+        struct Histogram
+        {
+            u32 bucket[kBuckets];
+            u32 count;
+            f64 sum;
+            f64 max;
+        };
+
+        struct Pending
+        {
+            f64 input;
+            f64 arrived;
+            f64 consumed;
+            f64 drawn;
+            u32 tick;
+        };
+
+        Histogram gStages[kStageCount];
+        std::vector<Pending> gOpen;     // consumed this frame, not drawn yet
+        std::vector<Pending> gDrawn;    // drawn, waiting for the present
+        f64 gLastPress = -1.0;
+        u32 gLastTick = 0;
+
+        void add(Stage stage, f64 seconds)
+        {
+            Histogram& h = gStages[stage];
+            const f64 ms = seconds > 0.0 ? seconds * 1000.0 : 0.0;
+            int b = static_cast<int>(ms);
+            if (b >= kBuckets)
+                b = kBuckets - 1;
+            ++h.bucket[b];
+            ++h.count;
+            h.sum += ms;
+            if (ms > h.max)
+                h.max = ms;
+        }
+
+        // Upper edge of the bucket holding the given fraction of samples,
+        // capped at the largest sample.
+        f64 percentile(const Histogram& h, f64 fraction)
+        {
+            const u32 target = static_cast<u32>(h.count * fraction + 0.5);
+            u32 seen = 0;
+            for (int b = 0; b < kBuckets; ++b)
+            {
+                seen += h.bucket[b];
+                if (seen >= target && seen > 0)
+                    return b + 1 < h.max ? b + 1 : h.max;
+            }
+            return h.max;
+        }
+    }
+
+    void consumed(u8 key, f64 upTo, u32 tick)
+    {
+        f64 pressTime = 0.0;
+        f64 arrived = 0.0;
+        if (!input::lastPress(key, upTo, pressTime, arrived) || pressTime == gLastPress)
+            return;
+
+        gLastPress = pressTime;
+        gLastTick = tick;
+        gOpen.push_back(Pending{ pressTime, arrived, input::now(), 0.0, tick });
+    }
+
+    void frameDrawn()
+    {
+        const f64 t = input::now();
+        for (Pending& p : gOpen)
+        {
+            p.drawn = t;
+            gDrawn.push_back(p);
+        }
+        gOpen.clear();
+    }
+
+    void framePresented()
+    {
+        const f64 t = input::now();
+        for (const Pending& p : gDrawn)
+        {
+            add(kQueue, p.arrived - p.input);
+            add(kSimulate, p.consumed - p.arrived);
+            add(kRender, p.drawn - p.consumed);
+            add(kPresent, t - p.drawn);
+            add(kTotal, t - p.input);
+        }
+        gDrawn.clear();
+    }
+
+    u32 count()
+    {
+        return gStages[kTotal].count;
+    }
+
+    void report()
+    {
+        if (count() == 0)
+            return;
+
+        std::ofstream log(kLogPath, std::ios::app);
+        if (log)
+        {
+            char stamp[32] = {};
+            const std::time_t now = std::time(nullptr);
+            std::tm local = {};
+#ifdef _WIN32
+            localtime_s(&local, &now);
+#else
+            localtime_r(&now, &local);
+#endif
+            std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+            log << "latency " << stamp << "  (" << count() << " presses, last on tick " << gLastTick << ")\n";
+        }
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-10s %8s %8s %8s %8s %8s\n", "stage", "mean", "p50", "p95", "p99", "max");
+        PRINT("%s", line);
+        if (log)
+            log << line;
+
+        for (int s = 0; s < kStageCount; ++s)
+        {
+            const Histogram& h = gStages[s];
+            std::snprintf(line, sizeof(line), "  %-10s %6.1fms %6.1fms %6.1fms %6.1fms %6.1fms\n",
+                kStageNames[s], h.sum / h.count, percentile(h, 0.50), percentile(h, 0.95),
+                percentile(h, 0.99), h.max);
+            PRINT("%s", line);
+            if (log)
+                log << line;
+        }
+
+        // Histograms only go to the log; they're too long for the console.
+        if (!log)
+            return;
+        for (int s = 0; s < kStageCount; ++s)
+        {
+            const Histogram& h = gStages[s];
+            log << "  " << kStageNames[s] << ":\n";
+            for (int b = 0; b < kBuckets; ++b)
+            {
+                if (h.bucket[b] == 0)
+                    continue;
+                std::snprintf(line, sizeof(line), "    %3d%s ms %6u ", b, b == kBuckets - 1 ? "+" : " ", h.bucket[b]);
+                log << line << std::string(h.bucket[b] * 50 / h.count, '#') << "\n";
+            }
+        }
+    }
+
+    void reset()
+    {
+        for (Histogram& h : gStages)
+            h = Histogram{};
+        gOpen.clear();
+        gDrawn.clear();
+        gLastTick = 0;
+    }
+}
+
+#endif // FP_LATENCY
@@ -0,0 +1,79 @@
+// ---------------------------------------------------------------------------
+// latency.hpp
+// ---------------------------------------------------------------------------
+//
+// Input-to-photon latency, measured per press.
+//
+// Each sample follows one press through the pipeline:
+//
+//   input     when the input thread received the press (input::lastPress)
+//   arrived   frame time of the beginFrame() that drained it
+//   consumed  when the simulation acted on it (the jump fired)
+//   drawn     end of that frame's draw calls
+//   presented AESysFrameEnd() returned (buffer swap / vsync wait done)
+//
+// Stage latencies are the differences; each stage and the total go into a
+// 1 ms histogram. report() prints count, mean, percentiles and max per stage
+// and appends the histograms to latency.log, so frame pacing, threading and
+// vsync changes can be compared run against run.
+//
+// "presented" is the swap, not the photons: scanout and the display add a
+// roughly constant amount on top that this can't see.
+//
+// All times are on the input::now() clock. Main thread only.
+//
+// Compiled in with FP_LATENCY (on in Debug builds). Without it every
+// function is an empty inline and nothing is written.
+//
+
+#ifndef LATENCY_HPP
+#define LATENCY_HPP
+
+#include "AEEngine.h"
+
+#ifndef FP_LATENCY
+#ifdef _DEBUG
+#define FP_LATENCY 1
+#else
+#define FP_LATENCY 0
+#endif
+#endif
+
+namespace latency
+{
+    enum Stage
+    {
+        kQueue,         // input -> arrived
+        kSimulate,      // arrived -> consumed
+        kRender,        // consumed -> drawn
+        kPresent,       // drawn -> presented
+        kTotal,         // input -> presented
+        kStageCount
+    };
+
+#if FP_LATENCY
+    // The simulation consumed a press of key (any press at or before upTo)
+    // on the given tick. A press is only sampled once.
+    void consumed(u8 key, f64 upTo, u32 tick);
+
+    // Frame boundaries, around AESysFrameEnd().
+    void frameDrawn();
+    void framePresented();
+
+    // Completed samples so far.
+    u32 count();
+
+    // Prints and appends to latency.log; does nothing without samples.
+    void report();
+    void reset();
+#else
+    inline void consumed(u8, f64, u32) {}
+    inline void frameDrawn() {}
+    inline void framePresented() {}
+    inline u32 count() { return 0; }
+    inline void report() {}
+    inline void reset() {}
+#endif
+}
+
+#endif // LATENCY_HPP
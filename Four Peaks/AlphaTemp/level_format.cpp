@@ -0,0 +1,786 @@
+// ---------------------------------------------------------------------------
+// level_format.cpp
+// ---------------------------------------------------------------------------
+//
+// Text source format (one directive per line, '#' starts a comment):
+//
+//   name   Summer Stage 1
+//   season summer            (spring | summer | autumn | winter | blackout)
+//   stage  1
+//   size   32 20             (cols rows)
+//   spawn  player 3 2        (type col row [param]), type = player|coin|goal|light
+//   layer  solid             (solid | background | foreground)
+//   ....1111..222.....       <- exactly `rows` lines, TOP row first
+//   end
+//
+// Tile characters: '.' or '0' = 0 (empty), '1'..'9' = tile id, 'a'..'z' = 10..35.
+// ---------------------------------------------------------------------------
+
+#include "level_format.hpp"
+#include "mapped_file.hpp"
+#include "tilemap.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace game
+{
+    namespace
+    {
+        // PackBits control byte:
+        //   0..127   -> copy the next (c + 1) bytes literally
+        //   129..255 -> repeat the next byte (257 - c) times (2..128)
+        //   128      -> unused
+        const size_t kMaxLiteral = 128;
+        const size_t kMaxRun = 128;
+
+        bool checkRange(size_t offset, size_t size, size_t total)
+        {
+            return offset <= total && size <= total - offset;
+        }
+
+        bool parseTileChar(char ch, u8& tile)
+        {
+            if (ch == '.')              { tile = 0; return true; }
+            if (ch >= '0' && ch <= '9') { tile = static_cast<u8>(ch - '0'); return true; }
+            if (ch >= 'a' && ch <= 'z') { tile = static_cast<u8>(10 + ch - 'a'); return true; }
+            return false;
+        }
+
+        bool parseSeason(const std::string& s, Season& out)
+        {
+            if (s == "spring") { out = Season::Spring; return true; }
+            if (s == "summer") { out = Season::Summer; return true; }
+            if (s == "autumn") { out = Season::Autumn; return true; }
+            if (s == "winter") { out = Season::Winter; return true; }
+            if (s == "blackout") { out = Season::Blackout; return true; }
+            return false;
+        }
+
+        bool parseLayerKind(const std::string& s, LevelLayerKind& out)
+        {
+            if (s == "solid")      { out = LevelLayerKind::Solid; return true; }
+            if (s == "background") { out = LevelLayerKind::Background; return true; }
+            if (s == "foreground") { out = LevelLayerKind::Foreground; return true; }
+            return false;
+        }
+
+        bool parseSpawnType(const std::string& s, SpawnType& out)
+        {
+            if (s == "player") { out = SpawnType::Player; return true; }
+            if (s == "coin")   { out = SpawnType::Coin; return true; }
+            if (s == "goal")   { out = SpawnType::Goal; return true; }
+            if (s == "light")  { out = SpawnType::Light; return true; }
+            return false;
+        }
+
+        std::string trim(const std::string& s)
+        {
+            size_t b = s.find_first_not_of(" \t\r");
+            if (b == std::string::npos) return std::string();
+            size_t e = s.find_last_not_of(" \t\r");
+            return s.substr(b, e - b + 1);
+        }
+    }
+
+    // ===================================================================
+    // RLE
+    // ===================================================================
+
+    void rleEncode(const u8* src, size_t srcSize, std::vector<u8>& out)
+    {
+        size_t i = 0;
+        while (i < srcSize)
+        {
+            // Measure the run starting at i.
+            size_t run = 1;
+            while (i + run < srcSize && run < kMaxRun && src[i + run] == src[i])
+                ++run;
+
+            if (run >= 2)
+            {
+                out.push_back(static_cast<u8>(257 - run));
+                out.push_back(src[i]);
+                i += run;
+                continue;
+            }
+
+            // Literal block: extend until the next run of 2+ or the block limit.
+            size_t start = i;
+            size_t count = 0;
+            while (i < srcSize && count < kMaxLiteral)
+            {
+                if (i + 1 < srcSize && src[i + 1] == src[i])
+                    break;
+                ++i;
+                ++count;
+            }
+
+            out.push_back(static_cast<u8>(count - 1));
+            out.insert(out.end(), src + start, src + start + count);
+        }
+    }
+
+    namespace
+    {
+        // Walks a PackBits stream, handing each run / literal block to the
+        // sinks. Returns false on malformed input or if the stream does not
+        // produce exactly dstSize bytes.
+        template <typename RunSink, typename LiteralSink>
+        bool walkRle(const u8* src, size_t srcSize, size_t dstSize,
+            RunSink onRun, LiteralSink onLiteral)
+        {
+            size_t in = 0;
+            size_t outPos = 0;
+
+            while (in < srcSize)
+            {
+                u8 c = src[in++];
+                if (c < 128)
+                {
+                    size_t count = static_cast<size_t>(c) + 1;
+                    if (in + count > srcSize || outPos + count > dstSize)
+                        return false;
+                    onLiteral(outPos, src + in, count);
+                    in += count;
+                    outPos += count;
+                }
+                else if (c > 128)
+                {
+                    size_t count = 257 - static_cast<size_t>(c);
+                    if (in >= srcSize || outPos + count > dstSize)
+                        return false;
+                    onRun(outPos, src[in++], count);
+                    outPos += count;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return outPos == dstSize;
+        }
+    }
+
+    bool rleDecode(const u8* src, size_t srcSize, u8* dst, size_t dstSize)
+    {
+        return walkRle(src, srcSize, dstSize,
+            [dst](size_t at, u8 value, size_t count) { std::memset(dst + at, value, count); },
+            [dst](size_t at, const u8* bytes, size_t count) { std::memcpy(dst + at, bytes, count); });
+    }
+
+    // ===================================================================
+    // LevelFile
+    // ===================================================================
+
+    LevelFile::LevelFile()
+        : base(nullptr)
+        , total(0)
+        , hdr{}
+    {
+    }
+
+    // -------------------------------------------------------------------
+    // open
+    // -------------------------------------------------------------------
+    bool LevelFile::open(const char* path)
+    {
+        close();
+
+        if (!vfs::open(path, file))
+            return false;
+
+        base = file.data();
+        total = file.size();
+        return validate();
+    }
+
+    bool LevelFile::openMemory(std::vector<u8> bytes)
+    {
+        close();
+
+        memory.swap(bytes);
+        base = memory.data();
+        total = memory.size();
+        return !memory.empty() && validate();
+    }
+
+    // -------------------------------------------------------------------
+    // validate
+    // -------------------------------------------------------------------
+    bool LevelFile::validate()
+    {
+        if (total < sizeof(LevelFileHeader))
+        {
+            close();
+            return false;
+        }
+
+        std::memcpy(&hdr, base, sizeof(hdr));
+
+        if (std::memcmp(hdr.magic, kLevelMagic, sizeof(kLevelMagic)) != 0 ||
+            hdr.version < kLevelMinVersion || hdr.version > kLevelVersion ||
+            hdr.cols == 0 || hdr.rows == 0)
+        {
+            close();
+            return false;
+        }
+
+        size_t tablesSize = hdr.layerCount * sizeof(LevelLayerEntry) +
+            hdr.spawnCount * sizeof(LevelSpawn);
+        if (!checkRange(sizeof(LevelFileHeader), tablesSize, total))
+        {
+            close();
+            return false;
+        }
+
+        const size_t tileCount = static_cast<size_t>(hdr.cols) * hdr.rows;
+        const size_t chunkCount = static_cast<size_t>(chunkCols()) * chunkRows();
+
+        for (int i = 0; i < hdr.layerCount; ++i)
+        {
+            LevelLayerEntry e = layer(i);
+            bool ok = checkRange(e.offset, e.packedSize, total) && e.rawSize == tileCount;
+
+            if (ok && e.compression == static_cast<u8>(LevelCompression::Chunked))
+            {
+                // v2 only: the chunk table and every blob must be in range.
+                ok = hdr.version >= 2 && e.packedSize >= chunkCount * sizeof(LevelChunkEntry);
+                for (int cy = 0; ok && cy < chunkRows(); ++cy)
+                {
+                    for (int cx = 0; ok && cx < chunkCols(); ++cx)
+                    {
+                        LevelChunkEntry c{};
+                        chunkEntry(i, cx, cy, c);
+                        ok = checkRange(c.offset, c.packedSize, total);
+                    }
+                }
+            }
+
+            if (!ok)
+            {
+                close();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void LevelFile::close()
+    {
+        file.close();
+        memory.clear();
+        base = nullptr;
+        total = 0;
+        hdr = LevelFileHeader{};
+    }
+
+    LevelLayerEntry LevelFile::layer(int index) const
+    {
+        LevelLayerEntry e{};
+        std::memcpy(&e, base + sizeof(LevelFileHeader) + index * sizeof(LevelLayerEntry), sizeof(e));
+        return e;
+    }
+
+    int LevelFile::findLayer(LevelLayerKind kind) const
+    {
+        for (int i = 0; i < hdr.layerCount; ++i)
+        {
+            if (layer(i).kind == static_cast<u8>(kind))
+                return i;
+        }
+        return -1;
+    }
+
+    LevelSpawn LevelFile::spawn(int index) const
+    {
+        LevelSpawn s{};
+        const size_t offset = sizeof(LevelFileHeader) +
+            hdr.layerCount * sizeof(LevelLayerEntry) +
+            index * sizeof(LevelSpawn);
+        std::memcpy(&s, base + offset, sizeof(s));
+        return s;
+    }
+
+    int LevelFile::chunkCols() const
+    {
+        return (hdr.cols + TileMap::kChunkMask) >> TileMap::kChunkShift;
+    }
+
+    int LevelFile::chunkRows() const
+    {
+        return (hdr.rows + TileMap::kChunkMask) >> TileMap::kChunkShift;
+    }
+
+    bool LevelFile::chunkEntry(int index, int cx, int cy, LevelChunkEntry& out) const
+    {
+        if (cx < 0 || cy < 0 || cx >= chunkCols() || cy >= chunkRows())
+            return false;
+
+        LevelLayerEntry e = layer(index);
+        const size_t slot = static_cast<size_t>(cy) * chunkCols() + cx;
+        std::memcpy(&out, base + e.offset + slot * sizeof(LevelChunkEntry), sizeof(out));
+        return true;
+    }
+
+    bool LevelFile::isChunked(int index) const
+    {
+        return isOpen() && index >= 0 && index < hdr.layerCount &&
+            layer(index).compression == static_cast<u8>(LevelCompression::Chunked);
+    }
+
+    bool LevelFile::chunkIsEmpty(int index, int cx, int cy) const
+    {
+        LevelChunkEntry c{};
+        return !isChunked(index) || !chunkEntry(index, cx, cy, c) || c.packedSize == 0;
+    }
+
+    // -------------------------------------------------------------------
+    // decodeChunk
+    // -------------------------------------------------------------------
+    bool LevelFile::decodeChunk(int index, int cx, int cy, u8* dst) const
+    {
+        LevelChunkEntry c{};
+        if (!isChunked(index) || !chunkEntry(index, cx, cy, c))
+            return false;
+
+        if (c.packedSize == 0)
+        {
+            std::memset(dst, 0, TileMap::kChunkTiles);
+            return true;
+        }
+
+        const u8* payload = base + c.offset;
+        switch (static_cast<LevelCompression>(c.compression))
+        {
+        case LevelCompression::Raw:
+            if (c.packedSize != TileMap::kChunkTiles)
+                return false;
+            std::memcpy(dst, payload, TileMap::kChunkTiles);
+            return true;
+
+        case LevelCompression::Rle:
+            return rleDecode(payload, c.packedSize, dst, TileMap::kChunkTiles);
+
+        default:
+            return false;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // decodeLayer
+    // -------------------------------------------------------------------
+    bool LevelFile::decodeLayer(int index, u8* dst, size_t dstSize) const
+    {
+        if (!isOpen() || index < 0 || index >= hdr.layerCount)
+            return false;
+
+        LevelLayerEntry e = layer(index);
+        if (dstSize != e.rawSize)
+            return false;
+
+        const u8* payload = base + e.offset;
+
+        switch (static_cast<LevelCompression>(e.compression))
+        {
+        case LevelCompression::Chunked:
+        {
+            // Reassemble the flat grid chunk by chunk, clipping edge padding.
+            u8 tiles[TileMap::kChunkTiles];
+            for (int cy = 0; cy < chunkRows(); ++cy)
+            {
+                for (int cx = 0; cx < chunkCols(); ++cx)
+                {
+                    if (!decodeChunk(index, cx, cy, tiles))
+                        return false;
+
+                    const int col0 = cx << TileMap::kChunkShift;
+                    const int row0 = cy << TileMap::kChunkShift;
+                    const int w = hdr.cols - col0 < TileMap::kChunkSize ? hdr.cols - col0 : TileMap::kChunkSize;
+                    const int h = hdr.rows - row0 < TileMap::kChunkSize ? hdr.rows - row0 : TileMap::kChunkSize;
+
+                    for (int ly = 0; ly < h; ++ly)
+                    {
+                        std::memcpy(dst + static_cast<size_t>(row0 + ly) * hdr.cols + col0,
+                            tiles + (ly << TileMap::kChunkShift), w);
+                    }
+                }
+            }
+            return true;
+        }
+
+        case LevelCompression::Raw:
+            if (e.packedSize != e.rawSize)
+                return false;
+            std::memcpy(dst, payload, dstSize);
+            return true;
+
+        case LevelCompression::Rle:
+            return rleDecode(payload, e.packedSize, dst, dstSize);
+
+        default:
+            return false;
+        }
+    }
+
+    bool LevelFile::decodeLayer(int index, TileMap& dst) const
+    {
+        if (!isOpen() || index < 0 || index >= hdr.layerCount)
+            return false;
+
+        LevelLayerEntry e = layer(index);
+        const u8* payload = base + e.offset;
+
+        dst.resize(hdr.cols, hdr.rows);
+
+        switch (static_cast<LevelCompression>(e.compression))
+        {
+        case LevelCompression::Chunked:
+        {
+            u8 tiles[TileMap::kChunkTiles];
+            for (int cy = 0; cy < chunkRows(); ++cy)
+            {
+                for (int cx = 0; cx < chunkCols(); ++cx)
+                {
+                    if (chunkIsEmpty(index, cx, cy))
+                        continue;
+                    if (!decodeChunk(index, cx, cy, tiles))
+                        return false;
+                    dst.installChunk(cx, cy, tiles);
+                }
+            }
+            return true;
+        }
+
+        case LevelCompression::Raw:
+            if (e.packedSize != e.rawSize)
+                return false;
+            dst.writeLinear(0, payload, e.rawSize);
+            return true;
+
+        case LevelCompression::Rle:
+            return walkRle(payload, e.packedSize, e.rawSize,
+                [&dst](size_t at, u8 value, size_t count) { dst.fillLinear(at, value, count); },
+                [&dst](size_t at, const u8* bytes, size_t count) { dst.writeLinear(at, bytes, count); });
+
+        default:
+            return false;
+        }
+    }
+
+    // ===================================================================
+    // Converter
+    // ===================================================================
+
+    // -------------------------------------------------------------------
+    // parseLevelText
+    // -------------------------------------------------------------------
+    bool parseLevelText(const std::string& text, LevelSource& out, std::string& error)
+    {
+        out = LevelSource{};
+        out.season = Season::Summer;
+        out.stage = 1;
+
+        std::istringstream in(text);
+        std::string line;
+        int lineNo = 0;
+
+        auto fail = [&](const std::string& msg)
+        {
+            error = "line " + std::to_string(lineNo) + ": " + msg;
+            return false;
+        };
+
+        while (std::getline(in, line))
+        {
+            ++lineNo;
+            line = trim(line);
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream words(line);
+            std::string key;
+            words >> key;
+
+            if (key == "name")
+            {
+                std::getline(words, out.name);
+                out.name = trim(out.name);
+            }
+            else if (key == "season")
+            {
+                std::string s;
+                words >> s;
+                if (!parseSeason(s, out.season))
+                    return fail("unknown season '" + s + "'");
+            }
+            else if (key == "stage")
+            {
+                if (!(words >> out.stage) || out.stage < 1 || out.stage > 255)
+                    return fail("bad stage number");
+            }
+            else if (key == "size")
+            {
+                // Layers and spawns are checked against the first one.
+                if (out.cols > 0 || !out.layers.empty())
+                    return fail("size declared twice");
+                if (!(words >> out.cols >> out.rows) ||
+                    out.cols <= 0 || out.rows <= 0 || out.cols > 0xFFFF || out.rows > 0xFFFF)
+                    return fail("bad size");
+            }
+            else if (key == "spawn")
+            {
+                std::string type;
+                int col = 0, row = 0, param = 0;
+                if (!(words >> type >> col >> row))
+                    return fail("spawn needs: type col row [param]");
+                words >> param;
+
+                LevelSpawn s{};
+                SpawnType st;
+                if (!parseSpawnType(type, st))
+                    return fail("unknown spawn type '" + type + "'");
+                if (col < 0 || row < 0 || col >= out.cols || row >= out.rows)
+                    return fail("spawn outside the level (declare size first)");
+                if (param < 0 || param > 0xFFFF)
+                    return fail("bad spawn param");
+                if (st == SpawnType::Light && param > 15)
+                    return fail("light strength above 15");
+
+                s.type = static_cast<u16>(st);
+                s.col = static_cast<u16>(col);
+                s.row = static_cast<u16>(row);
+                s.param = static_cast<u16>(param);
+                out.spawns.push_back(s);
+            }
+            else if (key == "layer")
+            {
+                if (out.cols <= 0)
+                    return fail("declare size before the first layer");
+
+                std::string kindName;
+                words >> kindName;
+
+                LevelSource::Layer layer;
+                if (!parseLayerKind(kindName, layer.kind))
+                    return fail("unknown layer kind '" + kindName + "'");
+                layer.tiles.assign(static_cast<size_t>(out.cols) * out.rows, 0);
+
+                // Rows are written top first; store bottom first.
+                for (int r = out.rows - 1; r >= 0; --r)
+                {
+                    if (!std::getline(in, line))
+                        return fail("layer '" + kindName + "' ends early");
+                    ++lineNo;
+                    line = trim(line);
+
+                    if (static_cast<int>(line.size()) != out.cols)
+                        return fail("row has " + std::to_string(line.size()) +
+                            " tiles, expected " + std::to_string(out.cols));
+
+                    for (int c = 0; c < out.cols; ++c)
+                    {
+                        u8 tile = 0;
+                        if (!parseTileChar(line[c], tile))
+                            return fail(std::string("bad tile character '") + line[c] + "'");
+                        layer.tiles[static_cast<size_t>(r) * out.cols + c] = tile;
+                    }
+                }
+
+                if (!std::getline(in, line) || trim(line) != "end")
+                    return fail("expected 'end' after layer rows");
+                ++lineNo;
+
+                out.layers.push_back(layer);
+            }
+            else
+            {
+                return fail("unknown directive '" + key + "'");
+            }
+        }
+
+        if (out.layers.empty())
+            return fail("level has no layers");
+
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // buildLevelImage
+    // -------------------------------------------------------------------
+    void buildLevelImage(const LevelSource& level, std::vector<u8>& image)
+    {
+        LevelFileHeader hdr{};
+        std::memcpy(hdr.magic, kLevelMagic, sizeof(kLevelMagic));
+        hdr.version = kLevelVersion;
+        hdr.layerCount = static_cast<u16>(level.layers.size());
+        hdr.cols = static_cast<u16>(level.cols);
+        hdr.rows = static_cast<u16>(level.rows);
+        hdr.spawnCount = static_cast<u16>(level.spawns.size());
+        hdr.season = static_cast<u8>(level.season);
+        hdr.stage = static_cast<u8>(level.stage);
+        // Truncated; hdr is zeroed, so the name stays terminated.
+        const size_t nameLen = level.name.size() < sizeof(hdr.name) - 1 ? level.name.size() : sizeof(hdr.name) - 1;
+        std::memcpy(hdr.name, level.name.data(), nameLen);
+
+        // Split each layer into TileMap chunks and compress every chunk on
+        // its own, keeping whichever encoding is smaller.
+        const int chunkCols = (level.cols + TileMap::kChunkMask) >> TileMap::kChunkShift;
+        const int chunkRows = (level.rows + TileMap::kChunkMask) >> TileMap::kChunkShift;
+        const size_t tableSize = static_cast<size_t>(chunkCols) * chunkRows * sizeof(LevelChunkEntry);
+
+        std::vector<LevelLayerEntry> entries;
+        std::vector<std::vector<u8>> payloads;
+
+        u32 offset = static_cast<u32>(sizeof(LevelFileHeader) +
+            level.layers.size() * sizeof(LevelLayerEntry) +
+            level.spawns.size() * sizeof(LevelSpawn));
+
+        for (const LevelSource::Layer& layer : level.layers)
+        {
+            std::vector<LevelChunkEntry> table(static_cast<size_t>(chunkCols) * chunkRows);
+            std::vector<u8> blobs;
+            u32 blobBase = static_cast<u32>(offset + tableSize);
+
+            for (int cy = 0; cy < chunkRows; ++cy)
+            {
+                for (int cx = 0; cx < chunkCols; ++cx)
+                {
+                    u8 tiles[TileMap::kChunkTiles] = {};
+                    bool empty = true;
+
+                    for (int ly = 0; ly < TileMap::kChunkSize; ++ly)
+                    {
+                        const int row = (cy << TileMap::kChunkShift) + ly;
+                        if (row >= level.rows)
+                            break;
+                        for (int lx = 0; lx < TileMap::kChunkSize; ++lx)
+                        {
+                            const int col = (cx << TileMap::kChunkShift) + lx;
+                            if (col >= level.cols)
+                                break;
+                            u8 t = layer.tiles[static_cast<size_t>(row) * level.cols + col];
+                            tiles[(ly << TileMap::kChunkShift) | lx] = t;
+                            empty = empty && t == 0;
+                        }
+                    }
+
+                    LevelChunkEntry& c = table[static_cast<size_t>(cy) * chunkCols + cx];
+                    if (empty)
+                        continue;
+
+                    std::vector<u8> packed;
+                    rleEncode(tiles, sizeof(tiles), packed);
+
+                    c.offset = blobBase + static_cast<u32>(blobs.size());
+                    if (packed.size() < sizeof(tiles))
+                    {
+                        c.compression = static_cast<u8>(LevelCompression::Rle);
+                        c.packedSize = static_cast<u16>(packed.size());
+                        blobs.insert(blobs.end(), packed.begin(), packed.end());
+                    }
+                    else
+                    {
+                        c.compression = static_cast<u8>(LevelCompression::Raw);
+                        c.packedSize = static_cast<u16>(sizeof(tiles));
+                        blobs.insert(blobs.end(), tiles, tiles + sizeof(tiles));
+                    }
+                }
+            }
+
+            std::vector<u8> payload(tableSize);
+            std::memcpy(payload.data(), table.data(), tableSize);
+            payload.insert(payload.end(), blobs.begin(), blobs.end());
+
+            LevelLayerEntry e{};
+            e.kind = static_cast<u8>(layer.kind);
+            e.compression = static_cast<u8>(LevelCompression::Chunked);
+            e.rawSize = static_cast<u32>(layer.tiles.size());
+            e.offset = offset;
+            e.packedSize = static_cast<u32>(payload.size());
+            offset += e.packedSize;
+
+            entries.push_back(e);
+            payloads.push_back(payload);
+        }
+
+        image.clear();
+        image.resize(sizeof(hdr));
+        std::memcpy(image.data(), &hdr, sizeof(hdr));
+
+        auto append = [&image](const void* p, size_t n)
+        {
+            const u8* bytes = static_cast<const u8*>(p);
+            image.insert(image.end(), bytes, bytes + n);
+        };
+
+        for (const LevelLayerEntry& e : entries)
+            append(&e, sizeof(e));
+        for (const LevelSpawn& s : level.spawns)
+            append(&s, sizeof(s));
+        for (const std::vector<u8>& p : payloads)
+            append(p.data(), p.size());
+    }
+
+    // -------------------------------------------------------------------
+    // writeLevelFile
+    // -------------------------------------------------------------------
+    bool writeLevelFile(const LevelSource& level, const char* path, std::string& error)
+    {
+        std::vector<u8> image;
+        buildLevelImage(level, image);
+
+        // Write beside the target and rename over it, so a running game never
+        // reads a half-written file; one that has the old file mapped keeps
+        // reading the old contents until it reloads.
+        const std::string temp = std::string(path) + ".tmp";
+        {
+            std::ofstream out(temp.c_str(), std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                error = std::string("cannot write ") + temp;
+                return false;
+            }
+
+            out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+            if (!out)
+            {
+                error = std::string("write failed: ") + temp;
+                return false;
+            }
+        }
+
+        if (!replaceFile(temp.c_str(), path))
+        {
+            std::remove(temp.c_str());
+            error = std::string("cannot replace ") + path + " (is it open?)";
+            return false;
+        }
+        return true;
+    }
+
+    bool convertLevelText(const char* srcPath, const char* dstPath, std::string& error)
+    {
+        std::ifstream in(srcPath, std::ios::binary);
+        if (!in)
+        {
+            error = std::string("cannot read ") + srcPath;
+            return false;
+        }
+
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+
+        LevelSource level;
+        if (!parseLevelText(buffer.str(), level, error))
+        {
+            error = std::string(srcPath) + ": " + error;
+            return false;
+        }
+
+        return writeLevelFile(level, dstPath, error);
+    }
+}
@@ -0,0 +1,207 @@
+// ---------------------------------------------------------------------------
+// level_format.hpp
+// ---------------------------------------------------------------------------
+//
+// Versioned binary level format (.lvl) plus the text source converter.
+//
+// File layout (little-endian, every offset is from the start of the file):
+//
+//   LevelFileHeader
+//   LevelLayerEntry[layerCount]
+//   LevelSpawn[spawnCount]
+//   layer payloads        (see LevelLayerEntry)
+//
+// Tiles are one byte each, row-major, row 0 = bottom row of the level
+// (same convention as SummerS1's grid).
+//
+// Version 1 stores each layer as one raw or PackBits RLE blob.
+// Version 2 stores each layer as a LevelChunkEntry table (one per 32x32
+// TileMap chunk, chunk rows bottom first) followed by the chunk blobs, so a
+// single chunk can be decoded on its own for streaming. Edge chunks are
+// padded with empty tiles. The loader reads both versions.
+//
+// Runtime side: LevelFile maps the file and decodes a layer straight into the
+// caller's tile storage. Tool side: parseLevelText / writeLevelFile turn the
+// human-editable .txt source into a .lvl (see Tools/levelconv).
+//
+
+#ifndef LEVEL_FORMAT_HPP
+#define LEVEL_FORMAT_HPP
+
+#include "vfs.hpp"
+#include <AETypes.h>   // u8, u16, u32
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    class TileMap;
+
+    static const char kLevelMagic[4] = { 'F', 'P', 'L', 'V' };
+    static const u16  kLevelVersion = 2;       // written by the converter
+    static const u16  kLevelMinVersion = 1;    // oldest version still loaded
+
+    enum class LevelLayerKind : u8
+    {
+        Solid = 0,      // collision + main tiles
+        Background = 1, // decoration behind the player
+        Foreground = 2  // decoration in front of the player
+    };
+
+    enum class LevelCompression : u8
+    {
+        Raw = 0,
+        Rle = 1,        // PackBits style runs
+        Chunked = 2     // layer payload is a LevelChunkEntry table (v2)
+    };
+
+    enum class Season : u8
+    {
+        Spring = 0,
+        Summer = 1,
+        Autumn = 2,
+        Winter = 3,
+        Blackout = 4    // dark, and only what the player can see is drawn
+    };
+
+    enum class SpawnType : u16
+    {
+        Player = 0,
+        Coin = 1,
+        Goal = 2,
+        Light = 3       // param = strength 1..15 (0 = full); any light makes the level dark
+    };
+
+    struct LevelFileHeader
+    {
+        char magic[4];      // "FPLV"
+        u16  version;
+        u16  layerCount;
+        u16  cols;
+        u16  rows;
+        u16  spawnCount;
+        u8   season;        // Season
+        u8   stage;         // 1-based stage number within the season
+        char name[32];      // zero padded display name
+    };
+
+    struct LevelLayerEntry
+    {
+        u8  kind;           // LevelLayerKind
+        u8  compression;    // LevelCompression
+        u16 reserved;
+        u32 offset;         // payload offset
+        u32 packedSize;     // payload size in the file
+        u32 rawSize;        // decoded size (always cols * rows)
+    };
+
+    struct LevelChunkEntry
+    {
+        u32 offset;         // chunk blob offset (0 when the chunk is empty)
+        u16 packedSize;     // 0 = all empty tiles
+        u8  compression;    // Raw or Rle, decodes to TileMap::kChunkTiles bytes
+        u8  reserved;
+    };
+
+    struct LevelSpawn
+    {
+        u16 type;           // SpawnType
+        u16 col;
+        u16 row;
+        u16 param;          // type specific (e.g. coin value)
+    };
+
+    static_assert(sizeof(LevelFileHeader) == 48, "LevelFileHeader layout changed");
+    static_assert(sizeof(LevelLayerEntry) == 16, "LevelLayerEntry layout changed");
+    static_assert(sizeof(LevelChunkEntry) == 8, "LevelChunkEntry layout changed");
+    static_assert(sizeof(LevelSpawn) == 8, "LevelSpawn layout changed");
+
+    // -------------------------------------------------------------------
+    // Runtime loader
+    // -------------------------------------------------------------------
+    class LevelFile
+    {
+    public:
+        LevelFile();
+
+        // Opens the file through the VFS (loose or packed) and validates it.
+        // All tables are bounds checked here so the accessors below never
+        // read past the image.
+        bool open(const char* path);
+        // Same, but from an in-memory image (e.g. built by buildLevelImage).
+        bool openMemory(std::vector<u8> bytes);
+        void close();
+        bool isOpen() const { return base != nullptr; }
+
+        const LevelFileHeader& header() const { return hdr; }
+        int cols() const { return hdr.cols; }
+        int rows() const { return hdr.rows; }
+
+        int layerCount() const { return hdr.layerCount; }
+        LevelLayerEntry layer(int index) const;
+        int findLayer(LevelLayerKind kind) const; // -1 if not present
+
+        int spawnCount() const { return hdr.spawnCount; }
+        LevelSpawn spawn(int index) const;
+
+        // Decodes one layer into dst (cols * rows bytes, row 0 first).
+        bool decodeLayer(int index, u8* dst, size_t dstSize) const;
+        // Decodes one layer straight into chunked storage (resizes dst).
+        // Runs of empty tiles are skipped without allocating chunks.
+        bool decodeLayer(int index, TileMap& dst) const;
+
+        // Per-chunk access (v2 files). Safe to call from worker threads: it
+        // only reads the immutable mapping.
+        bool isChunked(int index) const;
+        bool chunkIsEmpty(int index, int cx, int cy) const;
+        // dst must hold TileMap::kChunkTiles bytes (chunk-local rows).
+        bool decodeChunk(int index, int cx, int cy, u8* dst) const;
+
+    private:
+        vfs::File file;
+        std::vector<u8> memory;
+        const u8* base;     // VFS file or memory image
+        size_t total;
+        LevelFileHeader hdr;
+
+        bool validate();
+
+        int chunkCols() const;
+        int chunkRows() const;
+        bool chunkEntry(int index, int cx, int cy, LevelChunkEntry& out) const;
+    };
+
+    // -------------------------------------------------------------------
+    // RLE helpers (shared by loader and converter)
+    // -------------------------------------------------------------------
+    void rleEncode(const u8* src, size_t srcSize, std::vector<u8>& out);
+    bool rleDecode(const u8* src, size_t srcSize, u8* dst, size_t dstSize);
+
+    // -------------------------------------------------------------------
+    // Converter (text source -> .lvl)
+    // -------------------------------------------------------------------
+    struct LevelSource
+    {
+        struct Layer
+        {
+            LevelLayerKind kind;
+            std::vector<u8> tiles; // cols * rows, row 0 = bottom
+        };
+
+        std::string name;
+        Season season;
+        int stage;
+        int cols;
+        int rows;
+        std::vector<Layer> layers;
+        std::vector<LevelSpawn> spawns;
+    };
+
+    bool parseLevelText(const std::string& text, LevelSource& out, std::string& error);
+    void buildLevelImage(const LevelSource& level, std::vector<u8>& image);
+    bool writeLevelFile(const LevelSource& level, const char* path, std::string& error);
+    bool convertLevelText(const char* srcPath, const char* dstPath, std::string& error);
+}
+
+#endif // LEVEL_FORMAT_HPP
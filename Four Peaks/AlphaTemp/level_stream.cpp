@@ -0,0 +1,401 @@
+// ---------------------------------------------------------------------------
+// level_stream.cpp
+// ---------------------------------------------------------------------------
+
+#include "level_stream.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace game
+{
+    namespace
+    {
+        int chebyshev(int ax, int ay, int bx, int by)
+        {
+            int dx = ax > bx ? ax - bx : bx - ax;
+            int dy = ay > by ? ay - by : by - ay;
+            return dx > dy ? dx : dy;
+        }
+
+        f32 signOf(f32 v)
+        {
+            return v > 0.0f ? 1.0f : (v < 0.0f ? -1.0f : 0.0f);
+        }
+    }
+
+    LevelStreamer::LevelStreamer(JobSystem& jobSystem)
+        : layerKind(LevelLayerKind::Solid)
+        , layerIndex(-1)
+        , target(nullptr)
+        , lastCol(0.0f)
+        , lastRow(0.0f)
+        , dirX(0.0f)
+        , dirY(0.0f)
+        , generation(0)
+        , jobs(jobSystem)
+    {
+    }
+
+    LevelStreamer::~LevelStreamer()
+    {
+        close();
+    }
+
+    // -------------------------------------------------------------------
+    // open / close
+    // -------------------------------------------------------------------
+    bool LevelStreamer::open(const char* path, LevelLayerKind kind, TileMap& map)
+    {
+        close();
+
+        std::shared_ptr<LevelFile> file(new LevelFile());
+        if (!file->open(path))
+            return false;
+
+        const int index = file->findLayer(kind);
+        if (!file->isChunked(index))
+            return false;
+
+        level = file;
+        layerKind = kind;
+        layerIndex = index;
+        target = &map;
+        map.resize(level->cols(), level->rows());
+        states.assign(static_cast<size_t>(map.chunkCols()) * map.chunkRows(), ChunkState::Unloaded);
+        residentList.clear();
+        dirX = dirY = 0.0f;
+        return true;
+    }
+
+    void LevelStreamer::close()
+    {
+        stopDecoding();
+
+        states.clear();
+        residentList.clear();
+        target = nullptr;
+        layerIndex = -1;
+        level.reset();
+    }
+
+    void LevelStreamer::stopDecoding()
+    {
+        // Jobs still queued find nothing to do; wait for the ones decoding.
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            requests.clear();
+        }
+        jobs.wait(inFlight);
+
+        std::lock_guard<std::mutex> guard(lock);
+        ++generation;
+        results.clear();
+        freeResults.clear();
+    }
+
+    // -------------------------------------------------------------------
+    // reload
+    // -------------------------------------------------------------------
+    bool LevelStreamer::reload(std::shared_ptr<LevelFile> fresh)
+    {
+        if (!target || !fresh)
+            return false;
+
+        const int layer = fresh->findLayer(layerKind);
+        if (!fresh->isChunked(layer))
+            return false;
+
+        // Decode jobs read `level` unlocked, so let them finish first.
+        stopDecoding();
+
+        // Anything still queued will be requested again from the new file.
+        for (ChunkState& st : states)
+        {
+            if (st == ChunkState::Queued)
+                st = ChunkState::Unloaded;
+        }
+
+        const bool sameSize = fresh->cols() == level->cols() && fresh->rows() == level->rows();
+        level = fresh;
+        layerIndex = layer;
+
+        if (!sameSize)
+        {
+            target->resize(level->cols(), level->rows());
+            states.assign(static_cast<size_t>(target->chunkCols()) * target->chunkRows(), ChunkState::Unloaded);
+            residentList.clear();
+            prime(lastCol, lastRow);
+            return true;
+        }
+
+        u8 tiles[TileMap::kChunkTiles];
+        for (int slot : residentList)
+        {
+            const int cx = slot % target->chunkCols();
+            const int cy = slot / target->chunkCols();
+            if (level->decodeChunk(layerIndex, cx, cy, tiles))
+                target->updateChunk(cx, cy, tiles);
+        }
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // decodeNext - one job per request; takes the nearest one still queued
+    // -------------------------------------------------------------------
+    void LevelStreamer::decodeNext()
+    {
+        Request req{};
+        std::unique_ptr<Result> out;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (requests.empty())
+                return;     // cancelled
+
+            req = requests.front();
+            requests.pop_front();
+
+            if (!freeResults.empty())
+            {
+                out = std::move(freeResults.back());
+                freeResults.pop_back();
+            }
+        }
+
+        if (!out)
+            out.reset(new Result());
+
+        // The mapping is read-only, so decoding needs no lock.
+        out->cx = req.cx;
+        out->cy = req.cy;
+        out->generation = req.generation;
+        out->ok = level->decodeChunk(layerIndex, req.cx, req.cy, out->tiles);
+
+        std::lock_guard<std::mutex> guard(lock);
+        results.push_back(std::move(out));
+    }
+
+    // -------------------------------------------------------------------
+    // install / evict
+    // -------------------------------------------------------------------
+    void LevelStreamer::install(int cx, int cy, const u8* tiles)
+    {
+        const int index = chunkIndex(cx, cy);
+        if (states[index] != ChunkState::Resident)
+            residentList.push_back(index);
+        states[index] = ChunkState::Resident;
+
+        if (tiles)
+            target->installChunk(cx, cy, tiles);
+    }
+
+    void LevelStreamer::evict(int cx, int cy)
+    {
+        const int index = chunkIndex(cx, cy);
+        states[index] = ChunkState::Unloaded;
+
+        std::vector<int>::iterator it = std::find(residentList.begin(), residentList.end(), index);
+        if (it != residentList.end())
+        {
+            *it = residentList.back();
+            residentList.pop_back();
+        }
+
+        if (target->chunk(cx, cy))
+        {
+            target->releaseChunk(cx, cy);
+            if (onEvict)
+                onEvict(cx, cy);
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // prime
+    // -------------------------------------------------------------------
+    void LevelStreamer::prime(f32 camCol, f32 camRow)
+    {
+        if (!target)
+            return;
+
+        lastCol = camCol;
+        lastRow = camRow;
+
+        const int centerX = static_cast<int>(std::floor(camCol)) >> TileMap::kChunkShift;
+        const int centerY = static_cast<int>(std::floor(camRow)) >> TileMap::kChunkShift;
+        const int r = settings.prefetchRadius;
+
+        u8 tiles[TileMap::kChunkTiles];
+        for (int cy = centerY - r; cy <= centerY + r; ++cy)
+        {
+            for (int cx = centerX - r; cx <= centerX + r; ++cx)
+            {
+                if (cx < 0 || cy < 0 || cx >= target->chunkCols() || cy >= target->chunkRows())
+                    continue;
+                if (states[chunkIndex(cx, cy)] == ChunkState::Resident)
+                    continue;
+
+                if (level->chunkIsEmpty(layerIndex, cx, cy))
+                    install(cx, cy, nullptr);
+                else if (level->decodeChunk(layerIndex, cx, cy, tiles))
+                    install(cx, cy, tiles);
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // update
+    // -------------------------------------------------------------------
+    void LevelStreamer::update(f32 camCol, f32 camRow)
+    {
+        if (!target)
+            return;
+
+        // Smoothed direction of travel (per axis, -1..1).
+        dirX = dirX * 0.75f + signOf(camCol - lastCol) * 0.25f;
+        dirY = dirY * 0.75f + signOf(camRow - lastRow) * 0.25f;
+        lastCol = camCol;
+        lastRow = camRow;
+
+        const int centerX = static_cast<int>(std::floor(camCol)) >> TileMap::kChunkShift;
+        const int centerY = static_cast<int>(std::floor(camRow)) >> TileMap::kChunkShift;
+        const f32 aheadX = centerX + 0.5f + dirX * settings.lookAhead;
+        const f32 aheadY = centerY + 0.5f + dirY * settings.lookAhead;
+
+        integrateResults();
+        requestChunks(centerX, centerY, aheadX, aheadY);
+        evictChunks(centerX, centerY);
+    }
+
+    void LevelStreamer::integrateResults()
+    {
+        std::vector<std::unique_ptr<Result>> done;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            done.swap(results);
+        }
+
+        for (std::unique_ptr<Result>& r : done)
+        {
+            const int index = chunkIndex(r->cx, r->cy);
+
+            // Drop results for chunks that were cancelled or reopened.
+            if (r->generation == generation && r->ok && states[index] == ChunkState::Queued)
+                install(r->cx, r->cy, r->tiles);
+            else if (states[index] == ChunkState::Queued)
+                states[index] = ChunkState::Unloaded;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        for (std::unique_ptr<Result>& r : done)
+            freeResults.push_back(std::move(r));
+    }
+
+    void LevelStreamer::requestChunks(int centerX, int centerY, f32 aheadX, f32 aheadY)
+    {
+        const int keep = settings.prefetchRadius + settings.lookAhead + settings.evictMargin;
+
+        // Candidate area: the radius box stretched toward the look-ahead point.
+        const int r = settings.prefetchRadius;
+        const int ax = static_cast<int>(std::floor(aheadX));
+        const int ay = static_cast<int>(std::floor(aheadY));
+        const int minX = std::max(0, std::min(centerX, ax) - r);
+        const int maxX = std::min(target->chunkCols() - 1, std::max(centerX, ax) + r);
+        const int minY = std::max(0, std::min(centerY, ay) - r);
+        const int maxY = std::min(target->chunkRows() - 1, std::max(centerY, ay) + r);
+
+        struct Candidate { int cx, cy; f32 dist; };
+        std::vector<Candidate> wanted;
+
+        for (int cy = minY; cy <= maxY; ++cy)
+        {
+            for (int cx = minX; cx <= maxX; ++cx)
+            {
+                if (states[chunkIndex(cx, cy)] != ChunkState::Unloaded)
+                    continue;
+
+                // Empty chunks never need decoding.
+                if (level->chunkIsEmpty(layerIndex, cx, cy))
+                {
+                    install(cx, cy, nullptr);
+                    continue;
+                }
+
+                f32 dx = cx + 0.5f - aheadX;
+                f32 dy = cy + 0.5f - aheadY;
+                wanted.push_back({ cx, cy, dx * dx + dy * dy });
+            }
+        }
+
+        std::sort(wanted.begin(), wanted.end(),
+            [](const Candidate& a, const Candidate& b) { return a.dist < b.dist; });
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            // Cancel queued work that fell out of range before it ran.
+            for (std::deque<Request>::iterator it = requests.begin(); it != requests.end();)
+            {
+                if (chebyshev(it->cx, it->cy, centerX, centerY) > keep)
+                {
+                    states[chunkIndex(it->cx, it->cy)] = ChunkState::Unloaded;
+                    it = requests.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            for (const Candidate& c : wanted)
+            {
+                states[chunkIndex(c.cx, c.cy)] = ChunkState::Queued;
+                requests.push_back({ c.cx, c.cy, generation });
+            }
+        }
+
+        for (size_t i = 0; i < wanted.size(); ++i)
+            jobs.run([this]() { decodeNext(); }, &inFlight);
+    }
+
+    void LevelStreamer::evictChunks(int centerX, int centerY)
+    {
+        const int keep = settings.prefetchRadius + settings.lookAhead + settings.evictMargin;
+
+        // Far away: always evicted.
+        for (size_t i = 0; i < residentList.size();)
+        {
+            const int cx = residentList[i] % target->chunkCols();
+            const int cy = residentList[i] / target->chunkCols();
+            if (chebyshev(cx, cy, centerX, centerY) > keep)
+                evict(cx, cy); // swap-removes entry i
+            else
+                ++i;
+        }
+
+        // Over budget: farthest first, never inside the prefetch radius.
+        while (residentBytes() > settings.memoryBudget)
+        {
+            int best = -1;
+            int bestDist = settings.prefetchRadius;
+            for (int index : residentList)
+            {
+                const int cx = index % target->chunkCols();
+                const int cy = index / target->chunkCols();
+                const int d = chebyshev(cx, cy, centerX, centerY);
+                if (d > bestDist && target->chunk(cx, cy))
+                {
+                    best = index;
+                    bestDist = d;
+                }
+            }
+
+            if (best < 0)
+                break;
+            evict(best % target->chunkCols(), best / target->chunkCols());
+        }
+    }
+
+    size_t LevelStreamer::residentBytes() const
+    {
+        return residentChunks() * (sizeof(TileMap::Chunk) + settings.bakedBytesPerChunk);
+    }
+}
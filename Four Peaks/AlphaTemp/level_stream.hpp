@@ -0,0 +1,131 @@
+// ---------------------------------------------------------------------------
+// level_stream.hpp
+// ---------------------------------------------------------------------------
+//
+// Pages TileMap chunks in and out around the camera.
+//
+// Chunks are decoded from the mapped .lvl (v2, chunked layers) as jobs on
+// the JobSystem, several at once and nearest first, while the game keeps
+// running; finished chunks are installed into the TileMap on the main thread
+// in update(), so the TileMap itself is never touched off the main thread.
+//
+// Each update():
+//   - requests every chunk within `prefetchRadius` of the camera chunk, plus
+//     `lookAhead` extra chunks in the direction the camera is moving,
+//     nearest-to-the-look-ahead-point first;
+//   - evicts resident chunks beyond `prefetchRadius + evictMargin`, and then
+//     the farthest ones while over `memoryBudget`;
+//   - calls the evict callback so owners can drop baked meshes / colliders.
+//
+
+#ifndef LEVEL_STREAM_HPP
+#define LEVEL_STREAM_HPP
+
+#include "job_system.hpp"
+#include "level_format.hpp"
+#include "tilemap.hpp"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace game
+{
+    struct StreamSettings
+    {
+        int    prefetchRadius = 2;          // chunks kept around the camera
+        int    lookAhead = 2;               // extra chunks ahead of travel
+        int    evictMargin = 1;             // hysteresis before eviction
+        size_t memoryBudget = 4u << 20;     // bytes for resident chunks
+        size_t bakedBytesPerChunk = 48u << 10; // estimate for mesh + colliders
+    };
+
+    class LevelStreamer
+    {
+    public:
+        typedef std::function<void(int cx, int cy)> EvictCallback;
+
+        explicit LevelStreamer(JobSystem& jobSystem);
+        ~LevelStreamer();
+        LevelStreamer(const LevelStreamer&) = delete;
+        LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+        // Maps the level and sizes `map`. The layer must
+        // be chunked (v2 file). `map` must outlive the streamer or close().
+        bool open(const char* path, LevelLayerKind kind, TileMap& map);
+        void close();
+        bool isOpen() const { return target != nullptr; }
+
+        const LevelFile& file() const { return *level; }
+
+        // Swaps in a new version of the same level (hot reload). Resident
+        // chunks are re-decoded and only the ones that changed are
+        // reinstalled (and so re-baked); if the size changed, everything is
+        // reloaded around the last camera position.
+        bool reload(std::shared_ptr<LevelFile> fresh);
+
+        void setSettings(const StreamSettings& s) { settings = s; }
+        const StreamSettings& getSettings() const { return settings; }
+        void setEvictCallback(EvictCallback cb) { onEvict = cb; }
+
+        // Synchronously loads everything around a tile position (used on
+        // level start so the first frame is never missing ground).
+        void prime(f32 camCol, f32 camRow);
+
+        // Main thread, once per frame. Camera position in tile units.
+        void update(f32 camCol, f32 camRow);
+
+        size_t residentBytes() const;
+        size_t residentChunks() const { return target ? target->allocatedChunks() : 0; }
+
+    private:
+        enum class ChunkState : u8 { Unloaded, Queued, Resident };
+
+        struct Request
+        {
+            int cx, cy;
+            u32 generation;
+        };
+
+        struct Result
+        {
+            int cx, cy;
+            u32 generation;
+            bool ok;
+            u8 tiles[TileMap::kChunkTiles];
+        };
+
+        std::shared_ptr<LevelFile> level;
+        LevelLayerKind layerKind;
+        int layerIndex;
+        TileMap* target;
+        StreamSettings settings;
+        EvictCallback onEvict;
+
+        std::vector<ChunkState> states;
+        std::vector<int> residentList;  // chunk indices currently Resident
+        f32 lastCol, lastRow;
+        f32 dirX, dirY;            // smoothed direction of travel
+        u32 generation;            // bumps on open/close to drop stale results
+
+        // decode jobs
+        JobSystem& jobs;
+        JobCounter inFlight;
+        std::mutex lock;
+        std::deque<Request> requests;                      // nearest first
+        std::vector<std::unique_ptr<Result>> results;     // jobs -> main
+        std::vector<std::unique_ptr<Result>> freeResults; // recycled buffers
+
+        void stopDecoding();
+        void decodeNext();
+        void integrateResults();
+        void requestChunks(int centerX, int centerY, f32 aheadX, f32 aheadY);
+        void evictChunks(int centerX, int centerY);
+        void install(int cx, int cy, const u8* tiles);
+        void evict(int cx, int cy);
+        int chunkIndex(int cx, int cy) const { return cy * target->chunkCols() + cx; }
+    };
+}
+
+#endif // LEVEL_STREAM_HPP
@@ -0,0 +1,536 @@
+// ---------------------------------------------------------------------------
+// light_map.cpp
+// ---------------------------------------------------------------------------
+
+#include "light_map.hpp"
+#include "graphics.hpp"
+#include "visibility.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace game
+{
+    namespace
+    {
+        const int kBorder = 1;      // texels of the neighbouring chunks
+        const int kTextureSize = TileMap::kChunkSize + 2 * kBorder;
+
+        // Each level down dims by this much; level 0 is the ambient floor.
+        const f32 kFalloff = 0.8f;
+
+        const int kStepCol[4] = { -1, 1, 0, 0 };
+        const int kStepRow[4] = { 0, 0, -1, 1 };
+
+        int clampInt(int v, int lo, int hi)
+        {
+            return v < lo ? lo : (v > hi ? hi : v);
+        }
+    }
+
+    LightMap::LightMap()
+        : cols(0)
+        , rows(0)
+        , chunkCols(0)
+        , chunkRows(0)
+        , ambientTexture(nullptr)
+        , mesh(nullptr)
+    {
+        std::memset(shade, 0, sizeof(shade));
+        setAmbient(0.08f);
+    }
+
+    LightMap::~LightMap()
+    {
+        clear();
+    }
+
+    void LightMap::setAmbient(f32 brightness)
+    {
+        u8 next[kMaxLight + 1];
+        for (int l = 0; l <= kMaxLight; ++l)
+        {
+            const f32 curve = l == 0 ? 0.0f : std::pow(kFalloff, static_cast<f32>(kMaxLight - l));
+            const f32 v = brightness + (1.0f - brightness) * curve;
+            next[l] = static_cast<u8>(clampInt(static_cast<int>(v * 255.0f + 0.5f), 0, 255));
+        }
+
+        bool changed = false;
+        for (int l = 0; l <= kMaxLight; ++l)
+        {
+            changed = changed || next[l] != shade[l];
+            shade[l] = next[l];
+        }
+
+        // Every texel changes; re-upload on the next frame.
+        if (changed)
+        {
+            if (ambientTexture)
+            {
+                AEGfxTextureUnload(ambientTexture);
+                ambientTexture = nullptr;
+            }
+            chunkDirty.assign(chunkDirty.size(), 1);
+        }
+    }
+
+    void LightMap::reset(const TileMap& map)
+    {
+        const bool resized = chunkCols != map.chunkCols() || chunkRows != map.chunkRows();
+        if (resized)
+            freeTextures();
+
+        cols = map.cols();
+        rows = map.rows();
+        chunkCols = map.chunkCols();
+        chunkRows = map.chunkRows();
+
+        const size_t tiles = static_cast<size_t>(cols) * rows;
+        levels.assign(tiles, 0);
+        solid.assign(tiles, 0);
+        sources.assign(tiles, 0);
+        lights.clear();
+
+        // Only allocated chunks can hold solid tiles.
+        for (int cy = 0; cy < chunkRows; ++cy)
+        {
+            for (int cx = 0; cx < chunkCols; ++cx)
+            {
+                const TileMap::Chunk* chunk = map.chunk(cx, cy);
+                if (!chunk)
+                    continue;
+
+                for (int ly = 0; ly < TileMap::kChunkSize; ++ly)
+                {
+                    const int row = (cy << TileMap::kChunkShift) + ly;
+                    for (int lx = 0; lx < TileMap::kChunkSize; ++lx)
+                    {
+                        const int col = (cx << TileMap::kChunkShift) + lx;
+                        if (col < cols && row < rows)
+                            solid[index(col, row)] = chunk->tiles[(ly << TileMap::kChunkShift) | lx] != 0;
+                    }
+                }
+            }
+        }
+
+        const size_t chunks = static_cast<size_t>(chunkCols) * chunkRows;
+        chunkDirty.assign(chunks, 1);
+        textures.resize(chunks, nullptr);
+    }
+
+    void LightMap::freeTextures()
+    {
+        for (AEGfxTexture*& tex : textures)
+        {
+            if (tex)
+            {
+                AEGfxTextureUnload(tex);
+                tex = nullptr;
+            }
+        }
+        textures.clear();
+    }
+
+    void LightMap::clear()
+    {
+        freeTextures();
+        if (ambientTexture)
+        {
+            AEGfxTextureUnload(ambientTexture);
+            ambientTexture = nullptr;
+        }
+        if (mesh)
+        {
+            AEGfxMeshFree(mesh);
+            mesh = nullptr;
+        }
+
+        cols = rows = 0;
+        chunkCols = chunkRows = 0;
+        levels.clear();
+        solid.clear();
+        sources.clear();
+        lights.clear();
+        chunkDirty.clear();
+    }
+
+    u8 LightMap::level(int col, int row) const
+    {
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return 0;
+        return levels[index(col, row)];
+    }
+
+    // -------------------------------------------------------------------
+    // flood fill
+    // -------------------------------------------------------------------
+    void LightMap::touch(int col, int row)
+    {
+        // The border texels put a tile in up to four chunk textures.
+        const int cx0 = clampInt((col - kBorder) >> TileMap::kChunkShift, 0, chunkCols - 1);
+        const int cx1 = clampInt((col + kBorder) >> TileMap::kChunkShift, 0, chunkCols - 1);
+        const int cy0 = clampInt((row - kBorder) >> TileMap::kChunkShift, 0, chunkRows - 1);
+        const int cy1 = clampInt((row + kBorder) >> TileMap::kChunkShift, 0, chunkRows - 1);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx)
+                chunkDirty[cy * chunkCols + cx] = 1;
+    }
+
+    void LightMap::raise(int col, int row, u8 to)
+    {
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return;
+
+        const u32 i = index(col, row);
+        if (levels[i] >= to)
+            return;
+
+        levels[i] = to;
+        touch(col, row);
+        increase.push_back(i);
+    }
+
+    void LightMap::flood()
+    {
+        // Breadth first, so every tile is settled the first time it's
+        // reached from its brightest side.
+        for (size_t head = 0; head < increase.size(); ++head)
+        {
+            const u32 i = increase[head];
+            const u8 l = levels[i];
+            if (l <= 1 || !spreads(i))
+                continue;
+
+            const int col = static_cast<int>(i % cols);
+            const int row = static_cast<int>(i / cols);
+            for (int k = 0; k < 4; ++k)
+                raise(col + kStepCol[k], row + kStepRow[k], static_cast<u8>(l - 1));
+        }
+        increase.clear();
+    }
+
+    void LightMap::unlight(u32 seed)
+    {
+        // Darken everything that got its light through `seed`: a neighbour
+        // dimmer than the tile it was reached from is downstream and goes
+        // dark too; a brighter (or equal) one is lit from elsewhere and
+        // becomes an edge to refill from.
+        removal.push_back(Removal{ seed, levels[seed] });
+        levels[seed] = 0;
+        touch(static_cast<int>(seed % cols), static_cast<int>(seed / cols));
+        if (sources[seed])
+            reseed.push_back(seed);
+
+        for (size_t head = 0; head < removal.size(); ++head)
+        {
+            const Removal r = removal[head];
+
+            // A wall tile lit nothing itself, but may still be lit from
+            // another side. (The seed may have just turned solid; its old
+            // light still has to go.)
+            const bool cascade = head == 0 || spreads(r.index);
+
+            const int col = static_cast<int>(r.index % cols);
+            const int row = static_cast<int>(r.index / cols);
+            for (int k = 0; k < 4; ++k)
+            {
+                const int c = col + kStepCol[k];
+                const int w = row + kStepRow[k];
+                if (c < 0 || w < 0 || c >= cols || w >= rows)
+                    continue;
+
+                const u32 j = index(c, w);
+                const u8 l = levels[j];
+                if (l == 0)
+                    continue;
+
+                if (cascade && l < r.level)
+                {
+                    levels[j] = 0;
+                    touch(c, w);
+                    removal.push_back(Removal{ j, l });
+                    if (sources[j])
+                        reseed.push_back(j);
+                }
+                else
+                {
+                    increase.push_back(j);
+                }
+            }
+        }
+
+        // Emitters inside the cleared area light themselves again.
+        for (u32 j : reseed)
+        {
+            if (sources[j] > levels[j])
+            {
+                levels[j] = sources[j];
+                increase.push_back(j);
+            }
+        }
+
+        removal.clear();
+        reseed.clear();
+        flood();
+    }
+
+    void LightMap::placeSource(int col, int row, int strength)
+    {
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return;
+
+        // A light in a wall makes it spread what it already receives too.
+        const u32 i = index(col, row);
+        const bool spread = spreads(i);
+        if (strength > sources[i])
+            sources[i] = static_cast<u8>(strength);
+        if (strength > levels[i])
+        {
+            levels[i] = static_cast<u8>(strength);
+            touch(col, row);
+        }
+        else if (spread)
+        {
+            return;
+        }
+        increase.push_back(i);
+        flood();
+    }
+
+    void LightMap::liftSource(int col, int row, int strength)
+    {
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return;
+
+        // Another emitter may share the tile.
+        const u32 i = index(col, row);
+        const bool spread = spreads(i);
+        int strongest = 0;
+        for (const Light& light : lights)
+        {
+            if (light.strength > strongest && light.col == col && light.row == row)
+                strongest = light.strength;
+        }
+        sources[i] = static_cast<u8>(strongest);
+
+        // Brighter than this light already: it didn't reach anything,
+        // unless it was what let a wall pass its light on.
+        if (levels[i] <= strength || spread != spreads(i))
+            unlight(i);
+    }
+
+    void LightMap::setSolid(int col, int row, bool isSolid)
+    {
+        const u32 i = index(col, row);
+        if ((solid[i] != 0) == isSolid)
+            return;
+
+        const bool spread = spreads(i);
+        solid[i] = isSolid ? 1 : 0;
+        if (spread == spreads(i))
+            return;
+
+        // A wall going up takes back what passed through it (and is lit
+        // again from its neighbours); one coming down lets its light on.
+        if (isSolid)
+        {
+            unlight(i);
+        }
+        else
+        {
+            increase.push_back(i);
+            flood();
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // lights
+    // -------------------------------------------------------------------
+    int LightMap::addLight(int col, int row, int strength)
+    {
+        strength = clampInt(strength, 1, kMaxLight);
+
+        size_t slot = 0;
+        while (slot < lights.size() && lights[slot].strength != 0)
+            ++slot;
+        if (slot == lights.size())
+            lights.push_back(Light{});
+
+        lights[slot] = Light{ col, row, strength };
+        placeSource(col, row, strength);
+        return static_cast<int>(slot) + 1;
+    }
+
+    void LightMap::moveLight(int id, int col, int row)
+    {
+        if (id <= 0 || id > static_cast<int>(lights.size()) || lights[id - 1].strength == 0)
+            return;
+
+        Light& light = lights[id - 1];
+        if (light.col == col && light.row == row)
+            return;
+
+        const Light old = light;
+        light.col = col;
+        light.row = row;
+        liftSource(old.col, old.row, old.strength);
+        placeSource(col, row, light.strength);
+    }
+
+    void LightMap::setStrength(int id, int strength)
+    {
+        if (id <= 0 || id > static_cast<int>(lights.size()) || lights[id - 1].strength == 0)
+            return;
+
+        Light& light = lights[id - 1];
+        strength = clampInt(strength, 1, kMaxLight);
+        const int old = light.strength;
+        light.strength = strength;
+        if (strength > old)
+            placeSource(light.col, light.row, strength);
+        else if (strength < old)
+            liftSource(light.col, light.row, old);
+    }
+
+    void LightMap::removeLight(int id)
+    {
+        if (id <= 0 || id > static_cast<int>(lights.size()) || lights[id - 1].strength == 0)
+            return;
+
+        Light& light = lights[id - 1];
+        const int old = light.strength;
+        light.strength = 0;
+        liftSource(light.col, light.row, old);
+    }
+
+    // -------------------------------------------------------------------
+    // sync
+    // -------------------------------------------------------------------
+    void LightMap::sync(TileMap& map)
+    {
+        // A resized map needs a reset() first.
+        if (empty() || map.cols() != cols || map.rows() != rows)
+            return;
+
+        for (int cy = 0; cy < chunkRows; ++cy)
+        {
+            for (int cx = 0; cx < chunkCols; ++cx)
+            {
+                if (!(map.dirtyFlags(cx, cy) & TileMap::DirtyLight))
+                    continue;
+                map.clearDirty(cx, cy, TileMap::DirtyLight);
+
+                // Streamed-out chunks read as air.
+                const TileMap::Chunk* chunk = map.chunk(cx, cy);
+                for (int ly = 0; ly < TileMap::kChunkSize; ++ly)
+                {
+                    const int row = (cy << TileMap::kChunkShift) + ly;
+                    for (int lx = 0; lx < TileMap::kChunkSize; ++lx)
+                    {
+                        const int col = (cx << TileMap::kChunkShift) + lx;
+                        if (col >= cols || row >= rows)
+                            continue;
+
+                        const u8 tile = chunk ? chunk->tiles[(ly << TileMap::kChunkShift) | lx] : 0;
+                        setSolid(col, row, tile != 0);
+                    }
+                }
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // upload - main thread
+    // -------------------------------------------------------------------
+    void LightMap::upload(const Visibility* visibility)
+    {
+        if (empty())
+            return;
+
+        if (!mesh)
+        {
+            // Texel centres on tile centres: skip the border texels.
+            const f32 t0 = static_cast<f32>(kBorder) / kTextureSize;
+            const f32 t1 = 1.0f - t0;
+            mesh = gfx::buildSpriteMesh(0.0f, 0.0f, 1.0f, 1.0f, t0, t0, t1, t1);
+        }
+        if (!ambientTexture)
+        {
+            u8 texel[4] = { shade[0], shade[0], shade[0], 0xFF };
+            ambientTexture = AEGfxTextureLoadFromMemory(texel, 1, 1);
+        }
+
+        texels.resize(static_cast<size_t>(kTextureSize) * kTextureSize * 4);
+        for (int cy = 0; cy < chunkRows; ++cy)
+        {
+            for (int cx = 0; cx < chunkCols; ++cx)
+            {
+                const int k = cy * chunkCols + cx;
+                if (!chunkDirty[k] && !(visibility && visibility->chunkChanged(cx, cy)))
+                    continue;
+                chunkDirty[k] = 0;
+
+                // Texture rows run top down; tiles past the level edge
+                // repeat the edge.
+                bool flat = true;
+                u8* out = texels.data();
+                for (int ty = 0; ty < kTextureSize; ++ty)
+                {
+                    const int ly = TileMap::kChunkSize - ty;
+                    const int row = clampInt((cy << TileMap::kChunkShift) + ly, 0, rows - 1);
+                    for (int tx = 0; tx < kTextureSize; ++tx)
+                    {
+                        const int col = clampInt((cx << TileMap::kChunkShift) + tx - kBorder, 0, cols - 1);
+                        const bool seen = !visibility || visibility->visible(col, row);
+                        const u8 v = seen ? shade[levels[index(col, row)]] : 0;
+                        flat = flat && v == shade[0];
+
+                        *out++ = v;
+                        *out++ = v;
+                        *out++ = v;
+                        *out++ = 0xFF;
+                    }
+                }
+
+                if (textures[k])
+                {
+                    AEGfxTextureUnload(textures[k]);
+                    textures[k] = nullptr;
+                }
+                if (!flat)
+                    textures[k] = AEGfxTextureLoadFromMemory(texels.data(), kTextureSize, kTextureSize);
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // draw
+    // -------------------------------------------------------------------
+    void LightMap::draw(f32 originX, f32 originY, f32 cellW, f32 cellH, s32 layer,
+        const Visibility* visibility) const
+    {
+        if (!mesh)
+            return;
+
+        const f32 chunkW = cellW * TileMap::kChunkSize;
+        const f32 chunkH = cellH * TileMap::kChunkSize;
+
+        for (int cy = 0; cy < chunkRows; ++cy)
+        {
+            for (int cx = 0; cx < chunkCols; ++cx)
+            {
+                if (visibility && !visibility->chunkVisible(cx, cy))
+                    continue;
+
+                AEGfxTexture* tex = textures[cy * chunkCols + cx];
+                if (!tex)
+                    tex = ambientTexture;
+                if (!tex)
+                    continue;
+
+                const gfx::Vec2 corner{ originX + cx * chunkW, originY + cy * chunkH };
+                const gfx::Mat2x3 m = gfx::Mat2x3::trs(corner, 0.0f, gfx::Vec2{ chunkW, chunkH });
+                gfx::submit(gfx::Material{ tex, 0, 1.0f, gfx::Opacity::Multiplied }, mesh, m, layer);
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+// ---------------------------------------------------------------------------
+// light_map.hpp
+// ---------------------------------------------------------------------------
+//
+// Tile-grid lighting for dark stages.
+//
+// Each tile holds a light level 0..kMaxLight. Emitters flood-fill outwards,
+// losing one level per tile; solid tiles are lit but stop the spread, so
+// light stays inside rooms and bends around corners. A tile keeps the
+// brightest light that reaches it.
+//
+// Updates are incremental: adding a light only floods its own radius, and
+// moving, dimming or removing one (or a tile turning solid / empty) first
+// clears the area that light reached, then refills it from the brighter
+// edges around it. Nothing outside that area is touched, so a torch that
+// moves a tile costs a few hundred tile visits whatever the level size.
+//
+// The levels are drawn as one low-res texture per 32x32 chunk (a texel per
+// tile plus a one-texel border for filtering), multiplied over everything
+// drawn below kLayerLighting. Only chunks whose levels changed are
+// re-uploaded; chunks with no light share one ambient texel. With a
+// Visibility mask, tiles out of sight are black.
+//
+
+#ifndef LIGHT_MAP_HPP
+#define LIGHT_MAP_HPP
+
+#include "AEEngine.h"
+#include "render_queue.hpp"
+#include "tilemap.hpp"
+#include <vector>
+
+namespace game
+{
+    class Visibility;
+
+    class LightMap
+    {
+    public:
+        static const int kMaxLight = 15;
+
+        LightMap();
+        ~LightMap();
+        LightMap(const LightMap&) = delete;
+        LightMap& operator=(const LightMap&) = delete;
+
+        // Brightness of an unlit tile, 0..1.
+        void setAmbient(f32 brightness);
+
+        // Sizes to the map, reads which tiles are solid and drops every
+        // light. Textures are kept until the next upload().
+        void reset(const TileMap& map);
+        // Frees the textures too (level unload).
+        void clear();
+        bool empty() const { return cols == 0; }
+
+        // Handles are > 0. Strength is clamped to 1..kMaxLight.
+        int addLight(int col, int row, int strength);
+        void moveLight(int id, int col, int row);
+        void setStrength(int id, int strength);
+        void removeLight(int id);
+
+        // Picks up tiles edited since the last call (chunks flagged
+        // DirtyLight) and clears the flag.
+        void sync(TileMap& map);
+
+        u8 level(int col, int row) const;
+
+        // Re-uploads the textures of chunks whose light (or visibility)
+        // changed. Tiles `visibility` hides come out black. Main thread,
+        // once per frame before draw().
+        void upload(const Visibility* visibility = nullptr);
+
+        // Queues the light over the level. originX/Y = world position of
+        // tile (0,0)'s bottom-left corner. Chunks with nothing visible are
+        // skipped (their tiles aren't drawn either).
+        void draw(f32 originX, f32 originY, f32 cellW, f32 cellH, s32 layer = gfx::kLayerLighting,
+            const Visibility* visibility = nullptr) const;
+
+    private:
+        struct Light
+        {
+            int col, row;
+            int strength;       // 0 = free slot
+        };
+
+        struct Removal
+        {
+            u32 index;
+            u8 level;
+        };
+
+        int cols;
+        int rows;
+        int chunkCols;
+        int chunkRows;
+
+        std::vector<u8> levels;     // cols * rows, row 0 = bottom
+        std::vector<u8> solid;      // 1 = blocks the spread
+        std::vector<u8> sources;    // strongest emitter on the tile
+        std::vector<Light> lights;  // handle = index + 1
+
+        std::vector<u32> increase;  // flood queues, reused
+        std::vector<Removal> removal;
+        std::vector<u32> reseed;
+
+        std::vector<u8> chunkDirty;
+        std::vector<AEGfxTexture*> textures;    // per chunk; nullptr = ambient
+        AEGfxTexture* ambientTexture;
+        AEGfxVertexList* mesh;                  // unit quad, border texels cut off
+        u8 shade[kMaxLight + 1];                // level -> texel value
+        std::vector<u8> texels;                 // upload scratch
+
+        u32 index(int col, int row) const { return static_cast<u32>(row * cols + col); }
+        bool spreads(u32 i) const { return !solid[i] || sources[i] > 0; }
+        void touch(int col, int row);
+        void raise(int col, int row, u8 to);
+
+        void flood();
+        void unlight(u32 seed);
+        void placeSource(int col, int row, int strength);
+        void liftSource(int col, int row, int strength);
+        void setSolid(int col, int row, bool isSolid);
+
+        void freeTextures();
+    };
+}
+
+#endif // LIGHT_MAP_HPP
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------------------
+// loading_screen.cpp
+// ---------------------------------------------------------------------------
+
+#include "loading_screen.hpp"
+#include "AEEngine.h"
+#include "boot_timer.hpp"
+#include "graphics.hpp"
+
+extern s8 gFontId;      // Font handle shared by all states (main.cpp)
+
+namespace game
+{
+    // Main thread upload slice while loading, and the in-game default.
+    static const f64 kLoadingBudget = 0.012;
+    static const f64 kDefaultBudget = 0.002;
+
+    // Progress bar, in world units (screen centred).
+    static const f32 kBarWidth = 800.0f;
+    static const f32 kBarHeight = 24.0f;
+    static const f32 kBarY = -120.0f;
+
+    LoadingScreen::LoadingScreen(StateId nextState, const ResourceRequest& uiFont)
+        : next(nextState)
+        , font(uiFont)
+        , readyCount(0)
+        , done(false)
+    {
+    }
+
+    void LoadingScreen::also(StateId id)
+    {
+        extra.push_back(id);
+    }
+
+    // -------------------------------------------------------------------
+    // LoadingScreen::enter
+    // -------------------------------------------------------------------
+    void LoadingScreen::enter()
+    {
+        boot::mark("first frame");
+
+        states().setUploadBudget(kLoadingBudget);
+
+        tracked.clear();
+        tracked.push_back(font);
+
+        // Queue everything up front so the pool works on all of it at once.
+        states().preload(next);
+        const std::vector<ResourceRequest>& first = states().declared(next);
+        tracked.insert(tracked.end(), first.begin(), first.end());
+
+        for (StateId id : extra)
+        {
+            states().preload(id);
+            const std::vector<ResourceRequest>& r = states().declared(id);
+            tracked.insert(tracked.end(), r.begin(), r.end());
+        }
+
+        readyCount = 0;
+        done = false;
+    }
+
+    // -------------------------------------------------------------------
+    // LoadingScreen::exit
+    // -------------------------------------------------------------------
+    void LoadingScreen::exit()
+    {
+        states().setUploadBudget(kDefaultBudget);
+
+        // The next state is entered in this same update, so this is the
+        // first interactive frame.
+        boot::mark("assets resident");
+        boot::report();
+    }
+
+    // -------------------------------------------------------------------
+    // LoadingScreen::update
+    // -------------------------------------------------------------------
+    void LoadingScreen::update(float dt)
+    {
+        (void)dt;
+
+        readyCount = resources().readyCount(tracked);
+        if (done || readyCount < tracked.size())
+            return;
+
+        done = true;
+        gFontId = resources().font(font.id, font.param);
+        states().change(next);
+    }
+
+    // -------------------------------------------------------------------
+    // LoadingScreen::draw
+    // -------------------------------------------------------------------
+    void LoadingScreen::draw() const
+    {
+        AEGfxSetBackgroundColor(0.05f, 0.05f, 0.2f);
+
+        const f32 progress = tracked.empty() ? 1.0f :
+            static_cast<f32>(readyCount) / static_cast<f32>(tracked.size());
+
+        gfx::drawRectangle(gfx::Vec2{ 0.0f, kBarY }, 0.0f,
+            gfx::Vec2{ kBarWidth + 8.0f, kBarHeight + 8.0f }, 0xFF303050);
+
+        if (progress > 0.0f)
+        {
+            const f32 w = kBarWidth * progress;
+            gfx::drawRectangle(gfx::Vec2{ -kBarWidth * 0.5f + w * 0.5f, kBarY }, 0.0f,
+                gfx::Vec2{ w, kBarHeight }, 0xFFFFFF00);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+// ---------------------------------------------------------------------------
+// loading_screen.hpp
+// ---------------------------------------------------------------------------
+//
+// First state on boot. Has no resources of its own, so it is up on the very
+// first frame; enter() preloads the next state (and any others added with
+// also()) plus the shared UI font, all of which load in parallel on the
+// thread pool. Draws a progress bar over the combined request list and
+// changes to the next state once everything is ready.
+//
+// While it is up the main thread spends a larger slice of each frame on GPU
+// uploads, since there is nothing else to do.
+//
+
+#ifndef LOADING_SCREEN_HPP
+#define LOADING_SCREEN_HPP
+
+#include "state_manager.hpp"
+#include <vector>
+
+namespace game
+{
+    class LoadingScreen : public State
+    {
+    public:
+        // The font must be held by the caller for as long as it is used;
+        // gFontId is set from it when loading completes.
+        LoadingScreen(StateId nextState, const ResourceRequest& uiFont);
+
+        // Also preload this state (its preload reference stays in place
+        // until it is entered or cancelled).
+        void also(StateId id);
+
+        void enter() override;
+        void exit() override;
+        void update(float dt) override;
+        void draw() const override;
+
+    private:
+        StateId next;
+        ResourceRequest font;
+        std::vector<StateId> extra;
+        std::vector<ResourceRequest> tracked;   // everything the bar counts
+        size_t readyCount;
+        bool done;
+    };
+}
+
+#endif // LOADING_SCREEN_HPP
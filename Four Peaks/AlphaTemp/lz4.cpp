@@ -0,0 +1,182 @@
+// ---------------------------------------------------------------------------
+// lz4.cpp
+// ---------------------------------------------------------------------------
+//
+// Sequence layout: token (4 bit literal length | 4 bit match length - 4),
+// extra literal length bytes, literals, 2 byte little-endian offset, extra
+// match length bytes. Lengths of 15 continue in following bytes (255 = more).
+// The last sequence is literals only; the last 5 bytes are always literals
+// and no match starts within the last 12 bytes.
+// ---------------------------------------------------------------------------
+
+#include "lz4.hpp"
+#include <cstring>
+
+namespace lz4
+{
+    namespace
+    {
+        const size_t kMinMatch = 4;
+        const size_t kLastLiterals = 5;
+        const size_t kMatchStartLimit = 12;
+        const size_t kMaxOffset = 65535;
+        const int kHashBits = 16;
+
+        u32 read32(const u8* p)
+        {
+            u32 v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        u32 hash4(u32 v)
+        {
+            return (v * 2654435761u) >> (32 - kHashBits);
+        }
+
+        void writeLength(std::vector<u8>& out, size_t len)
+        {
+            while (len >= 255)
+            {
+                out.push_back(255);
+                len -= 255;
+            }
+            out.push_back(static_cast<u8>(len));
+        }
+
+        void emitSequence(std::vector<u8>& out, const u8* literals, size_t litLen,
+            size_t offset, size_t matchLen)
+        {
+            const size_t m = matchLen - kMinMatch;
+            u8 token = static_cast<u8>(((litLen < 15 ? litLen : 15) << 4) | (m < 15 ? m : 15));
+            out.push_back(token);
+
+            if (litLen >= 15)
+                writeLength(out, litLen - 15);
+            out.insert(out.end(), literals, literals + litLen);
+
+            out.push_back(static_cast<u8>(offset & 0xFF));
+            out.push_back(static_cast<u8>(offset >> 8));
+
+            if (m >= 15)
+                writeLength(out, m - 15);
+        }
+
+        void emitLastLiterals(std::vector<u8>& out, const u8* literals, size_t litLen)
+        {
+            out.push_back(static_cast<u8>((litLen < 15 ? litLen : 15) << 4));
+            if (litLen >= 15)
+                writeLength(out, litLen - 15);
+            out.insert(out.end(), literals, literals + litLen);
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // compress - greedy single-probe hash matcher
+    // -------------------------------------------------------------------
+    void compress(const u8* src, size_t srcSize, std::vector<u8>& out)
+    {
+        size_t anchor = 0;
+
+        if (srcSize > kMatchStartLimit)
+        {
+            std::vector<s32> table(static_cast<size_t>(1) << kHashBits, -1);
+            const size_t matchStartEnd = srcSize - kMatchStartLimit;
+            const size_t matchEnd = srcSize - kLastLiterals;
+            size_t ip = 0;
+
+            while (ip < matchStartEnd)
+            {
+                const u32 seq = read32(src + ip);
+                const u32 h = hash4(seq);
+                const s32 ref = table[h];
+                table[h] = static_cast<s32>(ip);
+
+                if (ref < 0 || ip - static_cast<size_t>(ref) > kMaxOffset ||
+                    read32(src + ref) != seq)
+                {
+                    ++ip;
+                    continue;
+                }
+
+                size_t len = kMinMatch;
+                while (ip + len < matchEnd && src[ref + len] == src[ip + len])
+                    ++len;
+
+                emitSequence(out, src + anchor, ip - anchor, ip - static_cast<size_t>(ref), len);
+                ip += len;
+                anchor = ip;
+            }
+        }
+
+        emitLastLiterals(out, src + anchor, srcSize - anchor);
+    }
+
+    // -------------------------------------------------------------------
+    // decompress
+    // -------------------------------------------------------------------
+    bool decompress(const u8* src, size_t srcSize, u8* dst, size_t dstSize)
+    {
+        size_t ip = 0;
+        size_t op = 0;
+
+        while (ip < srcSize)
+        {
+            const u8 token = src[ip++];
+
+            size_t litLen = token >> 4;
+            if (litLen == 15)
+            {
+                u8 b;
+                do
+                {
+                    if (ip >= srcSize)
+                        return false;
+                    b = src[ip++];
+                    litLen += b;
+                } while (b == 255);
+            }
+
+            if (litLen > srcSize - ip || litLen > dstSize - op)
+                return false;
+            std::memcpy(dst + op, src + ip, litLen);
+            ip += litLen;
+            op += litLen;
+
+            if (ip == srcSize)
+                break; // last sequence has no match
+
+            if (srcSize - ip < 2)
+                return false;
+            const size_t offset = static_cast<size_t>(src[ip]) | (static_cast<size_t>(src[ip + 1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > op)
+                return false;
+
+            size_t matchLen = token & 15;
+            if (matchLen == 15)
+            {
+                u8 b;
+                do
+                {
+                    if (ip >= srcSize)
+                        return false;
+                    b = src[ip++];
+                    matchLen += b;
+                } while (b == 255);
+            }
+            matchLen += kMinMatch;
+
+            if (matchLen > dstSize - op)
+                return false;
+
+            // Byte copy: matches may overlap their own output.
+            const u8* from = dst + op - offset;
+            for (size_t i = 0; i < matchLen; ++i)
+                dst[op + i] = from[i];
+            op += matchLen;
+        }
+
+        return op == dstSize;
+    }
+}
@@ -0,0 +1,27 @@
+// ---------------------------------------------------------------------------
+// lz4.hpp
+// ---------------------------------------------------------------------------
+//
+// LZ4 block format (no frame header), compatible with the reference
+// LZ4_compress_default / LZ4_decompress_safe block layout. Used for pack
+// entries: the packer compresses once offline, the game only decompresses.
+//
+
+#ifndef LZ4_HPP
+#define LZ4_HPP
+
+#include <AETypes.h>   // u8
+#include <cstddef>
+#include <vector>
+
+namespace lz4
+{
+    // Appends the compressed block for src to out.
+    void compress(const u8* src, size_t srcSize, std::vector<u8>& out);
+
+    // Decodes a block that must expand to exactly dstSize bytes.
+    // Returns false on malformed or truncated input (never overruns dst).
+    bool decompress(const u8* src, size_t srcSize, u8* dst, size_t dstSize);
+}
+
+#endif // LZ4_HPP
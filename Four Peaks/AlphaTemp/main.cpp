@@ -4,16 +4,34 @@
 
 #include <crtdbg.h>        // To check for memory leaks
 #include "AEEngine.h"
+#include "asset_ids.hpp"
+#include "boot_timer.hpp"
+#include "debug_draw.hpp"
+#include "deferred.hpp"
+#include "frame_pacer.hpp"
 #include "graphics.hpp"    // Graphics helper for shapes and initialization
 #include "player.hpp"
+#include "quality_governor.hpp"
 #include "gamestate.hpp"
-
+#include "hot_reload.hpp"
+#include "input.hpp"
+#include "job_system.hpp"
+#include "latency.hpp"
+#include "vfs.hpp"
+#include "view.hpp"
+
+#include "loading_screen.hpp"
 #include "mainmenu.hpp"
+#include "resource_cache.hpp"
+#include "state_manager.hpp"
 #include "summer_s1.hpp"
 
 // Global font handle used by all states
 s8 gFontId = -1;
 
+// Frame rate the pacer aims for; also the quality governor's budget.
+static const u32 kTargetHz = 60;
+
 // ---------------------------------------------------------------------------
 // main
 // ---------------------------------------------------------------------------
@@ -28,11 +46,31 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     UNREFERENCED_PARAMETER(hPrevInstance);
     UNREFERENCED_PARAMETER(lpCmdLine);
 
-    // Flag to determine if the game should continue running.
-    int gGameRunning = 1;
+    boot::begin();
+
+    // Worker threads for loading, streaming and baking.
+    game::JobSystem jobs;
 
-    // Initialize the Alpha Engine.
-    AESysInit(hInstance, nCmdShow, 1600, 900, 1, 60, false, NULL);
+    // Mount the packed assets while the window and device come up. Without
+    // a pack everything loads loose from the Assets folder; in debug builds
+    // loose files win over the pack. Nothing else touches the VFS until
+    // the wait below.
+    bool packMounted = false;
+    bool manifestLoaded = false;
+    game::JobCounter mountDone;
+    jobs.run([&packMounted, &manifestLoaded]()
+    {
+        packMounted = vfs::mount("Assets.pak");
+        manifestLoaded = packMounted && vfs::loadManifest();
+    }, &mountDone);
+
+    // Initialize the Alpha Engine. AE keeps its own window procedure;
+    // input reads raw input on a thread of its own.
+    input::init();
+    AESysInit(hInstance, nCmdShow, 1600, 900, 1, pacing::kEngineFrameCap, false, NULL);
+    input::start(AESysGetWindowHandle());
+    pacing::init(kTargetHz);
+    quality::setBudget(1.0 / kTargetHz);
 
     // Window title.
     AESysSetWindowTitle("Four Peaks Alpha");
@@ -40,111 +78,108 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     // Reset all system modules once before starting.
     AESysReset();
 
-    // Initialise the graphics helper.
+    // Initialise the graphics helper and the world-to-window mapping.
     gfx::init();
-
-    // Load font once and share it.
-    // Make sure this path points to a valid .ttf in your Assets folder.
-    gFontId = AEGfxCreateFont("Assets/Super Mellow.ttf", 24);
-
-    // Game state objects.
+    view::update();
+    boot::mark("engine init");
+
+    // Watch level / texture files for live edits (debug builds).
+    hotreload::init();
+
+    jobs.wait(mountDone);
+    boot::mark("pack mount");
+    if (!packMounted)
+        PRINT("Assets.pak not found, loading loose assets\n");
+    else if (!manifestLoaded)
+        PRINT("Assets.pak has no asset manifest, rerun assetcook\n");
+
+    // Resources and game states. States declare what they need; the
+    // manager loads it as jobs and switches without resetting the
+    // engine.
+    game::ResourceCache resources(jobs);
+    game::StateManager states(resources);
+
+    // Shared UI font, held for the whole run (gFontId is set from it by
+    // the loading screen).
+    const game::ResourceRequest uiFont = game::ResourceRequest::font(assets::kSuperMellow, 24);
+    resources.acquire(uiFont);
+
+    game::LoadingScreen loading(game::StateId::MainMenu, uiFont);
     game::MainMenu mainMenu;
-    game::SummerS1 summerStage;
+    game::SummerS1 summerStage(jobs);
+    states.add(game::StateId::Loading, loading);
+    states.add(game::StateId::MainMenu, mainMenu);
+    states.add(game::StateId::SummerS1, summerStage);
 
-    // Enumeration for states.
-    enum class GameState
-    {
-        MainMenu,
-        HowToPlay,
-        SummerS1,
-        Exit
-    };
-
-    // Start on the main menu.
-    GameState currentState = GameState::MainMenu;
+    // Boot: load the menu, font and first stage in parallel behind a
+    // progress bar, then show the menu.
+    loading.also(game::StateId::SummerS1);
+    states.change(game::StateId::Loading);
+    boot::mark("state setup");
 
     // Game Loop
     PlayerInit(gGame.player);
-    while (gGameRunning)
+    while (states.running())
     {
 
+        // Sleep until the next frame is due; static screens (menus) wait
+        // for input instead, unless something is still loading.
+        const game::State* top = states.current();
+        pacing::waitForFrame(!top || top->animated() || states.transitionPending() ||
+            resources.pendingCount() > 0 || deferred::pendingCount() > 0);
+        quality::frameBegin();
+
         // Begin frame.
         AESysFrameStart();
+        view::update();
+        input::beginFrame();
 
         f32 dt = (f32)AEFrameRateControllerGetFrameTime();
 
         // Optionally let the window close terminate the game.
         if (AESysDoesWindowExist() == 0)
         {
-            gGameRunning = 0;
+            states.quit();
         }
 
-        // Run current state.
-        int action = 0;
+        // Run current state (and any transition requested last frame).
+        states.update(dt);
+        states.draw();
+        gfx::flushQueue();      // what the state queued: opaque pass, then blended
+        debugdraw::flush(gFontId);
+        latency::frameDrawn();
 
-        switch (currentState)
-        {
-        case GameState::MainMenu:
-        {
-            action = mainMenu.update();
-            mainMenu.draw();
-
-            if (action == 1)
-            {
-                // Go to Summer stage.
-                AESysReset();
-                currentState = GameState::SummerS1;
-            }
-            else if (action == 2)
-            {
-                // Exit selected.
-                gGameRunning = 0;
-            }
-            // action == 3 is reserved for "How To Play".
-        }
-        break;
-
-        case GameState::SummerS1:
-        {
-            // Update and draw the first summer stage.
-            action = summerStage.update(dt);
-            summerStage.draw();
-
-
-
-            if (action == 2)
-            {
-                // Return to main menu from level.
-                AESysReset();
-                currentState = GameState::MainMenu;
-            }
-            else if (action == 3)
-            {
-                // Future: quit from within a level.
-                gGameRunning = 0;
-            }
-        }
-        break;
-
-        default:
-            break;
-        }
+        // Chores (hot reload swaps, evictions, ...) in what's left of the
+        // frame budget.
+        deferred::run(quality::budget() - quality::frameElapsed());
 
         // End frame.
         AESysFrameEnd();
+        latency::framePresented();
+        quality::frameEnd();
     }
 
-    // Clean up font.
-    if (gFontId >= 0)
-    {
-        AEGfxDestroyFont(gFontId);
-        gFontId = -1;
-    }
+    // Exit the active state and free its meshes and textures while the
+    // engine is still alive.
+    states.shutdown();
+    deferred::flush();
+    latency::report();     // FP_LATENCY builds only
+    gFontId = -1;
+    resources.release(uiFont);
+    resources.clear();
+
+    // Stop the file watcher before the assets it points at go away.
+    hotreload::shutdown();
+
+    // Nothing reads from the packs past this point.
+    vfs::unmountAll();
 
     // Shut down graphics helper.
     gfx::shutdown();
 
     // Free all engine resources.
+    pacing::shutdown();
+    input::shutdown();
     AESysExit();
 
     return 0;
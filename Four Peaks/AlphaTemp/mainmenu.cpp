@@ -9,6 +9,7 @@
 
 #include "mainmenu.hpp"
 #include "AEEngine.h"
+#include "input.hpp"
 #include <cstdint>
 
 extern s8 gFontId;      // Font handle created in main.cpp
@@ -48,54 +49,66 @@ namespace game
     {
     }
 
+    // -------------------------------------------------------------------
+    // MainMenu::enter
+    // -------------------------------------------------------------------
+    void MainMenu::enter()
+    {
+        // Play is the likely next step: get the stage loading now so the
+        // switch is instant.
+        states().preload(StateId::SummerS1);
+    }
+
     // -------------------------------------------------------------------
     // MainMenu::update
     // -------------------------------------------------------------------
-    int MainMenu::update()
+    void MainMenu::update(float dt)
     {
+        (void)dt;
+
         // If How To Play is visible, wait for any confirm key to close it.
         if (showHowTo)
         {
-            if (AEInputCheckTriggered(AEVK_RETURN) ||
-                AEInputCheckTriggered(AEVK_SPACE) ||
-                AEInputCheckTriggered(AEVK_ESCAPE))
+            if (input::pressed(AEVK_RETURN) ||
+                input::pressed(AEVK_SPACE) ||
+                input::pressed(AEVK_ESCAPE))
             {
                 showHowTo = false;
             }
-            return 0; // stay on menu
+            return; // stay on menu
         }
 
         // Move selection down.
-        if (AEInputCheckTriggered(AEVK_DOWN))
+        if (input::pressed(AEVK_DOWN))
         {
             selectedIndex = (selectedIndex + 1) % kMenuItemCount;
         }
 
         // Move selection up.
-        if (AEInputCheckTriggered(AEVK_UP))
+        if (input::pressed(AEVK_UP))
         {
             selectedIndex = (selectedIndex + kMenuItemCount - 1) % kMenuItemCount;
         }
 
         // Confirm selection.
-        if (AEInputCheckTriggered(AEVK_RETURN) ||
-            AEInputCheckTriggered(AEVK_SPACE))
+        if (input::pressed(AEVK_RETURN) ||
+            input::pressed(AEVK_SPACE))
         {
             switch (selectedIndex)
             {
             case 0: // Play
-                return 1;
+                states().change(StateId::SummerS1);
+                break;
             case 1: // How To Play (placeholder)
                 showHowTo = true;
-                return 0;
+                break;
             case 2: // Exit
-                return 2;
+                states().quit();
+                break;
             default:
                 break;
             }
         }
-
-        return 0; // no state change
     }
 
     // -------------------------------------------------------------------
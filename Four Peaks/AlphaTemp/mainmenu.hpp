@@ -8,24 +8,26 @@
 //   - How To Play (placeholder)
 //   - Exit
 //
-// update() return codes:
-//   0 = stay on main menu
-//   1 = start SummerS1
-//   2 = exit game
+// Play changes to SummerS1, whose resources are preloaded in the background
+// while the menu is up; Exit quits the game.
 //
 
 #ifndef MAINMENU_HPP
 #define MAINMENU_HPP
 
+#include "state_manager.hpp"
+
 namespace game
 {
-    class MainMenu
+    class MainMenu : public State
     {
     public:
         MainMenu();
 
-        int update();   // handle input
-        void draw() const; // draw menu each frame
+        void enter() override;
+        void update(float dt) override;   // handle input
+        void draw() const override;       // draw menu each frame
+        bool animated() const override { return false; }
 
     private:
         int  selectedIndex; // 0=Play, 1=How To Play, 2=Exit
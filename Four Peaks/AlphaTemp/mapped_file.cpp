@@ -0,0 +1,150 @@
+// ---------------------------------------------------------------------------
+// mapped_file.cpp
+// ---------------------------------------------------------------------------
+
+#include "mapped_file.hpp"
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace game
+{
+    MappedFile::MappedFile()
+        : bytes(nullptr)
+        , length(0)
+        , fileHandle(nullptr)
+        , mapHandle(nullptr)
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    // -------------------------------------------------------------------
+    // open
+    // -------------------------------------------------------------------
+    bool MappedFile::open(const char* path)
+    {
+        close();
+
+#ifdef _WIN32
+        // Shared for delete so levelconv can rename a new version over the
+        // file (or move this one aside) while the game has it mapped.
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle = file;
+        mapHandle = mapping;
+        bytes = static_cast<const uint8_t*>(view);
+        length = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps its own reference
+        if (view == MAP_FAILED)
+            return false;
+
+        bytes = static_cast<const uint8_t*>(view);
+        length = static_cast<size_t>(st.st_size);
+#endif
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // close
+    // -------------------------------------------------------------------
+    void MappedFile::close()
+    {
+        if (!bytes)
+            return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(bytes);
+        CloseHandle(static_cast<HANDLE>(mapHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+#else
+        munmap(const_cast<uint8_t*>(bytes), length);
+#endif
+
+        bytes = nullptr;
+        length = 0;
+        fileHandle = nullptr;
+        mapHandle = nullptr;
+    }
+
+    // -------------------------------------------------------------------
+    // replaceFile
+    // -------------------------------------------------------------------
+    bool replaceFile(const char* temp, const char* path)
+    {
+#ifdef _WIN32
+        // Windows lets a mapped file be renamed but not replaced, so if the
+        // plain replace fails it is moved aside first and deleted once the
+        // game has let go of it.
+        if (MoveFileExA(temp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+            return true;
+
+        // The previous save's copy, normally unmapped by now.
+        const std::string aside = std::string(path) + ".old";
+        DeleteFileA(aside.c_str());
+        if (!MoveFileExA(path, aside.c_str(), 0))
+            return false;
+
+        if (!MoveFileExA(temp, path, MOVEFILE_WRITE_THROUGH))
+        {
+            MoveFileExA(aside.c_str(), path, 0);
+            return false;
+        }
+
+        // Fails while the game still maps it; the next save retries.
+        DeleteFileA(aside.c_str());
+        return true;
+#else
+        return std::rename(temp, path) == 0;
+#endif
+    }
+}
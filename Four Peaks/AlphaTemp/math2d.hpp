@@ -0,0 +1,263 @@
+// ---------------------------------------------------------------------------
+// math2d.hpp
+// ---------------------------------------------------------------------------
+//
+// Header-only 2D math: Vec2, affine Mat2x3 and batch transforms.
+//
+// Everything here is inline so the compiler can fold it into the caller;
+// the AEMtx33* / AEVec2* functions live behind the Alpha_Engine.dll boundary
+// and can't be inlined. Convert to AE types only where an AE call needs them
+// (toAE()).
+//
+// Mat2x3 is row-major with the translation in the last column, the same
+// layout as the top two rows of AEMtx33:
+//
+//   | a  b  tx |
+//   | c  d  ty |
+//
+// The batch transforms have SSE2 (always on for x64) and AVX paths
+// (compiled when __AVX__ is defined, e.g. /arch:AVX2), with a scalar tail.
+//
+
+#ifndef MATH2D_HPP
+#define MATH2D_HPP
+
+#include "AEEngine.h"
+#include <cmath>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FP_MATH_SSE2 1
+#include <emmintrin.h>
+#else
+#define FP_MATH_SSE2 0
+#endif
+
+#if defined(__AVX__)
+#define FP_MATH_AVX 1
+#include <immintrin.h>
+#else
+#define FP_MATH_AVX 0
+#endif
+
+namespace gfx
+{
+    // -------------------------------------------------------------------
+    // Vec2
+    // -------------------------------------------------------------------
+    struct Vec2
+    {
+        f32 x{};
+        f32 y{};
+    };
+
+    inline Vec2 operator+(Vec2 a, Vec2 b) { return Vec2{ a.x + b.x, a.y + b.y }; }
+    inline Vec2 operator-(Vec2 a, Vec2 b) { return Vec2{ a.x - b.x, a.y - b.y }; }
+    inline Vec2 operator-(Vec2 a) { return Vec2{ -a.x, -a.y }; }
+    inline Vec2 operator*(Vec2 a, f32 s) { return Vec2{ a.x * s, a.y * s }; }
+    inline Vec2 operator*(f32 s, Vec2 a) { return Vec2{ a.x * s, a.y * s }; }
+    inline Vec2 operator/(Vec2 a, f32 s) { return Vec2{ a.x / s, a.y / s }; }
+    inline Vec2& operator+=(Vec2& a, Vec2 b) { a.x += b.x; a.y += b.y; return a; }
+    inline Vec2& operator-=(Vec2& a, Vec2 b) { a.x -= b.x; a.y -= b.y; return a; }
+    inline Vec2& operator*=(Vec2& a, f32 s) { a.x *= s; a.y *= s; return a; }
+
+    inline f32 dot(Vec2 a, Vec2 b) { return a.x * b.x + a.y * b.y; }
+    inline f32 cross(Vec2 a, Vec2 b) { return a.x * b.y - a.y * b.x; }
+    inline f32 lengthSq(Vec2 a) { return dot(a, a); }
+    inline f32 length(Vec2 a) { return std::sqrt(dot(a, a)); }
+
+    // Zero stays zero.
+    inline Vec2 normalize(Vec2 a)
+    {
+        const f32 len = length(a);
+        return len > 0.0f ? a / len : Vec2{};
+    }
+
+    inline Vec2 lerp(Vec2 a, Vec2 b, f32 t) { return Vec2{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t }; }
+
+    // -------------------------------------------------------------------
+    // Mat2x3
+    // -------------------------------------------------------------------
+    struct Mat2x3
+    {
+        f32 a, b, tx;
+        f32 c, d, ty;
+
+        static Mat2x3 identity() { return Mat2x3{ 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f }; }
+        static Mat2x3 translation(Vec2 t) { return Mat2x3{ 1.0f, 0.0f, t.x, 0.0f, 1.0f, t.y }; }
+        static Mat2x3 scale(Vec2 s) { return Mat2x3{ s.x, 0.0f, 0.0f, 0.0f, s.y, 0.0f }; }
+
+        static Mat2x3 rotation(f32 radians)
+        {
+            const f32 cs = std::cos(radians);
+            const f32 sn = std::sin(radians);
+            return Mat2x3{ cs, -sn, 0.0f, sn, cs, 0.0f };
+        }
+
+        // translate * rotate * scale, built directly (no concatenation).
+        static Mat2x3 trs(Vec2 position, f32 radians, Vec2 s)
+        {
+            if (radians == 0.0f)
+                return Mat2x3{ s.x, 0.0f, position.x, 0.0f, s.y, position.y };
+
+            const f32 cs = std::cos(radians);
+            const f32 sn = std::sin(radians);
+            return Mat2x3{ cs * s.x, -sn * s.y, position.x,
+                           sn * s.x,  cs * s.y, position.y };
+        }
+    };
+
+    // l * r: applies r first, then l.
+    inline Mat2x3 operator*(const Mat2x3& l, const Mat2x3& r)
+    {
+        return Mat2x3{
+            l.a * r.a + l.b * r.c, l.a * r.b + l.b * r.d, l.a * r.tx + l.b * r.ty + l.tx,
+            l.c * r.a + l.d * r.c, l.c * r.b + l.d * r.d, l.c * r.tx + l.d * r.ty + l.ty };
+    }
+
+    inline Vec2 transformPoint(const Mat2x3& m, Vec2 p)
+    {
+        return Vec2{ m.a * p.x + m.b * p.y + m.tx, m.c * p.x + m.d * p.y + m.ty };
+    }
+
+    inline Vec2 transformVector(const Mat2x3& m, Vec2 v)
+    {
+        return Vec2{ m.a * v.x + m.b * v.y, m.c * v.x + m.d * v.y };
+    }
+
+    // Identity if m is singular.
+    inline Mat2x3 inverse(const Mat2x3& m)
+    {
+        const f32 det = m.a * m.d - m.b * m.c;
+        if (det == 0.0f)
+            return Mat2x3::identity();
+
+        const f32 inv = 1.0f / det;
+        const f32 a = m.d * inv;
+        const f32 b = -m.b * inv;
+        const f32 c = -m.c * inv;
+        const f32 d = m.a * inv;
+        return Mat2x3{ a, b, -(a * m.tx + b * m.ty),
+                       c, d, -(c * m.tx + d * m.ty) };
+    }
+
+    // -------------------------------------------------------------------
+    // AE boundary
+    // -------------------------------------------------------------------
+    inline AEMtx33 toAE(const Mat2x3& m)
+    {
+        AEMtx33 r;
+        r.m[0][0] = m.a;  r.m[0][1] = m.b;  r.m[0][2] = m.tx;
+        r.m[1][0] = m.c;  r.m[1][1] = m.d;  r.m[1][2] = m.ty;
+        r.m[2][0] = 0.0f; r.m[2][1] = 0.0f; r.m[2][2] = 1.0f;
+        return r;
+    }
+
+    inline AEVec2 toAE(Vec2 v) { AEVec2 r; r.x = v.x; r.y = v.y; return r; }
+    inline Vec2 fromAE(const AEVec2& v) { return Vec2{ v.x, v.y }; }
+
+    // -------------------------------------------------------------------
+    // Batch transforms
+    // -------------------------------------------------------------------
+
+    // out[i] = m * in[i]. in and out may be the same array.
+    inline void transformPoints(const Mat2x3& m, const Vec2* in, Vec2* out, size_t count)
+    {
+        static_assert(sizeof(Vec2) == 2 * sizeof(f32), "Vec2 must be two packed floats");
+
+        const f32* src = &in->x;
+        f32* dst = &out->x;
+        size_t i = 0;
+
+#if FP_MATH_AVX
+        {
+            // Four points per iteration: [x0 y0 x1 y1 | x2 y2 x3 y3].
+            const __m256 col0 = _mm256_setr_ps(m.a, m.c, m.a, m.c, m.a, m.c, m.a, m.c);
+            const __m256 col1 = _mm256_setr_ps(m.b, m.d, m.b, m.d, m.b, m.d, m.b, m.d);
+            const __m256 t = _mm256_setr_ps(m.tx, m.ty, m.tx, m.ty, m.tx, m.ty, m.tx, m.ty);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m256 p = _mm256_loadu_ps(src + i * 2);
+                const __m256 xx = _mm256_permute_ps(p, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m256 yy = _mm256_permute_ps(p, _MM_SHUFFLE(3, 3, 1, 1));
+                const __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xx, col0), _mm256_mul_ps(yy, col1)), t);
+                _mm256_storeu_ps(dst + i * 2, r);
+            }
+        }
+#endif
+
+#if FP_MATH_SSE2
+        {
+            // Two points per iteration: [x0 y0 x1 y1].
+            const __m128 col0 = _mm_setr_ps(m.a, m.c, m.a, m.c);
+            const __m128 col1 = _mm_setr_ps(m.b, m.d, m.b, m.d);
+            const __m128 t = _mm_setr_ps(m.tx, m.ty, m.tx, m.ty);
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m128 p = _mm_loadu_ps(src + i * 2);
+                const __m128 xx = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m128 yy = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+                const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, col0), _mm_mul_ps(yy, col1)), t);
+                _mm_storeu_ps(dst + i * 2, r);
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+            out[i] = transformPoint(m, in[i]);
+    }
+
+    // Structure-of-arrays version (particles, ...): (outX[i], outY[i]) =
+    // m * (x[i], y[i]). Inputs and outputs may alias element for element.
+    inline void transformPoints(const Mat2x3& m, const f32* x, const f32* y,
+        f32* outX, f32* outY, size_t count)
+    {
+        size_t i = 0;
+
+#if FP_MATH_AVX
+        {
+            const __m256 a = _mm256_set1_ps(m.a), b = _mm256_set1_ps(m.b), tx = _mm256_set1_ps(m.tx);
+            const __m256 c = _mm256_set1_ps(m.c), d = _mm256_set1_ps(m.d), ty = _mm256_set1_ps(m.ty);
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 px = _mm256_loadu_ps(x + i);
+                const __m256 py = _mm256_loadu_ps(y + i);
+                _mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, px), _mm256_mul_ps(b, py)), tx));
+                _mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c, px), _mm256_mul_ps(d, py)), ty));
+            }
+        }
+#endif
+
+#if FP_MATH_SSE2
+        {
+            const __m128 a = _mm_set1_ps(m.a), b = _mm_set1_ps(m.b), tx = _mm_set1_ps(m.tx);
+            const __m128 c = _mm_set1_ps(m.c), d = _mm_set1_ps(m.d), ty = _mm_set1_ps(m.ty);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 px = _mm_loadu_ps(x + i);
+                const __m128 py = _mm_loadu_ps(y + i);
+                _mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, px), _mm_mul_ps(b, py)), tx));
+                _mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c, px), _mm_mul_ps(d, py)), ty));
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const f32 px = x[i];
+            const f32 py = y[i];
+            outX[i] = m.a * px + m.b * py + m.tx;
+            outY[i] = m.c * px + m.d * py + m.ty;
+        }
+    }
+
+    // Builds one trs() matrix per instance (tile / sprite batches).
+    inline void buildTransforms(const Vec2* positions, const f32* radians, const Vec2* scales,
+        Mat2x3* out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = Mat2x3::trs(positions[i], radians ? radians[i] : 0.0f, scales[i]);
+    }
+}
+
+#endif // MATH2D_HPP
@@ -0,0 +1,570 @@
+// ---------------------------------------------------------------------------
+// particles.cpp
+// ---------------------------------------------------------------------------
+//
+// Text source format (one directive per line, '#' starts a comment):
+//
+//   emitter snow
+//     texture <asset path>      (optional; default flat colored quads)
+//     layer   front             (back = behind the tiles | front)
+//     rate    120               (particles per second while running)
+//     burst   0                 (particles per burst())
+//     life    4 6               (seconds, min max)
+//     area    1600 0            (spawn box, centred on the emitter)
+//     angle   270 15            (degrees, 0 = right, 90 = up; +/- spread)
+//     speed   20 60             (min max)
+//     gravity 0 -20
+//     drag    0.2               (velocity lost per second, 0..1)
+//     size    5 3               (start end)
+//     color   FFFFFFFF 00FFFFFF (ARGB start end)
+//   end
+// ---------------------------------------------------------------------------
+
+#include "particles.hpp"
+#include "render_queue.hpp"
+#include <cmath>
+#include <sstream>
+
+namespace game
+{
+    namespace
+    {
+        const f32 kDegToRad = 3.14159265359f / 180.0f;
+
+        std::string trim(const std::string& s)
+        {
+            const size_t b = s.find_first_not_of(" \t\r\n");
+            if (b == std::string::npos)
+                return std::string();
+            const size_t e = s.find_last_not_of(" \t\r\n");
+            return s.substr(b, e - b + 1);
+        }
+
+        EmitterDef defaultEmitter(const std::string& name)
+        {
+            EmitterDef d;
+            d.name = name;
+            d.layer = gfx::kLayerEntities + 10;
+            d.rate = 0.0f;
+            d.burst = 0;
+            d.lifeMin = d.lifeMax = 1.0f;
+            d.area = gfx::Vec2{ 0.0f, 0.0f };
+            d.angle = 90.0f * kDegToRad;
+            d.spread = 0.0f;
+            d.speedMin = d.speedMax = 0.0f;
+            d.gravity = gfx::Vec2{ 0.0f, 0.0f };
+            d.drag = 0.0f;
+            d.sizeStart = d.sizeEnd = 4.0f;
+            d.colorStart = d.colorEnd = 0xFFFFFFFF;
+            return d;
+        }
+
+        u32 lerpColor(u32 a, u32 b, f32 t)
+        {
+            u32 out = 0;
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                const f32 ca = static_cast<f32>((a >> shift) & 0xFF);
+                const f32 cb = static_cast<f32>((b >> shift) & 0xFF);
+                out |= static_cast<u32>(ca + (cb - ca) * t + 0.5f) << shift;
+            }
+            return out;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // parseEmitters
+    // -------------------------------------------------------------------
+    bool parseEmitters(const std::string& text, std::vector<EmitterDef>& out, std::string& error)
+    {
+        out.clear();
+
+        std::istringstream in(text);
+        std::string line;
+        int lineNo = 0;
+
+        auto fail = [&](const std::string& msg)
+        {
+            error = "line " + std::to_string(lineNo) + ": " + msg;
+            out.clear();
+            return false;
+        };
+
+        while (std::getline(in, line))
+        {
+            ++lineNo;
+            line = trim(line);
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream words(line);
+            std::string key, name;
+            words >> key;
+            if (key != "emitter")
+                return fail("unknown directive '" + key + "'");
+            if (!(words >> name))
+                return fail("emitter needs a name");
+            for (const EmitterDef& d : out)
+            {
+                if (d.name == name)
+                    return fail("emitter '" + name + "' defined twice");
+            }
+
+            EmitterDef d = defaultEmitter(name);
+
+            // Properties up to 'end'.
+            bool ended = false;
+            while (!ended && std::getline(in, line))
+            {
+                ++lineNo;
+                line = trim(line);
+                if (line.empty() || line[0] == '#')
+                    continue;
+
+                std::istringstream pw(line);
+                pw >> key;
+                bool ok = true;
+                if (key == "end")
+                {
+                    ended = true;
+                }
+                else if (key == "texture")
+                {
+                    std::string path;
+                    ok = static_cast<bool>(pw >> path);
+                    d.texture = assetId(path.c_str());
+                }
+                else if (key == "layer")
+                {
+                    std::string layer;
+                    pw >> layer;
+                    if (layer == "back")
+                        d.layer = gfx::kLayerTiles - 10;
+                    else if (layer == "front")
+                        d.layer = gfx::kLayerEntities + 10;
+                    else
+                        return fail("expected back or front, got '" + layer + "'");
+                }
+                else if (key == "rate")
+                {
+                    ok = (pw >> d.rate) && d.rate >= 0.0f;
+                }
+                else if (key == "burst")
+                {
+                    ok = (pw >> d.burst) && d.burst >= 0;
+                }
+                else if (key == "life")
+                {
+                    ok = (pw >> d.lifeMin >> d.lifeMax) && d.lifeMin > 0.0f && d.lifeMax >= d.lifeMin;
+                }
+                else if (key == "area")
+                {
+                    ok = static_cast<bool>(pw >> d.area.x >> d.area.y);
+                }
+                else if (key == "angle")
+                {
+                    ok = static_cast<bool>(pw >> d.angle >> d.spread);
+                    d.angle *= kDegToRad;
+                    d.spread *= kDegToRad;
+                }
+                else if (key == "speed")
+                {
+                    ok = (pw >> d.speedMin >> d.speedMax) && d.speedMax >= d.speedMin;
+                }
+                else if (key == "gravity")
+                {
+                    ok = static_cast<bool>(pw >> d.gravity.x >> d.gravity.y);
+                }
+                else if (key == "drag")
+                {
+                    ok = (pw >> d.drag) && d.drag >= 0.0f && d.drag <= 1.0f;
+                }
+                else if (key == "size")
+                {
+                    ok = (pw >> d.sizeStart >> d.sizeEnd) && d.sizeStart >= 0.0f && d.sizeEnd >= 0.0f;
+                }
+                else if (key == "color")
+                {
+                    ok = static_cast<bool>(pw >> std::hex >> d.colorStart >> d.colorEnd);
+                }
+                else
+                {
+                    return fail("unknown property '" + key + "'");
+                }
+
+                if (!ok)
+                    return fail("bad value for '" + key + "'");
+            }
+
+            if (!ended)
+                return fail("emitter '" + name + "' has no 'end'");
+            out.push_back(d);
+        }
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // ParticleSystem
+    // -------------------------------------------------------------------
+    ParticleSystem::ParticleSystem(size_t poolCapacity)
+        : capacity(poolCapacity)
+        , limit(poolCapacity)
+        , density(1.0f)
+        , cache(nullptr)
+        , seed(0x9E3779B9u)
+    {
+    }
+
+    bool ParticleSystem::load(const u8* data, size_t size, std::string& error)
+    {
+        std::vector<EmitterDef> parsed;
+        if (!parseEmitters(std::string(reinterpret_cast<const char*>(data), size), parsed, error))
+            return false;
+
+        clear();
+        pools.clear();
+        defs.swap(parsed);
+        defPool.assign(defs.size(), -1);
+        return true;
+    }
+
+    void ParticleSystem::bindTextures(const ResourceCache& resources)
+    {
+        cache = &resources;
+    }
+
+    void ParticleSystem::setDensity(f32 fraction)
+    {
+        density = fraction < 0.0f ? 0.0f : fraction > 1.0f ? 1.0f : fraction;
+        limit = static_cast<size_t>(static_cast<f32>(capacity) * density);
+    }
+
+    int ParticleSystem::find(const std::string& name) const
+    {
+        for (size_t i = 0; i < defs.size(); ++i)
+        {
+            if (defs[i].name == name)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void ParticleSystem::clear()
+    {
+        for (Pool& pool : pools)
+            pool.count = 0;
+        emitters.clear();
+    }
+
+    size_t ParticleSystem::liveCount() const
+    {
+        size_t n = 0;
+        for (const Pool& pool : pools)
+            n += pool.count;
+        return n;
+    }
+
+    f32 ParticleSystem::random01()
+    {
+        // xorshift32; the top 24 bits as a fraction.
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return static_cast<f32>(seed >> 8) * (1.0f / 16777216.0f);
+    }
+
+    int ParticleSystem::poolFor(AssetId texture, s32 layer)
+    {
+        for (size_t i = 0; i < pools.size(); ++i)
+        {
+            if (pools[i].texture == texture && pools[i].layer == layer)
+                return static_cast<int>(i);
+        }
+
+        // Full capacity up front; nothing reallocates while it's in use.
+        pools.emplace_back();
+        Pool& pool = pools.back();
+        pool.texture = texture;
+        pool.layer = layer;
+        pool.count = 0;
+        for (std::vector<f32>* a : { &pool.x, &pool.y, &pool.vx, &pool.vy, &pool.ax, &pool.ay,
+            &pool.drag, &pool.age, &pool.life, &pool.sizeStart, &pool.sizeEnd })
+            a->resize(capacity);
+        pool.colorStart.resize(capacity);
+        pool.colorEnd.resize(capacity);
+        return static_cast<int>(pools.size()) - 1;
+    }
+
+    // -------------------------------------------------------------------
+    // emitters
+    // -------------------------------------------------------------------
+    void ParticleSystem::spawn(int def, gfx::Vec2 pos, int count)
+    {
+        if (def < 0 || def >= static_cast<int>(defs.size()) || count <= 0)
+            return;
+
+        if (defPool[def] < 0)
+            defPool[def] = poolFor(defs[def].texture, defs[def].layer);
+
+        const EmitterDef& d = defs[def];
+        Pool& pool = pools[defPool[def]];
+        for (int n = 0; n < count && pool.count < limit; ++n)
+        {
+            const size_t i = pool.count++;
+            const f32 dir = d.angle + random(-d.spread, d.spread);
+            const f32 speed = random(d.speedMin, d.speedMax);
+
+            pool.x[i] = pos.x + random(-0.5f, 0.5f) * d.area.x;
+            pool.y[i] = pos.y + random(-0.5f, 0.5f) * d.area.y;
+            pool.vx[i] = std::cos(dir) * speed;
+            pool.vy[i] = std::sin(dir) * speed;
+            pool.ax[i] = d.gravity.x;
+            pool.ay[i] = d.gravity.y;
+            pool.drag[i] = d.drag;
+            pool.age[i] = 0.0f;
+            pool.life[i] = random(d.lifeMin, d.lifeMax);
+            pool.sizeStart[i] = d.sizeStart;
+            pool.sizeEnd[i] = d.sizeEnd;
+            pool.colorStart[i] = d.colorStart;
+            pool.colorEnd[i] = d.colorEnd;
+        }
+    }
+
+    void ParticleSystem::burst(int def, gfx::Vec2 pos, int count)
+    {
+        if (def < 0 || def >= static_cast<int>(defs.size()))
+            return;
+        spawn(def, pos, count < 0 ? defs[def].burst : count);
+    }
+
+    int ParticleSystem::start(int def, gfx::Vec2 pos)
+    {
+        if (def < 0 || def >= static_cast<int>(defs.size()))
+            return 0;
+
+        size_t slot = 0;
+        while (slot < emitters.size() && emitters[slot].def >= 0)
+            ++slot;
+        if (slot == emitters.size())
+            emitters.push_back(Emitter{});
+
+        emitters[slot] = Emitter{ def, pos, 0.0f };
+        return static_cast<int>(slot) + 1;
+    }
+
+    void ParticleSystem::move(int emitter, gfx::Vec2 pos)
+    {
+        if (emitter > 0 && emitter <= static_cast<int>(emitters.size()))
+            emitters[emitter - 1].pos = pos;
+    }
+
+    void ParticleSystem::stop(int emitter)
+    {
+        // Its particles live out their lives.
+        if (emitter > 0 && emitter <= static_cast<int>(emitters.size()))
+            emitters[emitter - 1].def = -1;
+    }
+
+    // -------------------------------------------------------------------
+    // update
+    // -------------------------------------------------------------------
+    void ParticleSystem::moveParticle(Pool& pool, size_t from, size_t to)
+    {
+        pool.x[to] = pool.x[from];
+        pool.y[to] = pool.y[from];
+        pool.vx[to] = pool.vx[from];
+        pool.vy[to] = pool.vy[from];
+        pool.ax[to] = pool.ax[from];
+        pool.ay[to] = pool.ay[from];
+        pool.drag[to] = pool.drag[from];
+        pool.age[to] = pool.age[from];
+        pool.life[to] = pool.life[from];
+        pool.sizeStart[to] = pool.sizeStart[from];
+        pool.sizeEnd[to] = pool.sizeEnd[from];
+        pool.colorStart[to] = pool.colorStart[from];
+        pool.colorEnd[to] = pool.colorEnd[from];
+    }
+
+    void ParticleSystem::integrate(Pool& pool, f32 dt)
+    {
+        const size_t count = pool.count;
+        f32* x = pool.x.data();
+        f32* y = pool.y.data();
+        f32* vx = pool.vx.data();
+        f32* vy = pool.vy.data();
+        const f32* ax = pool.ax.data();
+        const f32* ay = pool.ay.data();
+        const f32* drag = pool.drag.data();
+        f32* age = pool.age.data();
+        const f32* life = pool.life.data();
+
+        dead.clear();
+        size_t i = 0;
+
+        // v += a dt; v *= max(0, 1 - drag dt); p += v dt; age += dt. The
+        // lanes that ran out of life are collected for removal.
+#if FP_MATH_AVX
+        {
+            const __m256 step = _mm256_set1_ps(dt);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 damp = _mm256_max_ps(zero, _mm256_sub_ps(one, _mm256_mul_ps(_mm256_loadu_ps(drag + i), step)));
+                const __m256 nvx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(vx + i), _mm256_mul_ps(_mm256_loadu_ps(ax + i), step)), damp);
+                const __m256 nvy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(vy + i), _mm256_mul_ps(_mm256_loadu_ps(ay + i), step)), damp);
+                _mm256_storeu_ps(vx + i, nvx);
+                _mm256_storeu_ps(vy + i, nvy);
+                _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(nvx, step)));
+                _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(nvy, step)));
+
+                const __m256 nage = _mm256_add_ps(_mm256_loadu_ps(age + i), step);
+                _mm256_storeu_ps(age + i, nage);
+                const int expired = _mm256_movemask_ps(_mm256_cmp_ps(nage, _mm256_loadu_ps(life + i), _CMP_GE_OQ));
+                for (int lane = 0; expired && lane < 8; ++lane)
+                {
+                    if (expired & (1 << lane))
+                        dead.push_back(static_cast<u32>(i + lane));
+                }
+            }
+        }
+#endif
+
+#if FP_MATH_SSE2
+        {
+            const __m128 step = _mm_set1_ps(dt);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 damp = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(drag + i), step)));
+                const __m128 nvx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), _mm_mul_ps(_mm_loadu_ps(ax + i), step)), damp);
+                const __m128 nvy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(_mm_loadu_ps(ay + i), step)), damp);
+                _mm_storeu_ps(vx + i, nvx);
+                _mm_storeu_ps(vy + i, nvy);
+                _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(nvx, step)));
+                _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(nvy, step)));
+
+                const __m128 nage = _mm_add_ps(_mm_loadu_ps(age + i), step);
+                _mm_storeu_ps(age + i, nage);
+                const int expired = _mm_movemask_ps(_mm_cmpge_ps(nage, _mm_loadu_ps(life + i)));
+                for (int lane = 0; expired && lane < 4; ++lane)
+                {
+                    if (expired & (1 << lane))
+                        dead.push_back(static_cast<u32>(i + lane));
+                }
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            f32 damp = 1.0f - drag[i] * dt;
+            if (damp < 0.0f)
+                damp = 0.0f;
+            vx[i] = (vx[i] + ax[i] * dt) * damp;
+            vy[i] = (vy[i] + ay[i] * dt) * damp;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            age[i] += dt;
+            if (age[i] >= life[i])
+                dead.push_back(static_cast<u32>(i));
+        }
+
+        // Highest first, so the last particle moved into a hole is never
+        // one still waiting to be removed.
+        for (size_t k = dead.size(); k-- > 0;)
+        {
+            const size_t last = --pool.count;
+            if (dead[k] != last)
+                moveParticle(pool, last, dead[k]);
+        }
+    }
+
+    void ParticleSystem::update(f32 dt)
+    {
+        if (dt <= 0.0f)
+            return;
+
+        for (Pool& pool : pools)
+            integrate(pool, dt);
+
+        for (Emitter& e : emitters)
+        {
+            if (e.def < 0)
+                continue;
+
+            e.pending += defs[e.def].rate * density * dt;
+            const int n = static_cast<int>(e.pending);
+            e.pending -= static_cast<f32>(n);
+            spawn(e.def, e.pos, n);
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // draw
+    // -------------------------------------------------------------------
+    void ParticleSystem::drawPool(const Pool& pool) const
+    {
+        const size_t count = pool.count;
+        t.resize(count);
+        half.resize(count);
+
+        // Life fraction and half size, four at a time.
+        size_t i = 0;
+#if FP_MATH_SSE2
+        {
+            const __m128 halve = _mm_set1_ps(0.5f);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 f = _mm_div_ps(_mm_loadu_ps(&pool.age[i]), _mm_loadu_ps(&pool.life[i]));
+                const __m128 s0 = _mm_loadu_ps(&pool.sizeStart[i]);
+                const __m128 s1 = _mm_loadu_ps(&pool.sizeEnd[i]);
+                _mm_storeu_ps(&t[i], f);
+                _mm_storeu_ps(&half[i], _mm_mul_ps(halve, _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(s1, s0), f))));
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            t[i] = pool.age[i] / pool.life[i];
+            half[i] = 0.5f * (pool.sizeStart[i] + (pool.sizeEnd[i] - pool.sizeStart[i]) * t[i]);
+        }
+
+        AEGfxMeshStart();
+        for (i = 0; i < count; ++i)
+        {
+            const u32 c = lerpColor(pool.colorStart[i], pool.colorEnd[i], t[i]);
+            const f32 x0 = pool.x[i] - half[i], x1 = pool.x[i] + half[i];
+            const f32 y0 = pool.y[i] - half[i], y1 = pool.y[i] + half[i];
+
+            // Same winding and UVs as gfx::buildSpriteMesh.
+            AEGfxTriAdd(x0, y0, c, 0.0f, 1.0f,
+                x1, y0, c, 1.0f, 1.0f,
+                x0, y1, c, 0.0f, 0.0f);
+            AEGfxTriAdd(x1, y0, c, 1.0f, 1.0f,
+                x1, y1, c, 1.0f, 0.0f,
+                x0, y1, c, 0.0f, 0.0f);
+        }
+        AEGfxVertexList* mesh = AEGfxMeshEnd();
+        if (!mesh)
+            return;
+
+        // Built in world space.
+        gfx::releaseAfterFlush(mesh);
+        // Looked up every frame: hot reload swaps cached textures in place.
+        AEGfxTexture* texture = cache && pool.texture.valid() ? cache->texture(pool.texture) : nullptr;
+        const gfx::Material material = texture ?
+            gfx::textured(texture, gfx::Opacity::Blended) : gfx::vertexColors(gfx::Opacity::Blended);
+        gfx::submit(material, mesh, gfx::Mat2x3::identity(), pool.layer);
+    }
+
+    void ParticleSystem::draw() const
+    {
+        for (const Pool& pool : pools)
+        {
+            if (pool.count > 0)
+                drawPool(pool);
+        }
+    }
+}
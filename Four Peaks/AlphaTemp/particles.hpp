@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------------
+// particles.hpp
+// ---------------------------------------------------------------------------
+//
+// Pooled particles for weather and impact effects.
+//
+// Emitters are defined in a .fx text file (see Assets/effects/seasons.fx):
+// how many particles, how long they live, where they start, how they move
+// and how size and color change over their life.
+//
+// Particles live in fixed-capacity pools, one per texture and draw layer,
+// stored as structure of arrays so update() integrates them four (SSE2) or
+// eight (AVX) at a time; dead ones are swapped out with the last live one,
+// so a pool is always dense. draw() writes every live particle of a pool
+// into one vertex list, so a pool costs one draw call however many
+// particles it holds. Spawning into a full pool drops the new particles.
+//
+// The budget is about 50k live particles, nearly all of them weather, which
+// is a single pool. So each pool holds 64k. That is 52 bytes a particle,
+// about 3.4 MB per pool, allocated on first use.
+//
+// setDensity() is the quality governor's knob: it scales the emitters' rate
+// and caps every pool at that fraction of its capacity.
+//
+// Positions are world units (render_queue.hpp). Main thread only.
+//
+
+#ifndef PARTICLES_HPP
+#define PARTICLES_HPP
+
+#include "AEEngine.h"
+#include "asset_id.hpp"
+#include "math2d.hpp"
+#include "resource_cache.hpp"
+#include <string>
+#include <vector>
+
+namespace game
+{
+    struct EmitterDef
+    {
+        std::string name;
+        AssetId texture;        // none = flat colored quads
+        s32 layer;              // render queue layer
+        f32 rate;               // particles per second while running
+        int burst;              // particles per burst()
+        f32 lifeMin, lifeMax;   // seconds
+        gfx::Vec2 area;         // spawn box size, centred on the emitter
+        f32 angle, spread;      // launch direction and +/- range, radians
+        f32 speedMin, speedMax;
+        gfx::Vec2 gravity;
+        f32 drag;               // velocity lost per second, 0..1
+        f32 sizeStart, sizeEnd;
+        u32 colorStart, colorEnd;   // ARGB
+    };
+
+    // Text source -> emitters. On error reports "line N: ...".
+    bool parseEmitters(const std::string& text, std::vector<EmitterDef>& out, std::string& error);
+
+    class ParticleSystem
+    {
+    public:
+        static const size_t kDefaultPoolCapacity = 65536;
+
+        explicit ParticleSystem(size_t poolCapacity = kDefaultPoolCapacity);
+        ParticleSystem(const ParticleSystem&) = delete;
+        ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+        // Replaces the emitter definitions; drops every particle.
+        bool load(const u8* data, size_t size, std::string& error);
+        // Where draw() looks up the emitter textures (declared by the owning
+        // state) each frame, so hot reloaded ones are picked up; missing
+        // ones draw as flat quads. The cache must outlive the system.
+        void bindTextures(const ResourceCache& cache);
+        bool empty() const { return defs.empty(); }
+
+        // -1 if there is no such emitter.
+        int find(const std::string& name) const;
+
+        // count < 0 = the emitter's burst size.
+        void burst(int def, gfx::Vec2 pos, int count = -1);
+
+        // Emits at the definition's rate until stopped. Handles are > 0.
+        int start(int def, gfx::Vec2 pos);
+        void move(int emitter, gfx::Vec2 pos);
+        void stop(int emitter);
+
+        // 0..1: fraction of the emitters' rate and of the pool capacity in
+        // use. Particles over a lowered cap live out their life.
+        void setDensity(f32 fraction);
+        f32 getDensity() const { return density; }
+
+        void update(f32 dt);
+        // One vertex list per non-empty pool, queued for this frame.
+        void draw() const;
+
+        // Drops particles and running emitters; keeps the definitions.
+        void clear();
+        size_t liveCount() const;
+
+    private:
+        // Structure of arrays; [0, count) are alive.
+        struct Pool
+        {
+            AssetId texture;    // none = flat colored quads
+            s32 layer;
+            size_t count;
+
+            std::vector<f32> x, y;
+            std::vector<f32> vx, vy;
+            std::vector<f32> ax, ay;
+            std::vector<f32> drag;
+            std::vector<f32> age, life;
+            std::vector<f32> sizeStart, sizeEnd;
+            std::vector<u32> colorStart, colorEnd;
+        };
+
+        struct Emitter
+        {
+            int def;            // -1 = free slot
+            gfx::Vec2 pos;
+            f32 pending;        // fractional particles carried over
+        };
+
+        size_t capacity;
+        size_t limit;                   // capacity * density
+        f32 density;
+        const ResourceCache* cache;     // nullptr = flat quads only
+        std::vector<EmitterDef> defs;
+        std::vector<int> defPool;       // def -> pool, -1 until first spawn
+        std::vector<Pool> pools;
+        std::vector<Emitter> emitters;  // handle = index + 1
+        std::vector<u32> dead;          // update scratch
+        mutable std::vector<f32> half;  // draw scratch: half size per particle
+        mutable std::vector<f32> t;     // draw scratch: life fraction
+        u32 seed;
+
+        f32 random01();
+        f32 random(f32 lo, f32 hi) { return lo + (hi - lo) * random01(); }
+        int poolFor(AssetId texture, s32 layer);
+        void spawn(int def, gfx::Vec2 pos, int count);
+        void integrate(Pool& pool, f32 dt);
+        static void moveParticle(Pool& pool, size_t from, size_t to);
+        void drawPool(const Pool& pool) const;
+    };
+}
+
+#endif // PARTICLES_HPP
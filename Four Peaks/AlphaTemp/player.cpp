@@ -1,5 +1,21 @@
 #include "player.hpp"
+#include "asset_ids.hpp"
+#include "debug_draw.hpp"
 #include "graphics.hpp"
+#include "hot_reload.hpp"
+#include "input.hpp"
+#include "latency.hpp"
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+// clips and their trimmed frame atlas
+static constexpr game::AssetId kAnimData = assets::kPlayerMaleHero;
+// its text source, which hot reload watches (the preload goes by ID)
+static const char* const kAnimSource = "Assets/player/male_hero.anim";
+
+// below this horizontal speed a grounded player shows the idle clip
+static const f32 kRunAnimSpeed = 0.1f;
 
 
 void PlayerInit(Player& p)
@@ -20,67 +36,367 @@ void PlayerInit(Player& p)
     p.coyoteTime = 0.08f;  // tweak: 0.06 - 0.12 feels normal
     p.coyoteTimer = 0.0f;
 
+    p.jumpBufferTime = 0.10f;
+
     p.jumpCutMult = 2.5f; // tweak: 2.0 - 4.0
 
-    // sprite initialisation
-    p.idleTex = AEGfxTextureLoad("Assets/player/male_hero-idle.png");
+    p.facing = 1;
 
-    p.idleFrame = 0;
-    p.idleFrameCount = 10;
+    // animation: bound to a set and an animator by PlayerBindAnimations
+    p.anims = nullptr;
+    p.animator = nullptr;
+    p.animSlot = 0;
+    p.clipIdle = p.clipRun = p.clipJump = p.clipFall = -1;
 
-    p.idleAnimTimer = 0.0f;
-    p.idleFrameTime = 0.10f; // 10 FPS idle animation
+    //hy test
+    p.horzSpeed = 0.0f;
 
-    // running sprite initialisation
-    p.runTex = AEGfxTextureLoad("Assets/player/male_hero-run.png");
 
-    p.runFrame = 0;
-    p.runFrameCount = 10;     // run sheet has 10 frames
-    p.runAnimTimer = 0.0f;
-    p.runFrameTime = 0.1f;   // faster than idle
+    // collider box
+    p.colliderSize = { 45.0f, 45.0f };  // literally size of collider box
+    p.spriteSize = { 140.0f, 140.0f };  // player is square sprite
 
-    p.facing = 1;
+    p.spriteOffsetY = -50.0f;
 
-    // jumping sprite initialisation
-    p.jumpTex = AEGfxTextureLoad("Assets/player/male_hero-jump.png");
+    // f32 physics by default; see PlayerSetFixedPhysics
+    p.fixedPhysics = false;
+    p.fx = PlayerFixed{};
+    p.tickAccumulator = 0.0f;
+    p.tick = 0;
+}
 
-    p.jumpFrame = 0;
-    p.jumpFrameCount = 6;      // 6 frames
-    p.jumpAnimTimer = 0.0f;
-    p.jumpFrameTime = 0.06f;   // can change
+void PlayerDeclareResources(std::vector<game::ResourceRequest>& out)
+{
+    out.push_back(game::ResourceRequest::data(kAnimData));
+}
 
-    // falling sprite initialisation
-    p.fallTex = AEGfxTextureLoad("Assets/player/male_hero-fall_loop.png");
+static void PlayerUnwatchAnimations(Player& p)
+{
+    for (int w : p.animWatches)
+        hotreload::unwatch(w);
+    p.animWatches.clear();
+}
 
-    p.fallFrame = 0;
-    p.fallFrameCount = 3;      //
-    p.fallAnimTimer = 0.0f;
-    p.fallFrameTime = 0.08f;   // can change
+#if FP_HOT_RELOAD
+static bool PlayerParseAnimations(const std::string& path, game::AnimationSet& out)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::stringstream text;
+    text << in.rdbuf();
+    const std::string s = text.str();
 
-    //hy test
-    p.horzSpeed = 0.0f;
+    std::string error;
+    if (!in || !out.load(reinterpret_cast<const u8*>(s.data()), s.size(), error))
+    {
+        PRINT("hotreload: %s: %s\n", path.c_str(), in ? error.c_str() : "unreadable");
+        return false;
+    }
+    return true;
+}
 
+// watches the .anim source and every sheet it names. Any change re-parses
+// the source on the hot reload thread; the swap, the texture upload and
+// re-resolving the clips happen at a frame boundary. The sheets are
+// re-watched then, as the edit may have changed them.
+static void PlayerWatchAnimations(Player& p, game::AnimationSet& set,
+    const std::vector<std::string>& sheets)
+{
+    PlayerUnwatchAnimations(p);
 
-    // collider box
-    p.colliderSize = { 45.0f, 45.0f };  // literally size of collider box
-    p.spriteSize = { 140.0f, 140.0f };  // player is square sprite
+    auto reload = [&p, &set](const std::string&) -> hotreload::ApplyFn
+    {
+        std::shared_ptr<game::AnimationSet> fresh(new game::AnimationSet());
+        if (!PlayerParseAnimations(kAnimSource, *fresh))
+            return hotreload::ApplyFn();
 
-    p.spriteOffsetY = -50.0f;
+        return [&p, &set, fresh]()
+        {
+            set.replace(*fresh);
+            PlayerWatchAnimations(p, set, set.sheetPaths());
+
+            p.clipIdle = set.find("idle");
+            p.clipRun = set.find("run");
+            p.clipJump = set.find("jump");
+            p.clipFall = set.find("fall");
+            if (p.animator)
+                p.animator->restart();
+        };
+    };
+
+    p.animWatches.push_back(hotreload::watch(kAnimSource, reload));
+    for (const std::string& sheet : sheets)
+        p.animWatches.push_back(hotreload::watch(sheet, reload));
+}
+#endif
+
+void PlayerBindAnimations(Player& p, game::AnimationSet& set, game::Animator& animator,
+    const game::ResourceCache& cache)
+{
+    if (set.empty())
+    {
+        const vfs::File* file = cache.data(kAnimData);
+        std::string error;
+        if (!file || !set.load(file->data(), file->size(), error))
+        {
+            PRINT("Player: bad animation data: %s\n", file ? error.c_str() : "not loaded");
+            return;
+        }
+        set.upload();
+    }
+
+    p.anims = &set;
+    p.animator = &animator;
+    p.clipIdle = set.find("idle");
+    p.clipRun = set.find("run");
+    p.clipJump = set.find("jump");
+    p.clipFall = set.find("fall");
+    p.animSlot = animator.add(p.clipIdle);
+
+#if FP_HOT_RELOAD
+    // the cooked set has no sheet paths; the source names them
+    game::AnimationSet source;
+    if (PlayerParseAnimations(kAnimSource, source))
+        PlayerWatchAnimations(p, set, source.sheetPaths());
+#endif
+}
+
+
+
+// picks the clip from the movement state; the animator only restarts it
+// when it changes (e.g. landing, or jumping out of a fall)
+static void PlayerAnimate(Player& p)
+{
+    if (!p.animator)
+        return;
+
+    int clip;
+    if (!p.grounded)
+        clip = p.velY > 0.0f ? p.clipJump : p.clipFall;
+    else if (p.horzSpeed > kRunAnimSpeed || p.horzSpeed < -kRunAnimSpeed)
+        clip = p.clipRun;
+    else
+        clip = p.clipIdle;
+
+    p.animator->play(p.animSlot, clip);
+}
+
+
+// ===================== FIXED-POINT PHYSICS =====================
+// Same rules as the f32 path in PlayerUpdate, in 16.16 with a constant tick.
+// Nothing in here may read f32 state or the frame dt.
+
+using game::Fixed;
+
+static const Fixed kTick = Fixed::ratio(1, kPlayerTickHz);
+static const Fixed kGroundY = Fixed::fromInt(-450);
+
+// copies the simulation state out for drawing / the camera
+static void PlayerMirrorFixed(Player& p)
+{
+    p.pos.x = p.fx.pos.x.toFloat();
+    p.pos.y = p.fx.pos.y.toFloat();
+    p.velY = p.fx.velY.toFloat();
+    p.horzSpeed = p.fx.horzSpeed.toFloat();
+    p.coyoteTimer = p.fx.coyoteTimer.toFloat();
+    p.grounded = p.fx.grounded;
+}
+
+// takes the f32 position (spawns, teleports) as the new fixed position
+static void PlayerSyncFixedPos(Player& p)
+{
+    p.fx.pos.x = Fixed::fromFloat(p.pos.x);
+    p.fx.pos.y = Fixed::fromFloat(p.pos.y);
+}
+
+void PlayerSetFixedPhysics(Player& p, bool enabled)
+{
+    if (enabled == p.fixedPhysics)
+        return;
+
+    p.fixedPhysics = enabled;
+    p.tickAccumulator = 0.0f;
+    p.tick = 0;
+    if (!enabled)
+        return;     // the mirrored f32 state carries on
+
+    PlayerFixed& f = p.fx;
+    PlayerSyncFixedPos(p);
+    f.velY = Fixed::fromFloat(p.velY);
+    f.horzSpeed = Fixed::fromFloat(p.horzSpeed);
+    f.coyoteTimer = Fixed::fromFloat(p.coyoteTimer);
+    f.grounded = p.grounded;
+
+    f.speed = Fixed::fromFloat(p.speed);
+    f.gravity = Fixed::fromFloat(p.gravity);
+    f.terminalVel = Fixed::fromFloat(p.terminalVel);
+    f.jumpVel = Fixed::fromFloat(p.jumpVel);
+    f.coyoteTime = Fixed::fromFloat(p.coyoteTime);
+    f.jumpCutMult = Fixed::fromFloat(p.jumpCutMult);
+    f.halfColliderH = Fixed::fromFloat(p.colliderSize.y * 0.5);
+}
+
+PlayerInput PlayerReadInput(Player& p, f64 tickEnd)
+{
+    PlayerInput in{};
+    if (input::heldAt(AEVK_A, tickEnd)) {
+        in.moveX -= 1;
+        p.facing = -1;
+    }
+    if (input::heldAt(AEVK_D, tickEnd)) {
+        in.moveX += 1;
+        p.facing = 1;
+    }
+    in.jumpPressed = input::buffered(AEVK_SPACE, p.jumpBufferTime, tickEnd);
+    in.jumpHeld = input::heldAt(AEVK_SPACE, tickEnd);
+    return in;
 }
 
+bool PlayerStepFixed(Player& p, const PlayerInput& in)
+{
+    PlayerFixed& f = p.fx;
+
+    // horizontal: accelerate toward input, decelerate to exactly zero
+    const Fixed accel = Fixed::fromInt(f.grounded ? 10 : 8) * kTick;
+    const Fixed decel = Fixed::fromInt(f.grounded ? 8 : 4) * kTick;
+    const Fixed maxHorzSpeed = Fixed::fromInt(2);
+
+    if (in.moveX != 0) {
+        f.horzSpeed += accel * in.moveX;
+    }
+    else if (f.horzSpeed > Fixed{ 0 }) {
+        f.horzSpeed = game::fixedMax(f.horzSpeed - decel, Fixed{ 0 });
+    }
+    else if (f.horzSpeed < Fixed{ 0 }) {
+        f.horzSpeed = game::fixedMin(f.horzSpeed + decel, Fixed{ 0 });
+    }
+    f.horzSpeed = game::fixedClamp(f.horzSpeed, -maxHorzSpeed, maxHorzSpeed);
+
+    f.pos.x += f.horzSpeed * f.speed * kTick;
+
+    // coyote time
+    if (f.grounded)
+        f.coyoteTimer = f.coyoteTime;
+    else
+        f.coyoteTimer = game::fixedMax(f.coyoteTimer - kTick, Fixed{ 0 });
+
+    const bool jumped = in.jumpPressed && (f.grounded || f.coyoteTimer > Fixed{ 0 });
+    if (jumped)
+    {
+        f.velY = f.jumpVel;
+        f.grounded = false;
+        f.coyoteTimer = Fixed{ 0 };
+    }
+
+    if (f.grounded && f.velY <= Fixed{ 0 })
+        f.velY = Fixed{ 0 };
+
+    // gravity, plus the jump cut while rising without the button
+    f.velY += f.gravity * kTick;
+    if (f.velY > Fixed{ 0 } && !in.jumpHeld)
+        f.velY += f.gravity * (f.jumpCutMult - Fixed::fromInt(1)) * kTick;
+
+    f.velY = game::fixedMax(f.velY, f.terminalVel);
+    f.pos.y += f.velY * kTick;
+
+    // floor
+    if (f.pos.y - f.halfColliderH <= kGroundY)
+    {
+        f.pos.y = kGroundY + f.halfColliderH;
+        f.velY = Fixed{ 0 };
+        f.grounded = true;
+    }
+    else
+    {
+        f.grounded = false;
+    }
+
+    ++p.tick;
+    return jumped;
+}
+
+u32 PlayerFixedChecksum(const Player& p)
+{
+    const PlayerFixed& f = p.fx;
+    const s64 words[] = { f.pos.x.raw, f.pos.y.raw, f.velY.raw, f.horzSpeed.raw,
+        f.coyoteTimer.raw, f.grounded ? 1 : 0 };
+
+    // FNV-1a over the raw words
+    u32 h = 2166136261u;
+    for (s64 w : words)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            h ^= static_cast<u32>(w >> (i * 8)) & 0xFFu;
+            h *= 16777619u;
+        }
+    }
+    return h;
+}
+
+void PlayerPlace(Player& p, gfx::Vec2 feet)
+{
+    p.pos = { feet.x, feet.y + p.colliderSize.y * 0.5f };
+    p.velY = 0.0f;
+    p.horzSpeed = 0.0f;
+    p.coyoteTimer = 0.0f;
+    p.grounded = false;
+
+    if (p.fixedPhysics)
+    {
+        PlayerSyncFixedPos(p);
+        p.fx.velY = Fixed{ 0 };
+        p.fx.horzSpeed = Fixed{ 0 };
+        p.fx.coyoteTimer = Fixed{ 0 };
+        p.fx.grounded = false;
+    }
+}
+
+// runs as many ticks as the frame time covers; each tick reads the input
+// as it was at the end of its own slice of the frame, so a press lands on
+// the tick it happened in
+static void PlayerUpdateFixed(Player& p, float dt)
+{
+    // moved from outside (spawn, level reload)?
+    if (p.pos.x != p.fx.pos.x.toFloat() || p.pos.y != p.fx.pos.y.toFloat())
+        PlayerSyncFixedPos(p);
+
+    const f32 tickSeconds = 1.0f / kPlayerTickHz;
+    const f64 frameEnd = input::frameTime();
+    p.tickAccumulator += dt;
+    while (p.tickAccumulator >= tickSeconds)
+    {
+        p.tickAccumulator -= tickSeconds;
+        const f64 tickEnd = frameEnd - p.tickAccumulator;
+
+        if (PlayerStepFixed(p, PlayerReadInput(p, tickEnd)))
+        {
+            latency::consumed(AEVK_SPACE, tickEnd, p.tick - 1);
+            input::consume(AEVK_SPACE, tickEnd);
+        }
+    }
+
+    PlayerMirrorFixed(p);
+    PlayerAnimate(p);
+}
 
 
 void PlayerUpdate(Player& p, float dt) {
 
     if (dt > 0.05f) dt = 0.05f;
 
+    if (p.fixedPhysics)
+    {
+        PlayerUpdateFixed(p, dt);
+        return;
+    }
+
     // ===================== HORIZONTAL INPUT (A/D) ===================================
     f32 moveX = 0.0f;
-    if (AEInputCheckCurr(AEVK_A)) {
+    if (input::held(AEVK_A)) {
         moveX -= 1.0f;
         p.facing = -1;
     }
-    if (AEInputCheckCurr(AEVK_D)) {
+    if (input::held(AEVK_D)) {
         moveX += 1.0f;
         p.facing = 1;
     }
@@ -146,13 +462,15 @@ void PlayerUpdate(Player& p, float dt) {
 
     bool canCoyoteJump = (p.coyoteTimer > 0.0f);
 
-    if (AEInputCheckTriggered(AEVK_SPACE) && (p.grounded || canCoyoteJump))
+    // jump buffer: a press shortly before landing still counts
+    const f64 now = input::frameTime();
+    if (input::buffered(AEVK_SPACE, p.jumpBufferTime, now) && (p.grounded || canCoyoteJump))
     {
+        latency::consumed(AEVK_SPACE, now, p.tick);
+        input::consume(AEVK_SPACE, now);
         p.velY = p.jumpVel;
         p.grounded = false;
         p.coyoteTimer = 0.0f;
-        p.jumpFrame = 0;
-        p.jumpAnimTimer = 0.0f;
     }
 
     // If you're on ground and not moving up, keep velY at 0
@@ -163,80 +481,9 @@ void PlayerUpdate(Player& p, float dt) {
     p.velY += p.gravity * dt;
 
 
-    // ===================== IDLE ANIMATION  =====================
-    // only when not moving
-    bool isMoving = (AEInputCheckCurr(AEVK_A) || AEInputCheckCurr(AEVK_D));
-
-    if (p.grounded && !isMoving)
-    {
-        p.idleAnimTimer += dt; // accumulate idle timer
-        while (p.idleAnimTimer >= p.idleFrameTime) // if idle timer is more than set frame time (0.10f)
-        {
-            p.idleAnimTimer -= p.idleFrameTime; // minus frame timer
-            p.idleFrame = (p.idleFrame + 1) % p.idleFrameCount; // frame loop, adds 1 to advance loop
-        }                                                       // eg: if we on frame 8: 8 + 1 = 9, 9 % 10 = 9. if on frame 9, 9 + 1 = 10 % 10 = 0.
-    }
-    else
-    {
-        // reset idle frame and idle timer
-        p.idleFrame = 0;
-        p.idleAnimTimer = 0.0f;
-    }
-
-    // ===================== RUN ANIMATION  =====================
-    isMoving = (AEInputCheckCurr(AEVK_A) || AEInputCheckCurr(AEVK_D));
-
-    if (p.grounded && isMoving)
-    {
-        p.runAnimTimer += dt;
-        while (p.runAnimTimer >= p.runFrameTime)
-        {
-            p.runAnimTimer -= p.runFrameTime;
-            p.runFrame = (p.runFrame + 1) % p.runFrameCount;
-        }
-    }
-    else
-    {
-        p.runFrame = 0;
-        p.runAnimTimer = 0.0f;
-    }
-
-    // ===================== AIR ANIMATION (JUMP / FALL) =====================
-    if (!p.grounded)
-    {
-        if (p.velY > 0.0f)
-        {
-            // JUMP: advance until last frame, then hold
-            p.jumpAnimTimer += dt;
-            while (p.jumpAnimTimer >= p.jumpFrameTime)
-            {
-                p.jumpAnimTimer -= p.jumpFrameTime;
-
-                if (p.jumpFrame < p.jumpFrameCount - 1)
-                    p.jumpFrame += 1; // no loop
-            }
-        }
-        else
-        {
-            // FALL: loop frames
-            p.fallAnimTimer += dt;
-            while (p.fallAnimTimer >= p.fallFrameTime)
-            {
-                p.fallAnimTimer -= p.fallFrameTime;
-                p.fallFrame = (p.fallFrame + 1) % p.fallFrameCount;
-            }
-        }
-    }
-    else
-    {
-        // reset fall when on ground
-        p.fallFrame = 0;
-        p.fallAnimTimer = 0.0f;
-    }
-
     // ===================== VARIABLE JUMP HEIGHT =====================
     // check if going up and if space is held
-    if (p.velY > 0.0f && !AEInputCheckCurr(AEVK_SPACE))
+    if (p.velY > 0.0f && !input::held(AEVK_SPACE))
     {
         // We've already applied 1x gravity. Apply extra gravity to make it cut.
         p.velY += p.gravity * (p.jumpCutMult - 1.0f) * dt;
@@ -268,61 +515,21 @@ void PlayerUpdate(Player& p, float dt) {
         p.grounded = false;
     }
 
+    PlayerAnimate(p);
 }
 
 
 void PlayerDraw(Player& p)
 {
-    bool isMoving = (AEInputCheckCurr(AEVK_A) || AEInputCheckCurr(AEVK_D));
-
     AEGfxTexture* tex = nullptr;
-    int frame = 0;
-    int frameCount = 1;
-
-    // Priority: air states first
-    if (!p.grounded)
+    AEGfxVertexList* mesh = nullptr;
+    if (p.animator && p.anims)
     {
-        if (p.velY > 0.0f)
-        {
-            tex = p.jumpTex;
-            frame = p.jumpFrame;
-            frameCount = p.jumpFrameCount;
-        }
-        else
-        {
-            tex = p.fallTex;
-            frame = p.fallFrame;
-            frameCount = p.fallFrameCount;
-        }
-    }
-    else
-    {
-        // Ground states
-        if (isMoving)
-        {
-            tex = p.runTex;
-            frame = p.runFrame;
-            frameCount = p.runFrameCount;
-        }
-        else
-        {
-            tex = p.idleTex;
-            frame = p.idleFrame;
-            frameCount = p.idleFrameCount;
-        }
-    }
-
-    // Compute UV slice for the chosen frame
-    f32 frameW = 1.0f / (f32)frameCount;
-    f32 u0 = frame * frameW;
-    f32 u1 = u0 + frameW;
-
-    // Flip left/right by swapping u0/u1
-    if (p.facing < 0)
-    {
-        f32 tmp = u0;
-        u0 = u1;
-        u1 = tmp;
+        // precomputed quad for the frame, trimmed to its visible pixels but
+        // placed where they sat in the full frame; facing left uses the
+        // mirrored one
+        tex = p.anims->texture(p.animator->clipOf(p.animSlot));
+        mesh = p.anims->mesh(p.animator->frameOf(p.animSlot), p.facing < 0);
     }
 
     // new variable for collider box
@@ -333,34 +540,24 @@ void PlayerDraw(Player& p)
     drawPos.x = feetWorld.x;
     drawPos.y = feetWorld.y + (p.spriteSize.y * 0.5f) + p.spriteOffsetY;
 
-    // collider box
-    gfx::drawRectangle(p.pos, 0.0f, p.colliderSize, 0xAA00FF00); // green collider
     // drawing sprite mesh
     //gfx::drawRectangle(p.pos, 0.0f, p.size, 0xFFFF0000);
-    // draw using spriteSize (visual), and full height UVs (v0=0, v1=1)
-    gfx::drawSprite(tex, drawPos, 0.0f, p.spriteSize, u0, 0.0f, u1, 1.0f);
+    // draw using spriteSize (visual)
+    gfx::drawSpriteMesh(tex, mesh, drawPos, 0.0f, p.spriteSize);
+
+    // debug overlays: collider box, feet probe and velocity, state label
+    debugdraw::box(p.pos, p.colliderSize, 0xAA00FF00, debugdraw::Category::Colliders);
+    debugdraw::circle(feetWorld, 4.0f, p.grounded ? 0xFF00FF00 : 0xFFFF4040, debugdraw::Category::Probes, 8);
+    debugdraw::arrow(p.pos, gfx::Vec2{ p.pos.x + p.horzSpeed * p.speed * 0.1f, p.pos.y + p.velY * 0.1f },
+        0xFFFFFF00, debugdraw::Category::Probes);
+    debugdraw::text(gfx::Vec2{ p.pos.x - p.colliderSize.x, p.pos.y + p.spriteSize.y * 0.5f }, 0xFFFFFFFF,
+        "%s%s vy %.0f", p.grounded ? "ground" : "air", p.fixedPhysics ? " fx" : "", p.velY);
 }
 
 void PlayerShutdown(Player& p)
 {
-    if (p.idleTex)
-    {
-        AEGfxTextureUnload(p.idleTex);
-        p.idleTex = nullptr;
-    }
-    if (p.runTex)
-    {
-        AEGfxTextureUnload(p.runTex);
-        p.runTex = nullptr;
-    }
-    if (p.jumpTex)
-    {
-        AEGfxTextureUnload(p.jumpTex);
-        p.jumpTex = nullptr;
-    }
-    if (p.fallTex)
-    {
-        AEGfxTextureUnload(p.fallTex);
-        p.fallTex = nullptr;
-    }
-}
\ No newline at end of file
+    // the clips, atlas and slot belong to the set and animator owner
+    PlayerUnwatchAnimations(p);
+    p.anims = nullptr;
+    p.animator = nullptr;
+}
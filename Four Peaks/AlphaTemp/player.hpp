@@ -3,6 +3,40 @@
 
 #include "graphics.hpp"
 #include "AEEngine.h"
+#include "animation.hpp"
+#include "fixed.hpp"
+#include "resource_cache.hpp"
+#include <vector>
+
+// Fixed-point physics steps at this rate, independent of the frame rate.
+static const int kPlayerTickHz = 120;
+
+// One tick's worth of input. Replays record and feed these.
+struct PlayerInput
+{
+    s32 moveX;         // -1, 0, +1
+    bool jumpPressed;  // unused press within the jump buffer at this tick
+    bool jumpHeld;
+};
+
+// Kinematics in 48.16 (see PlayerSetFixedPhysics). Tunables are converted
+// once when the mode is switched on.
+struct PlayerFixed
+{
+    game::FixedVec2 pos;
+    game::Fixed velY;
+    game::Fixed horzSpeed;
+    game::Fixed coyoteTimer;
+    bool grounded;
+
+    game::Fixed speed;
+    game::Fixed gravity;
+    game::Fixed terminalVel;
+    game::Fixed jumpVel;
+    game::Fixed coyoteTime;
+    game::Fixed jumpCutMult;
+    game::Fixed halfColliderH;
+};
 
 // Player data
 struct Player
@@ -23,46 +57,25 @@ struct Player
     f32 coyoteTime;   // how long coyote lasts
     f32 coyoteTimer;  // counts down after leaving ground
 
-    f32 jumpCutMult; // extra gravity when jump not held
-
-    // ======== IDLE ANIMATION ==========
-    AEGfxTexture* idleTex;
-
-    int idleFrame;
-    int idleFrameCount;
-
-    f32 idleAnimTimer;
-    f32 idleFrameTime; // seconds per frame (e.g. 0.10f)
+    f32 jumpBufferTime; // a jump pressed this long before landing still fires
 
-    // ======== RUN ANIMATION ==========
-    AEGfxTexture* runTex;
-
-    int runFrame;
-    int runFrameCount;
-
-    f32 runAnimTimer;
-    f32 runFrameTime;
+    f32 jumpCutMult; // extra gravity when jump not held
 
     // Facing direction: +1 = right, -1 = left
     int facing;
 
-    // ======== JUMP ANIMATION ==========
-    AEGfxTexture* jumpTex;
-
-    int jumpFrame;
-    int jumpFrameCount;
-
-    f32 jumpAnimTimer;
-    f32 jumpFrameTime;
-
-    // ======== FALL ANIMATION ==========
-    AEGfxTexture* fallTex;
-
-    int fallFrame;
-    int fallFrameCount;
-
-    f32 fallAnimTimer;
-    f32 fallFrameTime;
+    // ======== ANIMATION ==========
+    // Clips come from the .anim data (PlayerBindAnimations). PlayerUpdate
+    // picks one from the movement state; the animator advances it along
+    // with everything else that uses the set.
+    const game::AnimationSet* anims;
+    game::Animator* animator;
+    u32 animSlot;
+    int clipIdle;
+    int clipRun;
+    int clipJump;
+    int clipFall;
+    std::vector<int> animWatches;   // hot reload: the .anim source and its sheets
 
     // ======== COLLIDER BOX ==========
     gfx::Vec2 colliderSize;  // physics box size (used for grounded/collision)
@@ -70,6 +83,15 @@ struct Player
 
     // optional: small tweak if your art has padding
     float spriteOffsetY;     // visual feet adjustment (usually a small number)
+
+    // ======== FIXED-POINT PHYSICS ==========
+    // Off: f32 physics driven by the frame dt. On: kinematics step in fx at
+    // kPlayerTickHz, bit-identical on every machine (replays, ghosts);
+    // pos / velY / horzSpeed / grounded mirror fx for drawing.
+    bool fixedPhysics;
+    PlayerFixed fx;
+    f32 tickAccumulator;   // real time not yet simulated
+    u32 tick;              // fixed ticks since switched on
 };
 
 // function declarations (NO function bodies here)
@@ -78,6 +100,28 @@ void PlayerUpdate(Player& p, float dt);
 void PlayerDraw(Player& p);
 void PlayerShutdown(Player& p);
 
+// fixed-point mode: switching on converts the current state; one
+// PlayerStepFixed() is one tick with the given input
+void PlayerSetFixedPhysics(Player& p, bool enabled);
+// returns true if it jumped (the buffered press is used up)
+bool PlayerStepFixed(Player& p, const PlayerInput& in);
+// input for the tick ending at tickEnd (input::now() clock); updates facing
+PlayerInput PlayerReadInput(Player& p, f64 tickEnd);
+u32 PlayerFixedChecksum(const Player& p); // compare replays tick by tick
+
+// puts the player's feet at `feet`, standing still (level start)
+void PlayerPlace(Player& p, gfx::Vec2 feet);
+
+// the .anim data lives in the ResourceCache: declare it with the owning
+// state's resources and bind the animations once it is resident (the set
+// owns the frame atlas)
+void PlayerDeclareResources(std::vector<game::ResourceRequest>& out);
+// loads the clips into set if it is empty and takes a slot in animator;
+// with hot reload, edits to the .anim source or its sheets replace the set
+// at a frame boundary (PlayerShutdown stops watching)
+void PlayerBindAnimations(Player& p, game::AnimationSet& set, game::Animator& animator,
+    const game::ResourceCache& cache);
+
 #endif
 
 
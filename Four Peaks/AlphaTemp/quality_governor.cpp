@@ -0,0 +1,164 @@
+// ---------------------------------------------------------------------------
+// quality_governor.cpp
+// ---------------------------------------------------------------------------
+
+#include "quality_governor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace quality
+{
+    namespace
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        const int kWindow = 32;             // frames in the recent average
+        const f64 kOverBudget = 0.95;       // of budget; above this sheds
+        const f64 kUnderBudget = 0.75;      // average below this recovers
+        const f32 kDropGain = 0.25f;        // level shed per budget of overrun
+        const f32 kMinDrop = 0.05f;
+        const f32 kRecoverPerSecond = 0.1f; // full recovery takes ten seconds
+        const f64 kRecoverDelay = 1.0;      // seconds after a drop before climbing
+
+        struct Knob
+        {
+            int handle;
+            const char* name;
+            int priority;
+            Apply apply;
+            f32 applied;        // last level passed to apply()
+        };
+
+        std::vector<Knob> gKnobs;       // lowest priority first
+        int gNextHandle = 1;
+
+        f64 gBudget = kDefaultBudget;
+        f32 gLevel = 1.0f;
+        f64 gTimes[kWindow];
+        int gCount = 0;
+        int gHead = 0;
+        f64 gSinceDrop = kRecoverDelay;
+        Clock::time_point gBegin = Clock::now();
+        Clock::time_point gLastEnd = Clock::now();
+
+        f32 knobLevel(size_t rank)
+        {
+            const f32 n = static_cast<f32>(gKnobs.size());
+            const f32 l = gLevel * n - (n - 1.0f - static_cast<f32>(rank));
+            return l < 0.0f ? 0.0f : (l > 1.0f ? 1.0f : l);
+        }
+
+        void applyKnobs(bool force)
+        {
+            for (size_t i = 0; i < gKnobs.size(); ++i)
+            {
+                Knob& k = gKnobs[i];
+                const f32 l = knobLevel(i);
+                if (force || l != k.applied)
+                {
+                    k.applied = l;
+                    k.apply(l);
+                }
+            }
+        }
+
+        f64 recent(int back)
+        {
+            return gTimes[(gHead - 1 - back + kWindow) % kWindow];
+        }
+    }
+
+    int addKnob(const char* name, int priority, Apply apply)
+    {
+        Knob knob{ gNextHandle++, name, priority, apply, -1.0f };
+        auto at = std::upper_bound(gKnobs.begin(), gKnobs.end(), priority,
+            [](int p, const Knob& k) { return p < k.priority; });
+        gKnobs.insert(at, knob);
+
+        // Bands moved; bring everyone in line.
+        applyKnobs(false);
+        return knob.handle;
+    }
+
+    void removeKnob(int handle)
+    {
+        gKnobs.erase(std::remove_if(gKnobs.begin(), gKnobs.end(),
+            [handle](const Knob& k) { return k.handle == handle; }), gKnobs.end());
+        applyKnobs(false);
+    }
+
+    void setBudget(f64 seconds)
+    {
+        gBudget = seconds > 0.0 ? seconds : kDefaultBudget;
+    }
+
+    f32 level()
+    {
+        return gLevel;
+    }
+
+    f64 budget()
+    {
+        return gBudget;
+    }
+
+    f64 frameElapsed()
+    {
+        return std::chrono::duration<f64>(Clock::now() - gBegin).count();
+    }
+
+    f64 averageFrameTime()
+    {
+        if (gCount == 0)
+            return 0.0;
+        f64 sum = 0.0;
+        for (int i = 0; i < gCount; ++i)
+            sum += gTimes[i];
+        return sum / gCount;
+    }
+
+    void frameBegin()
+    {
+        gBegin = Clock::now();
+    }
+
+    // -------------------------------------------------------------------
+    // frameEnd
+    // -------------------------------------------------------------------
+    void frameEnd()
+    {
+        const Clock::time_point now = Clock::now();
+        const f64 t = std::chrono::duration<f64>(now - gBegin).count();
+        const f64 wall = std::chrono::duration<f64>(now - gLastEnd).count();
+        gLastEnd = now;
+
+        gTimes[gHead] = t;
+        gHead = (gHead + 1) % kWindow;
+        if (gCount < kWindow)
+            ++gCount;
+        gSinceDrop += wall;
+
+        const f64 worst = gCount > 1 ? std::max(recent(0), recent(1)) : t;
+        if (worst > gBudget * kOverBudget)
+        {
+            // Spike: shed now, more for a bigger overrun.
+            const f32 drop = std::max(kMinDrop, kDropGain * static_cast<f32>(worst / gBudget - kOverBudget));
+            gLevel = std::max(0.0f, gLevel - drop);
+            gSinceDrop = 0.0;
+
+            // The frames that caused it shouldn't count twice.
+            for (int i = 0; i < gCount; ++i)
+                gTimes[i] = std::min(gTimes[i], gBudget * kOverBudget);
+        }
+        else if (gSinceDrop >= kRecoverDelay && gCount == kWindow &&
+            averageFrameTime() < gBudget * kUnderBudget)
+        {
+            // Long gaps (idle screens, a stall) don't count as time spent
+            // running well.
+            gLevel = std::min(1.0f, gLevel + kRecoverPerSecond * static_cast<f32>(std::min(wall, 0.1)));
+        }
+
+        applyKnobs(false);
+    }
+}
@@ -0,0 +1,51 @@
+// ---------------------------------------------------------------------------
+// quality_governor.hpp
+// ---------------------------------------------------------------------------
+//
+// Scales optional work to keep frames inside the frame-time budget.
+//
+// The governor times each frame's busy part (frameBegin() after the pacer's
+// wait, frameEnd() after AESysFrameEnd) and keeps one quality level in
+// [0, 1]. When either of the last two frames goes over budget the level
+// drops at once, in proportion to the overrun; once the recent average has
+// been comfortably under budget for a while it climbs back slowly.
+//
+// Systems with optional work (particle caps, light map resolution, parallax
+// layers, stream look-ahead, ...) register a knob. Knobs are shed in order
+// of priority: the level is split into one band per knob and the lowest
+// priority knob goes all the way down before the next one starts to move.
+// apply() gets the knob's own level in [0, 1] and picks the setting.
+//
+// Main thread only.
+//
+
+#ifndef QUALITY_GOVERNOR_HPP
+#define QUALITY_GOVERNOR_HPP
+
+#include "AEEngine.h"
+#include <functional>
+
+namespace quality
+{
+    typedef std::function<void(f32 level)> Apply;
+
+    static const f64 kDefaultBudget = 1.0 / 60.0;
+
+    // Called once right away with the current level. Higher priority
+    // knobs are kept longer. Returns a handle for removeKnob().
+    int addKnob(const char* name, int priority, Apply apply);
+    void removeKnob(int handle);
+
+    void setBudget(f64 seconds);
+
+    // Around the frame's work, outside the pacer's wait.
+    void frameBegin();
+    void frameEnd();
+
+    f32 level();
+    f64 averageFrameTime();     // seconds, over the recent window
+    f64 budget();
+    f64 frameElapsed();         // seconds since frameBegin()
+}
+
+#endif // QUALITY_GOVERNOR_HPP
@@ -0,0 +1,154 @@
+// ---------------------------------------------------------------------------
+// render_queue.cpp
+// ---------------------------------------------------------------------------
+
+#include "render_queue.hpp"
+#include "view.hpp"
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+namespace gfx
+{
+    namespace
+    {
+        struct Item
+        {
+            Material material;
+            AEGfxVertexList* mesh;
+            Mat2x3 transform;
+            s32 layer;
+            u32 order;      // submission index, breaks ties
+        };
+
+        std::vector<Item> gOpaque;
+        std::vector<Item> gBlended;
+        std::vector<AEGfxVertexList*> gTransient;
+        u32 gOrder = 0;
+
+        // What AE was last told, so unchanged state isn't sent again.
+        struct Cache
+        {
+            AEGfxBlendMode blend;
+            AEGfxRenderMode mode;
+            AEGfxTexture* texture;
+            u32 color;
+            f32 transparency;
+        };
+
+        void issue(const Item& item, const Mat2x3& worldToScreen, bool blend, Cache& cache)
+        {
+            const Material& m = item.material;
+            const AEGfxBlendMode bm = !blend ? AE_GFX_BM_NONE :
+                m.opacity == Opacity::Multiplied ? AE_GFX_BM_MULTIPLY : AE_GFX_BM_BLEND;
+            if (cache.blend != bm)
+            {
+                AEGfxSetBlendMode(bm);
+                cache.blend = bm;
+            }
+
+            const AEGfxRenderMode rm = m.texture ? AE_GFX_RM_TEXTURE : AE_GFX_RM_COLOR;
+            if (cache.mode != rm)
+            {
+                AEGfxSetRenderMode(rm);
+                cache.mode = rm;
+            }
+            if (m.texture && cache.texture != m.texture)
+            {
+                AEGfxTextureSet(m.texture, 0, 0);
+                cache.texture = m.texture;
+            }
+            if (cache.color != m.color)
+            {
+                const u32 c = m.color;
+                AEGfxSetBlendColor(((c >> 16) & 0xFF) / 255.0f, ((c >> 8) & 0xFF) / 255.0f,
+                    (c & 0xFF) / 255.0f, ((c >> 24) & 0xFF) / 255.0f);
+                cache.color = c;
+            }
+            if (cache.transparency != m.transparency)
+            {
+                AEGfxSetTransparency(m.transparency);
+                cache.transparency = m.transparency;
+            }
+
+            AEMtx33 t = toAE(worldToScreen * item.transform);
+            AEGfxSetTransform(t.m);
+            AEGfxMeshDraw(item.mesh, AE_GFX_MDM_TRIANGLES);
+        }
+    }
+
+    void submit(const Material& material, AEGfxVertexList* mesh, const Mat2x3& transform, s32 layer)
+    {
+        if (!mesh)
+            return;
+
+        Item item{ material, mesh, transform, layer, gOrder++ };
+        if (material.opacity == Opacity::Opaque)
+            gOpaque.push_back(item);
+        else
+            gBlended.push_back(item);
+    }
+
+    void releaseAfterFlush(AEGfxVertexList* mesh)
+    {
+        if (mesh)
+            gTransient.push_back(mesh);
+    }
+
+    // -------------------------------------------------------------------
+    // flushQueue
+    // -------------------------------------------------------------------
+    void flushQueue()
+    {
+        // Opaque draws above the lowest blended layer have to be sorted in
+        // with the blended ones.
+        s32 lowestBlended = INT_MAX;
+        for (const Item& item : gBlended)
+            lowestBlended = std::min(lowestBlended, item.layer);
+
+        auto above = std::partition(gOpaque.begin(), gOpaque.end(),
+            [lowestBlended](const Item& item) { return item.layer <= lowestBlended; });
+        gBlended.insert(gBlended.end(), above, gOpaque.end());
+        gOpaque.erase(above, gOpaque.end());
+
+        std::sort(gOpaque.begin(), gOpaque.end(), [](const Item& a, const Item& b)
+        {
+            if (a.layer != b.layer)
+                return a.layer < b.layer;
+            if (a.material.texture != b.material.texture)
+                return a.material.texture < b.material.texture;
+            return a.order < b.order;
+        });
+        std::sort(gBlended.begin(), gBlended.end(), [](const Item& a, const Item& b)
+        {
+            if (a.layer != b.layer)
+                return a.layer < b.layer;
+            const bool ao = a.material.opacity == Opacity::Opaque;
+            const bool bo = b.material.opacity == Opacity::Opaque;
+            if (ao != bo)
+                return ao;      // opaque under blended within a layer
+            return a.order < b.order;
+        });
+
+        // Force the first draw to set everything.
+        Cache cache{ AE_GFX_BM_NUM, AE_GFX_RM_NUM, nullptr, 0, -1.0f };
+        AEGfxSetBlendColor(0.0f, 0.0f, 0.0f, 0.0f);
+        cache.color = 0;
+        AEGfxSetColorToMultiply(1.0f, 1.0f, 1.0f, 1.0f);
+        AEGfxSetColorToAdd(0.0f, 0.0f, 0.0f, 0.0f);
+
+        const Mat2x3& worldToScreen = view::metrics().worldToScreen;
+        for (const Item& item : gOpaque)
+            issue(item, worldToScreen, false, cache);
+        for (const Item& item : gBlended)
+            issue(item, worldToScreen, item.material.opacity != Opacity::Opaque, cache);
+
+        gOpaque.clear();
+        gBlended.clear();
+        gOrder = 0;
+
+        for (AEGfxVertexList* mesh : gTransient)
+            AEGfxMeshFree(mesh);
+        gTransient.clear();
+    }
+}
@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------------
+// render_queue.hpp
+// ---------------------------------------------------------------------------
+//
+// Frame draw list with separate opaque and blended passes.
+//
+// Draws are submitted in world coordinates (view.hpp maps them to the
+// window) with a Material, which says whether the mesh is opaque, and a
+// layer (back to front). flushQueue() then issues them in two
+// passes:
+//
+//   opaque   blending off, grouped by texture within a layer, so the GPU
+//            doesn't read back pixels it is about to cover and AE state
+//            changes once per group instead of once per draw
+//   blended  sorted back to front by layer, then submission order;
+//            Multiplied draws go here too, with AE's multiply blend
+//
+// There is no depth buffer, so an opaque draw on a layer above the lowest
+// blended one would end up under it; those few are moved into the sorted
+// pass (still with blending off). Within a layer opaque draws go under
+// blended ones and must not overlap each other (their order isn't kept).
+//
+// The gfx:: helpers (drawRectangle, drawSpriteMesh, ...) and TileRenderer
+// submit here; main flushes once after the state has drawn. A state that
+// prints text over its geometry flushes first.
+//
+
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include "AEEngine.h"
+#include "math2d.hpp"
+
+namespace gfx
+{
+    // Draw layers, back to front. Gaps leave room for more.
+    static const s32 kLayerBackground = 0;
+    static const s32 kLayerTiles = 100;
+    static const s32 kLayerEntities = 200;
+    static const s32 kLayerLighting = 250;
+    static const s32 kLayerOverlay = 300;
+
+    enum class Opacity : u8
+    {
+        Opaque,         // every pixel covers what's behind it
+        Blended,        // alpha blended; drawn back to front
+        Multiplied      // multiplies what's behind it (light maps); sorted
+                        // like Blended
+    };
+
+    struct Material
+    {
+        AEGfxTexture* texture;  // nullptr = color only
+        u32 color;              // ARGB blend color; alpha 0 = vertex colors as is
+        f32 transparency;
+        Opacity opacity;
+    };
+
+    // One color over the whole mesh; opaque when alpha is 255.
+    inline Material flatColor(u32 argb)
+    {
+        const u32 a = argb >> 24;
+        return Material{ nullptr, argb, a / 255.0f, a == 0xFF ? Opacity::Opaque : Opacity::Blended };
+    }
+
+    // Colors baked into the vertices (tile chunks).
+    inline Material vertexColors(Opacity opacity)
+    {
+        return Material{ nullptr, 0, 1.0f, opacity };
+    }
+
+    inline Material textured(AEGfxTexture* tex, Opacity opacity)
+    {
+        return Material{ tex, 0, 1.0f, opacity };
+    }
+
+    // The mesh must stay alive until the next flushQueue().
+    void submit(const Material& material, AEGfxVertexList* mesh, const Mat2x3& transform, s32 layer);
+
+    // Draws everything submitted since the last flush and empties the list.
+    void flushQueue();
+
+    // Frees mesh after the next flush (one-off meshes of immediate helpers).
+    void releaseAfterFlush(AEGfxVertexList* mesh);
+}
+
+#endif // RENDER_QUEUE_HPP
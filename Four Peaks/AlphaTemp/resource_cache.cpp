@@ -0,0 +1,374 @@
+// ---------------------------------------------------------------------------
+// resource_cache.cpp
+// ---------------------------------------------------------------------------
+
+#include "resource_cache.hpp"
+#include "asset_pack.hpp"
+#include "deferred.hpp"
+#include "hot_reload.hpp"
+#include "vfs_loaders.hpp"
+#include <chrono>
+
+namespace game
+{
+    ResourceCache::ResourceCache(JobSystem& jobSystem)
+        : nextTicket(0)
+        , jobs(jobSystem)
+    {
+    }
+
+    // Unused resources linger this long at most before they are unloaded
+    // whether or not a frame has slack.
+    static const f64 kEvictDeadline = 2.0;
+
+    ResourceCache::~ResourceCache()
+    {
+        // Queued jobs and evictions point back at us.
+        deferred::cancel(this);
+        waitIdle();
+    }
+
+    void ResourceCache::waitIdle()
+    {
+        jobs.wait(inFlight);
+    }
+
+    // -------------------------------------------------------------------
+    // acquire / release
+    // -------------------------------------------------------------------
+    void ResourceCache::acquire(const ResourceRequest& request)
+    {
+        const Key key = makeKey(request);
+        std::unique_ptr<Entry>& slot = entries[key];
+        if (!slot)
+        {
+            slot.reset(new Entry());
+            queueLoad(key, *slot);
+        }
+        slot->refs++;
+    }
+
+    void ResourceCache::release(const ResourceRequest& request)
+    {
+        auto it = entries.find(makeKey(request));
+        if (it == entries.end())
+            return;
+
+        if (--it->second->refs > 0)
+            return;
+
+        if (it->second->state == EntryState::Resident)
+        {
+            const Key key = it->first;
+            deferred::submit("resource eviction", deferred::Priority::Low, kEvictDeadline,
+                [this, key]() { return evict(key); }, this);
+            return;
+        }
+
+        // An outstanding load finds no entry when it comes back and is
+        // dropped; a prepared one is skipped by update().
+        unload(*it->second);
+        entries.erase(it);
+    }
+
+    // Deferred task; does nothing if the resource was acquired again.
+    bool ResourceCache::evict(const Key& key)
+    {
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second->refs == 0)
+        {
+            unload(*it->second);
+            entries.erase(it);
+        }
+        return true;
+    }
+
+    bool ResourceCache::acquireNow(const ResourceRequest& request)
+    {
+        acquire(request);
+
+        const Key key = makeKey(request);
+        Entry& entry = *entries[key];
+
+        if (entry.state == EntryState::Loading)
+        {
+            // Do the loader's part here; new ticket so the queued copy is
+            // ignored when it finishes.
+            entry.ticket = ++nextTicket;
+            entry.prepared.reset(new Prepared());
+            entry.prepared->key = key;
+            entry.prepared->ticket = entry.ticket;
+            prepare(*entry.prepared);
+            entry.state = EntryState::Prepared;
+        }
+        if (entry.state == EntryState::Prepared)
+            finish(key, entry);
+
+        return entry.state == EntryState::Resident;
+    }
+
+    // -------------------------------------------------------------------
+    // queries
+    // -------------------------------------------------------------------
+    bool ResourceCache::ready(const ResourceRequest& request) const
+    {
+        auto it = entries.find(makeKey(request));
+        return it != entries.end() &&
+            (it->second->state == EntryState::Resident || it->second->state == EntryState::Failed);
+    }
+
+    size_t ResourceCache::readyCount(const std::vector<ResourceRequest>& requests) const
+    {
+        size_t count = 0;
+        for (const ResourceRequest& r : requests)
+        {
+            if (ready(r))
+                ++count;
+        }
+        return count;
+    }
+
+    bool ResourceCache::ready(const std::vector<ResourceRequest>& requests) const
+    {
+        for (const ResourceRequest& r : requests)
+        {
+            if (!ready(r))
+                return false;
+        }
+        return true;
+    }
+
+    AEGfxTexture* ResourceCache::texture(AssetId id) const
+    {
+        auto it = entries.find(Key{ id.value(), ResourceKind::Texture, 0 });
+        return it != entries.end() ? it->second->texture : nullptr;
+    }
+
+    s8 ResourceCache::font(AssetId id, int size) const
+    {
+        auto it = entries.find(Key{ id.value(), ResourceKind::Font, size });
+        return it != entries.end() ? it->second->fontId : static_cast<s8>(-1);
+    }
+
+    const vfs::File* ResourceCache::data(AssetId id) const
+    {
+        auto it = entries.find(Key{ id.value(), ResourceKind::Data, 0 });
+        return it != entries.end() ? it->second->file.get() : nullptr;
+    }
+
+    size_t ResourceCache::residentCount() const
+    {
+        size_t count = 0;
+        for (const auto& kv : entries)
+        {
+            if (kv.second->state == EntryState::Resident)
+                ++count;
+        }
+        return count;
+    }
+
+    size_t ResourceCache::pendingCount() const
+    {
+        size_t count = 0;
+        for (const auto& kv : entries)
+        {
+            if (kv.second->state == EntryState::Loading || kv.second->state == EntryState::Prepared)
+                ++count;
+        }
+        return count;
+    }
+
+    // -------------------------------------------------------------------
+    // update - main thread
+    // -------------------------------------------------------------------
+    void ResourceCache::update(f64 budgetSeconds)
+    {
+        collectResults();
+
+        typedef std::chrono::steady_clock Clock;
+        const Clock::time_point start = Clock::now();
+
+        while (!finishQueue.empty())
+        {
+            const Key key = finishQueue.front();
+            finishQueue.pop_front();
+
+            auto it = entries.find(key);
+            if (it == entries.end() || it->second->state != EntryState::Prepared)
+                continue;   // released while waiting
+
+            finish(key, *it->second);
+
+            if (std::chrono::duration<f64>(Clock::now() - start).count() >= budgetSeconds)
+                break;
+        }
+    }
+
+    void ResourceCache::clear()
+    {
+        // Also waits out jobs in flight, so the VFS can be unmounted right
+        // after this returns.
+        waitIdle();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            results.clear();
+        }
+        deferred::cancel(this);
+        for (auto& kv : entries)
+            unload(*kv.second);
+        entries.clear();
+        finishQueue.clear();
+    }
+
+    // -------------------------------------------------------------------
+    // loading
+    // -------------------------------------------------------------------
+    void ResourceCache::queueLoad(const Key& key, Entry& entry)
+    {
+        entry.state = EntryState::Loading;
+        entry.ticket = ++nextTicket;
+
+        Prepared* job = new Prepared();
+        job->key = key;
+        job->ticket = entry.ticket;
+        job->ok = false;
+
+        jobs.run([this, job]()
+        {
+            std::unique_ptr<Prepared> owned(job);
+            prepare(*owned);
+
+            std::lock_guard<std::mutex> guard(lock);
+            results.push_back(std::move(owned));
+        }, &inFlight);
+    }
+
+    // -------------------------------------------------------------------
+    // prepare - job (or acquireNow). No AE calls in here.
+    // -------------------------------------------------------------------
+    void ResourceCache::prepare(Prepared& job)
+    {
+        const AssetId id(job.key.id);
+        job.ok = false;
+
+        switch (job.key.kind)
+        {
+        case ResourceKind::Texture:
+        {
+            // Cooked textures upload straight from the entry; anything else
+            // is handed to AE by file name.
+            job.file.reset(new vfs::File());
+            if (vfs::open(id, *job.file) && job.file->type() == static_cast<u16>(PackEntryType::Texture))
+            {
+                job.ok = true;
+                break;
+            }
+            job.file.reset();
+            job.path = vfs::resolvePath(id);
+            job.ok = !job.path.empty();
+        }
+        break;
+
+        case ResourceKind::Font:
+            job.path = vfs::resolvePath(id);
+            job.ok = !job.path.empty();
+            break;
+
+        case ResourceKind::Data:
+        {
+            job.file.reset(new vfs::File());
+            job.ok = vfs::open(id, *job.file);
+
+            // Touch every page so the first real read doesn't fault.
+            volatile u8 sink = 0;
+            for (size_t i = 0; job.ok && i < job.file->size(); i += 4096)
+                sink = static_cast<u8>(sink + job.file->data()[i]);
+        }
+        break;
+        }
+    }
+
+    void ResourceCache::collectResults()
+    {
+        std::vector<std::unique_ptr<Prepared>> done;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            done.swap(results);
+        }
+
+        for (std::unique_ptr<Prepared>& job : done)
+        {
+            auto it = entries.find(job->key);
+            if (it == entries.end() || it->second->state != EntryState::Loading ||
+                it->second->ticket != job->ticket)
+                continue;   // released (or reloaded) since it was queued
+
+            it->second->prepared = std::move(job);
+            it->second->state = EntryState::Prepared;
+            finishQueue.push_back(it->first);
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // finish - main thread: the parts that need the renderer
+    // -------------------------------------------------------------------
+    bool ResourceCache::finish(const Key& key, Entry& entry)
+    {
+        std::unique_ptr<Prepared> job = std::move(entry.prepared);
+        bool ok = job && job->ok;
+
+        if (ok)
+        {
+            switch (key.kind)
+            {
+            case ResourceKind::Texture:
+                entry.texture = job->file ? vfs::textureFromFile(*job->file) : nullptr;
+                if (!entry.texture && !job->path.empty())
+                    entry.texture = AEGfxTextureLoad(job->path.c_str());
+                ok = entry.texture != nullptr;
+
+                // Swap in place when the source changes (debug builds).
+                if (ok)
+                    entry.watch = hotreload::watchTexture(AssetId(key.id), &entry.texture);
+                break;
+
+            case ResourceKind::Font:
+                entry.fontId = AEGfxCreateFont(job->path.c_str(), key.param);
+                ok = entry.fontId >= 0;
+                break;
+
+            case ResourceKind::Data:
+                entry.file = std::move(job->file);
+                break;
+            }
+        }
+
+        if (!ok)
+        {
+            const char* name = assetName(AssetId(key.id));
+            PRINT("ResourceCache: failed to load %s\n", name ? name : "(unnamed asset)");
+        }
+
+        entry.state = ok ? EntryState::Resident : EntryState::Failed;
+        return ok;
+    }
+
+    void ResourceCache::unload(Entry& entry)
+    {
+        hotreload::unwatch(entry.watch);
+        entry.watch = 0;
+
+        if (entry.texture)
+        {
+            AEGfxTextureUnload(entry.texture);
+            entry.texture = nullptr;
+        }
+        if (entry.fontId >= 0)
+        {
+            AEGfxDestroyFont(entry.fontId);
+            entry.fontId = -1;
+        }
+        entry.file.reset();
+        entry.prepared.reset();
+    }
+}
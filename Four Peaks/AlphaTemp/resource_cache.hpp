@@ -0,0 +1,157 @@
+// ---------------------------------------------------------------------------
+// resource_cache.hpp
+// ---------------------------------------------------------------------------
+//
+// Reference counted Alpha Engine resources, loaded in the background.
+//
+// acquire() bumps a resource's count and, if it isn't resident yet, queues
+// it on the job system. The jobs do everything that doesn't need the
+// renderer: opening / decompressing the VFS entry, extracting fonts, paging
+// in level data, so independent loads run in parallel. update() then
+// finishes prepared loads on the main thread (GPU upload, font creation)
+// within a per-frame time budget, so a large preload never causes a hitch.
+//
+// release() drops the count. At zero a resident resource is unloaded by a
+// low-priority deferred task, in the slack of a later frame, so a state
+// change doesn't pay for the old state's unloads; acquiring it again before
+// then is free. Anything not resident yet is dropped straight away. Acquire
+// the next owner's resources before releasing the old owner's and anything
+// both use stays resident.
+//
+// Textures owned by the cache are hot reloaded in place (debug builds), so
+// look them up with texture() rather than holding on to the pointer.
+//
+
+#ifndef RESOURCE_CACHE_HPP
+#define RESOURCE_CACHE_HPP
+
+#include "AEEngine.h"
+#include "asset_id.hpp"
+#include "job_system.hpp"
+#include "vfs.hpp"
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace game
+{
+    enum class ResourceKind : u8
+    {
+        Texture,
+        Font,       // param = point size
+        Data        // raw bytes kept open and paged in (levels, ...)
+    };
+
+    struct ResourceRequest
+    {
+        AssetId id;
+        ResourceKind kind;
+        int param;
+
+        static ResourceRequest texture(AssetId id) { return ResourceRequest{ id, ResourceKind::Texture, 0 }; }
+        static ResourceRequest font(AssetId id, int size) { return ResourceRequest{ id, ResourceKind::Font, size }; }
+        static ResourceRequest data(AssetId id) { return ResourceRequest{ id, ResourceKind::Data, 0 }; }
+    };
+
+    class ResourceCache
+    {
+    public:
+        explicit ResourceCache(JobSystem& jobSystem);
+        ~ResourceCache();
+        ResourceCache(const ResourceCache&) = delete;
+        ResourceCache& operator=(const ResourceCache&) = delete;
+
+        void acquire(const ResourceRequest& request);
+        void release(const ResourceRequest& request);
+
+        // Acquires and blocks until resident (boot-time loads).
+        bool acquireNow(const ResourceRequest& request);
+
+        // Resident, or failed to load (a missing asset never blocks a
+        // transition; its lookups just return nothing).
+        bool ready(const ResourceRequest& request) const;
+        bool ready(const std::vector<ResourceRequest>& requests) const;
+        // How many of requests are ready (progress bars).
+        size_t readyCount(const std::vector<ResourceRequest>& requests) const;
+
+        // nullptr / -1 if not resident.
+        AEGfxTexture* texture(AssetId id) const;
+        s8 font(AssetId id, int size) const;
+        const vfs::File* data(AssetId id) const;
+
+        // Main thread, once per frame: finishes prepared loads until the
+        // budget is used up (at least one per frame).
+        void update(f64 budgetSeconds = 0.002);
+
+        // Unloads everything regardless of counts. Call before AESysExit;
+        // the destructor only waits for loads still running as jobs.
+        void clear();
+
+        size_t residentCount() const;
+        size_t pendingCount() const;
+
+    private:
+        struct Key
+        {
+            u64 id;
+            ResourceKind kind;
+            int param;
+
+            bool operator<(const Key& o) const
+            {
+                if (id != o.id) return id < o.id;
+                if (kind != o.kind) return kind < o.kind;
+                return param < o.param;
+            }
+        };
+
+        // Job output, consumed on the main thread.
+        struct Prepared
+        {
+            Key key;
+            u32 ticket;
+            bool ok;
+            std::unique_ptr<vfs::File> file;    // texture pixels / data bytes
+            std::string path;                   // for loaders that need a file name
+        };
+
+        enum class EntryState : u8 { Loading, Prepared, Resident, Failed };
+
+        struct Entry
+        {
+            int refs = 0;
+            EntryState state = EntryState::Loading;
+            u32 ticket = 0;         // matches the outstanding load
+            std::unique_ptr<Prepared> prepared;
+
+            AEGfxTexture* texture = nullptr;
+            s8 fontId = -1;
+            std::unique_ptr<vfs::File> file;
+            int watch = 0;          // hot reload handle
+        };
+
+        std::map<Key, std::unique_ptr<Entry>> entries;   // main thread only
+        std::deque<Key> finishQueue;                     // prepared, waiting for budget
+        u32 nextTicket;
+
+        // job side
+        JobSystem& jobs;
+        JobCounter inFlight;    // prepare jobs not yet back
+        std::mutex lock;
+        std::vector<std::unique_ptr<Prepared>> results;
+
+        static Key makeKey(const ResourceRequest& r) { return Key{ r.id.value(), r.kind, r.param }; }
+
+        void queueLoad(const Key& key, Entry& entry);
+        void waitIdle();
+        static void prepare(Prepared& job);
+        void collectResults();
+        bool finish(const Key& key, Entry& entry);
+        void unload(Entry& entry);
+        bool evict(const Key& key);
+    };
+}
+
+#endif // RESOURCE_CACHE_HPP
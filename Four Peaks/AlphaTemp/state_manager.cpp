@@ -0,0 +1,220 @@
+// ---------------------------------------------------------------------------
+// state_manager.cpp
+// ---------------------------------------------------------------------------
+
+#include "state_manager.hpp"
+
+namespace game
+{
+    ResourceCache& State::resources() const
+    {
+        return manager->resources();
+    }
+
+    // ===================================================================
+    // StateManager
+    // ===================================================================
+
+    StateManager::StateManager(ResourceCache& resourceCache)
+        : cache(resourceCache)
+        , pending{ Op::None, StateId::MainMenu }
+        , uploadBudget(0.002)
+        , quitting(false)
+    {
+    }
+
+    void StateManager::add(StateId id, State& state)
+    {
+        Slot& s = slot(id);
+        s.state = &state;
+        s.resources.clear();
+        state.manager = this;
+        state.declareResources(s.resources);
+    }
+
+    // -------------------------------------------------------------------
+    // requests
+    // -------------------------------------------------------------------
+    void StateManager::change(StateId id)
+    {
+        request(Pending{ Op::Change, id });
+        preload(id);
+    }
+
+    void StateManager::push(StateId id)
+    {
+        request(Pending{ Op::Push, id });
+        preload(id);
+    }
+
+    void StateManager::pop()
+    {
+        request(Pending{ Op::Pop, StateId::MainMenu });
+    }
+
+    void StateManager::request(Pending next)
+    {
+        // A change / push replaced before it was applied never takes over
+        // its preload, so let go of it here.
+        const bool hadTarget = pending.op == Op::Change || pending.op == Op::Push;
+        if (hadTarget && (next.op == Op::Pop || next.target != pending.target))
+            cancelPreload(pending.target);
+        pending = next;
+    }
+
+    State* StateManager::current() const
+    {
+        return stack.empty() ? nullptr : slots[static_cast<int>(stack.back())].state;
+    }
+
+    // -------------------------------------------------------------------
+    // preload
+    // -------------------------------------------------------------------
+    void StateManager::preload(StateId id)
+    {
+        Slot& s = slot(id);
+        if (s.preloaded)
+            return;
+        for (StateId active : stack)
+        {
+            if (active == id)
+                return;   // already holds its resources
+        }
+
+        for (const ResourceRequest& r : s.resources)
+            cache.acquire(r);
+        s.preloaded = true;
+    }
+
+    void StateManager::cancelPreload(StateId id)
+    {
+        Slot& s = slot(id);
+        if (!s.preloaded)
+            return;
+
+        for (const ResourceRequest& r : s.resources)
+            cache.release(r);
+        s.preloaded = false;
+    }
+
+    void StateManager::acquire(StateId id)
+    {
+        Slot& s = slot(id);
+        if (s.preloaded)
+        {
+            s.preloaded = false;    // the preload reference carries over
+            return;
+        }
+        for (const ResourceRequest& r : s.resources)
+            cache.acquire(r);
+    }
+
+    void StateManager::release(StateId id)
+    {
+        for (const ResourceRequest& r : slot(id).resources)
+            cache.release(r);
+    }
+
+    // -------------------------------------------------------------------
+    // update / draw
+    // -------------------------------------------------------------------
+    void StateManager::update(float dt)
+    {
+        cache.update(uploadBudget);
+
+        if (pending.op != Op::None)
+            applyPending();
+
+        if (State* s = current())
+            s->update(dt);
+    }
+
+    void StateManager::draw() const
+    {
+        if (State* s = current())
+            s->draw();
+    }
+
+    // -------------------------------------------------------------------
+    // applyPending - false while the target is still loading
+    // -------------------------------------------------------------------
+    bool StateManager::applyPending()
+    {
+        if (pending.op == Op::Pop)
+        {
+            pending.op = Op::None;
+            if (stack.empty())
+                return true;
+
+            const StateId top = stack.back();
+            slot(top).state->exit();
+            stack.pop_back();
+            release(top);
+
+            if (State* s = current())
+                s->resume();
+            return true;
+        }
+
+        const StateId target = pending.target;
+        Slot& next = slot(target);
+        if (!next.state || (!stack.empty() && stack.back() == target))
+        {
+            cancelPreload(target);
+            pending.op = Op::None;
+            return true;
+        }
+
+        if (!cache.ready(next.resources))
+            return false;
+
+        acquire(target);
+
+        if (pending.op == Op::Push)
+        {
+            if (State* s = current())
+                s->suspend();
+            stack.push_back(target);
+            next.state->enter();
+        }
+        else
+        {
+            const bool hadOld = !stack.empty();
+            const StateId old = hadOld ? stack.back() : target;
+            if (hadOld)
+            {
+                slot(old).state->exit();
+                stack.pop_back();
+            }
+
+            stack.push_back(target);
+            next.state->enter();
+
+            // Released last so enter() can hold on to anything shared.
+            if (hadOld)
+                release(old);
+        }
+
+        pending.op = Op::None;
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // shutdown
+    // -------------------------------------------------------------------
+    void StateManager::shutdown()
+    {
+        while (!stack.empty())
+        {
+            const StateId top = stack.back();
+            slot(top).state->exit();
+            stack.pop_back();
+            release(top);
+        }
+
+        for (int i = 0; i < static_cast<int>(StateId::Count); ++i)
+            cancelPreload(static_cast<StateId>(i));
+
+        pending.op = Op::None;
+    }
+}
@@ -0,0 +1,150 @@
+// ---------------------------------------------------------------------------
+// state_manager.hpp
+// ---------------------------------------------------------------------------
+//
+// Stack of game states (menu, stages, ...).
+//
+// Each state declares the resources it needs; the manager acquires them from
+// the ResourceCache before the state is entered and releases them after it
+// exits. Transitions requested during a frame are applied at the start of the
+// next update(), once the target's resources are resident. Until then the
+// current state keeps running, so call preload() for the likely next state
+// (e.g. the menu preloads the first stage) and the switch itself takes a
+// single frame. A newer request replaces a pending one and releases the
+// replaced target's preload.
+//
+// Hooks, in order:
+//   change(B) from A:  B resources acquired -> A.exit() -> B.enter() ->
+//                      A resources released
+//   push(B) over A:    B resources acquired -> A.suspend() -> B.enter()
+//   pop() of B over A: B.exit() -> B resources released -> A.resume()
+//
+// Resources used by both A and B are never unloaded in between, and B.enter()
+// can preload A again (e.g. the menu preloading the stage it came from)
+// before A's resources are let go.
+//
+
+#ifndef STATE_MANAGER_HPP
+#define STATE_MANAGER_HPP
+
+#include "resource_cache.hpp"
+#include <vector>
+
+namespace game
+{
+    class StateManager;
+
+    enum class StateId
+    {
+        Loading,
+        MainMenu,
+        SummerS1,
+        Count
+    };
+
+    // -------------------------------------------------------------------
+    // State
+    // -------------------------------------------------------------------
+    class State
+    {
+    public:
+        virtual ~State() {}
+
+        // Everything this state needs resident while it is on the stack.
+        virtual void declareResources(std::vector<ResourceRequest>& out) const { (void)out; }
+
+        virtual void enter() {}
+        virtual void exit() {}
+        virtual void suspend() {}   // another state was pushed on top
+        virtual void resume() {}    // the state on top was popped
+
+        virtual void update(float dt) = 0;
+        virtual void draw() const = 0;
+
+        // False if the screen only changes in response to input; the frame
+        // pacer then runs frames on input instead of at the full rate.
+        virtual bool animated() const { return true; }
+
+    protected:
+        StateManager& states() const { return *manager; }
+        ResourceCache& resources() const;
+
+    private:
+        friend class StateManager;
+        StateManager* manager = nullptr;
+    };
+
+    // -------------------------------------------------------------------
+    // StateManager
+    // -------------------------------------------------------------------
+    class StateManager
+    {
+    public:
+        explicit StateManager(ResourceCache& resourceCache);
+        StateManager(const StateManager&) = delete;
+        StateManager& operator=(const StateManager&) = delete;
+
+        // States are owned by the caller and must outlive the manager.
+        void add(StateId id, State& state);
+
+        // Requests; applied at the start of the next update().
+        void change(StateId id);
+        void push(StateId id);
+        void pop();
+        void quit() { quitting = true; }
+
+        // Starts loading a state's resources in the background.
+        void preload(StateId id);
+        void cancelPreload(StateId id);
+
+        // Main thread, once per frame: finishes loads, applies a pending
+        // transition when ready, then updates the top state.
+        void update(float dt);
+        void draw() const;
+
+        // Exits every state and releases their resources.
+        void shutdown();
+
+        // Time per frame spent finishing loads on the main thread.
+        void setUploadBudget(f64 seconds) { uploadBudget = seconds; }
+
+        // What a state declared when it was added.
+        const std::vector<ResourceRequest>& declared(StateId id) const { return slots[static_cast<int>(id)].resources; }
+
+        bool running() const { return !quitting; }
+        bool transitionPending() const { return pending.op != Op::None; }
+        State* current() const;
+        ResourceCache& resources() const { return cache; }
+
+    private:
+        enum class Op { None, Change, Push, Pop };
+
+        struct Pending
+        {
+            Op op;
+            StateId target;
+        };
+
+        struct Slot
+        {
+            State* state = nullptr;
+            std::vector<ResourceRequest> resources;
+            bool preloaded = false;   // holds a reference via preload()
+        };
+
+        ResourceCache& cache;
+        Slot slots[static_cast<int>(StateId::Count)];
+        std::vector<StateId> stack;
+        Pending pending;
+        f64 uploadBudget;
+        bool quitting;
+
+        Slot& slot(StateId id) { return slots[static_cast<int>(id)]; }
+        void acquire(StateId id);
+        void release(StateId id);
+        void request(Pending next);    // replaces any pending transition
+        bool applyPending();
+    };
+}
+
+#endif // STATE_MANAGER_HPP
@@ -4,10 +4,22 @@
 
 #include "summer_s1.hpp"
 #include "AEEngine.h"
+#include "asset_ids.hpp"
+#include "debug_draw.hpp"
+#include "deferred.hpp"
 #include "graphics.hpp"
 #include "player.hpp"
 #include <cstdint>
 #include "gamestate.hpp"
+#include "hot_reload.hpp"
+#include "input.hpp"
+#include "latency.hpp"
+#include "quality_governor.hpp"
+#include "view.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
 
 typedef uint32_t u32;
 extern s8 gFontId;
@@ -37,68 +49,440 @@ namespace game
     }
 
 
+    // Level data lives in Assets/levels. Edit summer_s1.txt and rebuild the
+    // .lvl with Tools/levelconv - no recompile needed. The streamer and the
+    // hot reload watch need the path; the preload goes by ID.
+    static const char* const kLevelPath = "Assets/levels/summer_s1.lvl";
+    static constexpr AssetId kLevel = assets::kLevelsSummerS1;
+    static constexpr AssetId kEffects = assets::kEffectsSeasons;
+
+    // World units per tile, whatever the level's size: 20 rows fill the
+    // view's height.
+    static const float kTileSize = view::kVirtualHeight / 20.0f;
+
+    // Light level of the player's torch in dark stages (max 15).
+    static const int kTorchStrength = 9;
+    // How far the player sees in blackout stages, in tiles.
+    static const int kSightRadius = 16;
+
+    // -------------------------------------------------------------------
+    // Constructor
+    // -------------------------------------------------------------------
+    SummerS1::SummerS1(JobSystem& jobSystem)
+        : jobs(jobSystem)
+        , gridCols(0)
+        , gridRows(0)
+        , gridOriginX(0.0f)
+        , gridOriginY(0.0f)
+        , cellW(0.0f)
+        , cellH(0.0f)
+        , streamer(jobSystem)
+        , lookAheadKnob(0)
+        , torchLight(0)
+        , lightInterval(1)
+        , lightCountdown(0)
+        , lightKnob(0)
+        , particleKnob(0)
+        , weatherEmitter(0)
+        , wasGrounded(true)
+        , levelWatch(0)
+        , sourceWatch(0)
+    {
+        u32 palette[4];
+        for (int i = 0; i < 4; ++i)
+            palette[i] = getTileColor(i);
+        tileRenderer.setPalette(palette, 4);
+    }
+
+    SummerS1::~SummerS1() = default;
+
+    // -------------------------------------------------------------------
+    // declareResources
+    // -------------------------------------------------------------------
+    void SummerS1::declareResources(std::vector<ResourceRequest>& out) const
+    {
+        // Paged in ahead of time so enter() only has to map it.
+        out.push_back(ResourceRequest::data(kLevel));
+        out.push_back(ResourceRequest::data(kEffects));
+        PlayerDeclareResources(out);
+    }
+
+    // -------------------------------------------------------------------
+    // enter / exit
+    // -------------------------------------------------------------------
+    void SummerS1::enter()
+    {
+        // Before the level: loading it starts the weather.
+        const vfs::File* fx = resources().data(kEffects);
+        std::string error;
+        if (fx && particles.load(fx->data(), fx->size(), error))
+            particles.bindTextures(resources());
+        else
+            PRINT("SummerS1: bad effects data: %s\n", fx ? error.c_str() : "not loaded");
+        wasGrounded = true;
+
+        if (!loadLevel(kLevelPath))
+        {
+            PRINT("SummerS1: failed to load %s\n", kLevelPath);
+        }
+        PlayerBindAnimations(gGame.player, gGame.heroAnims, gGame.heroAnimator, resources());
+
+        // Under load, stop prefetching ahead of travel; the chunks around
+        // the player are still kept.
+        lookAheadKnob = quality::addKnob("stream look-ahead", 0, [this](f32 level)
+        {
+            StreamSettings s = streamer.getSettings();
+            s.lookAhead = static_cast<int>(level * StreamSettings().lookAhead + 0.5f);
+            streamer.setSettings(s);
+        });
+
+        // Then thin out the weather, then relight less often (down to
+        // every fourth frame); the torch catches up in one step.
+        particleKnob = quality::addKnob("particles", 1, [this](f32 level)
+        {
+            particles.setDensity(0.25f + 0.75f * level);
+        });
+        lightKnob = quality::addKnob("light updates", 2, [this](f32 level)
+        {
+            lightInterval = 4 - static_cast<int>(level * 3.0f + 0.5f);
+        });
+    }
+
+    void SummerS1::exit()
+    {
+        quality::removeKnob(lookAheadKnob);
+        quality::removeKnob(particleKnob);
+        quality::removeKnob(lightKnob);
+        lookAheadKnob = particleKnob = lightKnob = 0;
+        unload();
+        PlayerShutdown(gGame.player);
+
+        // Other states draw around the origin.
+        view::setCamera(gfx::Vec2{ 0.0f, 0.0f });
+
+        // Meshes go while the engine is still up.
+        gGame.heroAnimator.clear();
+        gGame.heroAnims.clear();
+    }
+
+    // -------------------------------------------------------------------
+    // loadLevel
+    // -------------------------------------------------------------------
+    bool SummerS1::loadLevel(const char* path)
+    {
+        // v2 levels stream chunk by chunk; evicted chunks drop their mesh.
+        if (streamer.open(path, LevelLayerKind::Solid, tileMap))
+        {
+            streamer.setEvictCallback([this](int cx, int cy) { tileRenderer.releaseChunk(cx, cy); });
+
+            const LevelFile& file = streamer.file();
+            setGrid(file.cols(), file.rows());
+
+            spawns.clear();
+            for (int i = 0; i < file.spawnCount(); ++i)
+                spawns.push_back(file.spawn(i));
+
+            // Make sure the ground around the first view is there on
+            // frame one.
+            placePlayer();
+            float camCol, camRow;
+            worldToGrid(view::camera().x, view::camera().y, camCol, camRow);
+            streamer.prime(camCol, camRow);
+            setupLights(static_cast<Season>(file.header().season));
+            setupWeather(static_cast<Season>(file.header().season));
+            watchLevel(path, true);
+            return true;
+        }
+
+        // Older (v1) files are loaded whole.
+        LevelFile file;
+        if (!file.open(path))
+            return false;
+
+        int layer = file.findLayer(LevelLayerKind::Solid);
+        if (layer < 0)
+            return false;
+
+        // Decode straight from the mapping into the chunked tile storage.
+        if (!file.decodeLayer(layer, tileMap))
+            return false;
+
+        setGrid(file.cols(), file.rows());
+
+        spawns.clear();
+        for (int i = 0; i < file.spawnCount(); ++i)
+            spawns.push_back(file.spawn(i));
+
+        placePlayer();
+        setupLights(static_cast<Season>(file.header().season));
+        setupWeather(static_cast<Season>(file.header().season));
+        watchLevel(path, false);
+        return true;
+    }
+
+    void SummerS1::unload()
+    {
+        hotreload::unwatch(levelWatch);
+        hotreload::unwatch(sourceWatch);
+        levelWatch = sourceWatch = 0;
+
+        streamer.close();
+        tileRenderer.clear();
+        lightMap.clear();
+        torchLight = 0;
+        visibility.clear();
+        particles.clear();
+        weatherEmitter = 0;
+    }
+
+    // -------------------------------------------------------------------
+    // placePlayer - feet on the bottom of the level's player spawn tile
+    // -------------------------------------------------------------------
+    void SummerS1::placePlayer()
+    {
+        for (const LevelSpawn& s : spawns)
+        {
+            if (s.type != static_cast<u16>(SpawnType::Player))
+                continue;
+
+            float x, y, w, h;
+            gridToWorld(s.col, s.row, x, y, w, h);
+            PlayerPlace(gGame.player, gfx::Vec2{ x + w * 0.5f, y });
+            break;
+        }
+
+        // Frame one already looks at it.
+        updateCamera();
+    }
+
+    // -------------------------------------------------------------------
+    // setupLights - after the level (or a reload of it) is in tileMap
+    // -------------------------------------------------------------------
+    void SummerS1::setupLights(Season season)
+    {
+        const bool blackout = season == Season::Blackout;
+        if (blackout)
+            visibility.reset(tileMap, kSightRadius);
+        else
+            visibility.clear();
+
+        bool dark = blackout;
+        for (const LevelSpawn& s : spawns)
+            dark = dark || s.type == static_cast<u16>(SpawnType::Light);
+
+        if (!dark)
+        {
+            lightMap.clear();
+            torchLight = 0;
+            return;
+        }
+
+        // Chunks streamed in later are picked up by lightMap.sync().
+        lightMap.reset(tileMap);
+        for (const LevelSpawn& s : spawns)
+        {
+            if (s.type == static_cast<u16>(SpawnType::Light))
+                lightMap.addLight(s.col, s.row, s.param ? s.param : LightMap::kMaxLight);
+        }
+
+        // Follows the player from update().
+        torchLight = lightMap.addLight(-1, -1, kTorchStrength);
+        lightCountdown = 0;     // lit on the next update, whatever the knob
+    }
+
+    // -------------------------------------------------------------------
+    // setupWeather - the emitter named after the season, if there is one
+    // -------------------------------------------------------------------
+    void SummerS1::setupWeather(Season season)
+    {
+        // What already fell lives out its life (hot reload).
+        particles.stop(weatherEmitter);
+        weatherEmitter = 0;
+
+        static const char* const kWeather[] = { "spring", "summer", "autumn", "winter" };
+        const size_t s = static_cast<size_t>(season);
+        if (s >= sizeof(kWeather) / sizeof(kWeather[0]))
+            return;
+
+        // Just above the top of the view, so it falls in from outside.
+        const int def = particles.find(kWeather[s]);
+        if (def >= 0)
+            weatherEmitter = particles.start(def, gfx::Vec2{ 0.0f, view::kVirtualHeight * 0.5f + 20.0f });
+    }
+
     // -------------------------------------------------------------------
-    // Constructor - Design your 32x20 level here!
-    // -------------------------------------------------------------------
-    SummerS1::SummerS1()
-        : gridVisible(true)
-        , tileMap{}
-    {
-        // LEVEL DESIGN: 0 = empty, 1 = solid block
-        // 32 columns wide, 20 rows tall
-        // Bottom row = Row 0, Top row = Row 19
-
-        int levelLayout[gridRows][gridCols] = {
-            // Row 0 (bottom ground)
-            {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0},
-            {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0},
-            {0,0,0,0,0,1,0,0,0,0,0,0,1,2,2,2,1,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0},
-            {0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0},
-            {0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0},
-            {0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,1,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0},
-            {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,1,1,1,1,1,1,1,0,0,0,0,0},
-            {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,0,0,0,0,0},
-            {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0},
-            {1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0},
-            {1,1,2,2,2,2,2,1,1,1,1,1,1,1,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0},
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,2,2,0,0,0,0,0,0,0,0},
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0},
-            {1,1,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0},
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0},
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0},
-            // Row 16-19 (empty sky)
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0},
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,1,0},
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,1,0},
-            {1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,1,0}
+    // watchLevel - reload on edits to the .lvl or its .txt source
+    // -------------------------------------------------------------------
+    void SummerS1::watchLevel(const std::string& path, bool streamed)
+    {
+        hotreload::unwatch(levelWatch);
+        hotreload::unwatch(sourceWatch);
+
+        // Runs on the hot reload thread: build the new level off the main
+        // thread. Streamed levels diff chunk by chunk inside the streamer;
+        // fully resident ones get a staging copy to diff against.
+        auto prepare = [this, streamed](std::shared_ptr<LevelFile> file) -> hotreload::ApplyFn
+        {
+            std::shared_ptr<TileMap> staging;
+            if (!streamed)
+            {
+                staging.reset(new TileMap());
+                int layer = file->findLayer(LevelLayerKind::Solid);
+                if (layer < 0 || !file->decodeLayer(layer, *staging))
+                    return hotreload::ApplyFn();
+            }
+            return [this, file, staging]() { applyReloadedLevel(file, staging); };
         };
 
-        // Copy layout into member tileMap.
-        for (int row = 0; row < gridRows; ++row)
-            for (int col = 0; col < gridCols; ++col)
-                tileMap[row][col] = levelLayout[row][col];
+        levelWatch = hotreload::watch(path, [prepare](const std::string& changed) -> hotreload::ApplyFn
+        {
+            std::shared_ptr<LevelFile> file(new LevelFile());
+            if (!file->open(changed.c_str()))
+                return hotreload::ApplyFn();
+            return prepare(file);
+        });
+
+        const size_t dot = path.find_last_of('.');
+        const std::string source = path.substr(0, dot) + ".txt";
+
+        sourceWatch = hotreload::watch(source, [prepare](const std::string& changed) -> hotreload::ApplyFn
+        {
+            std::ifstream in(changed.c_str(), std::ios::binary);
+            std::stringstream text;
+            text << in.rdbuf();
+
+            LevelSource level;
+            std::string error;
+            if (!parseLevelText(text.str(), level, error))
+            {
+                PRINT("hotreload: %s: %s\n", changed.c_str(), error.c_str());
+                return hotreload::ApplyFn();
+            }
+
+            std::vector<u8> image;
+            buildLevelImage(level, image);
+
+            std::shared_ptr<LevelFile> file(new LevelFile());
+            if (!file->openMemory(image))
+                return hotreload::ApplyFn();
+            return prepare(file);
+        });
     }
 
-    SummerS1::~SummerS1() = default;
+    // -------------------------------------------------------------------
+    // applyReloadedLevel - main thread, frame boundary. Player untouched.
+    // -------------------------------------------------------------------
+    void SummerS1::applyReloadedLevel(std::shared_ptr<LevelFile> file, std::shared_ptr<TileMap> staging)
+    {
+        if (streamer.isOpen())
+        {
+            if (!streamer.reload(file))
+                return;
+        }
+        else if (staging)
+        {
+            // Only chunks that differ get dirtied (and so re-baked).
+            if (tileMap.assignChanged(*staging) < 0)
+                tileMap = std::move(*staging);
+        }
+
+        setGrid(file->cols(), file->rows());
+
+        spawns.clear();
+        for (int i = 0; i < file->spawnCount(); ++i)
+            spawns.push_back(file->spawn(i));
+
+        setupLights(static_cast<Season>(file->header().season));
+        setupWeather(static_cast<Season>(file->header().season));
+    }
 
     // -------------------------------------------------------------------
     // update
     // -------------------------------------------------------------------
-    int SummerS1::update(float dt)
+    void SummerS1::update(float dt)
     {
-        if (AEInputCheckTriggered(AEVK_G))
+        // Debug overlays (no-ops unless FP_DEBUG_DRAW).
+        if (input::pressed(AEVK_F1))
+            debugdraw::toggle(debugdraw::Category::Grid);
+        if (input::pressed(AEVK_F2))
+            debugdraw::toggle(debugdraw::Category::Colliders);
+        if (input::pressed(AEVK_F3))
+            debugdraw::toggle(debugdraw::Category::Probes);
+        if (input::pressed(AEVK_F4))
+            debugdraw::toggle(debugdraw::Category::Labels);
+
+        // Deterministic fixed-point player physics (replays / ghosts).
+        if (input::pressed(AEVK_F))
         {
-            gridVisible = !gridVisible;
+            PlayerSetFixedPhysics(gGame.player, !gGame.player.fixedPhysics);
         }
 
-        if (AEInputCheckTriggered(AEVK_ESCAPE))
+#if FP_LATENCY
+        // Jump latency so far (also written on exit). Writing the log can
+        // wait for a frame with time to spare.
+        if (input::pressed(AEVK_L))
         {
-            return 2;
+            deferred::submit("latency report", deferred::Priority::Low, 1.0, []()
+            {
+                latency::report();
+                latency::reset();
+                return true;
+            });
+        }
+#endif
+
+        if (input::pressed(AEVK_ESCAPE))
+        {
+            states().change(StateId::MainMenu);
+            return;
         }
 
         PlayerUpdate(gGame.player, dt);
 
-        return 0;
+        // Every hero-animated entity, one pass.
+        gGame.heroAnimator.update(dt);
+        updateCamera();
+
+        // Dust where the player lands, sparks if it's on spikes.
+        const Player& player = gGame.player;
+        if (player.grounded && !wasGrounded)
+        {
+            const gfx::Vec2 feet{ player.pos.x, player.pos.y - player.colliderSize.y * 0.5f };
+            float footCol, footRow;
+            worldToGrid(feet.x, feet.y - 1.0f, footCol, footRow);
+            const bool spikes = tileMap.get(static_cast<int>(std::floor(footCol)),
+                static_cast<int>(std::floor(footRow))) == 2;
+            particles.burst(particles.find(spikes ? "spike_hit" : "dust_land"), feet);
+        }
+        wasGrounded = player.grounded;
+        particles.update(dt);
+
+        float playerCol, playerRow;
+        worldToGrid(gGame.player.pos.x, gGame.player.pos.y, playerCol, playerRow);
+
+        // Page level chunks in/out around what's on screen.
+        if (streamer.isOpen())
+        {
+            float camCol, camRow;
+            worldToGrid(view::camera().x, view::camera().y, camCol, camRow);
+            streamer.update(camCol, camRow);
+        }
+
+        // Rebake any chunks whose tiles changed.
+        tileRenderer.sync(tileMap, jobs);
+
+        // Relight only what the torch or edited tiles touched; line of
+        // sight is only recast when the player changes tile.
+        if (!lightMap.empty() && --lightCountdown <= 0)
+        {
+            lightCountdown = lightInterval;
+            const int col = static_cast<int>(std::floor(playerCol));
+            const int row = static_cast<int>(std::floor(playerRow));
+            lightMap.moveLight(torchLight, col, row);
+            lightMap.sync(tileMap);
+            visibility.update(tileMap, col, row);
+            lightMap.upload(sight());
+        }
     }
 
     // -------------------------------------------------------------------
@@ -106,23 +490,74 @@ namespace game
     // -------------------------------------------------------------------
     void SummerS1::draw() const
     {
-        AEGfxSetBackgroundColor(0.3f, 0.6f, 0.8f);
-
-        AEGfxSetRenderMode(AE_GFX_RM_COLOR);
-        AEGfxSetBlendMode(AE_GFX_BM_NONE);
+        if (lightMap.empty())
+            AEGfxSetBackgroundColor(0.3f, 0.6f, 0.8f);
+        else if (sight())
+            AEGfxSetBackgroundColor(0.0f, 0.0f, 0.0f);     // what's hidden is black
+        else
+            AEGfxSetBackgroundColor(0.02f, 0.02f, 0.04f);
 
         drawTiles();
+        drawGrid();
 
-        if (gridVisible)
-        {
-            drawGrid();
-        }
+        PlayerDraw(gGame.player);
+        particles.draw();
+
+        // Multiplied over everything queued below kLayerLighting.
+        lightMap.draw(gridOriginX, gridOriginY, cellW, cellH, gfx::kLayerLighting, sight());
+
+        // Geometry first so the text ends up on top.
+        gfx::flushQueue();
 
         printText(-0.95f, 0.9f, 0xFFFFFFFFu, "Summer Stage 1 - 32x20 Grid");
-        printText(-0.95f, 0.7f, 0xFFFFFFFFu, "Press G to toggle grid");
-        printText(-0.95f, 0.5f, 0xFFFFFFFFu, "Press ESC to return to menu");
+#if FP_DEBUG_DRAW
+        printText(-0.95f, 0.7f, 0xFFFFFFFFu, "F1-F4: grid / colliders / probes / labels");
+#endif
+        printText(-0.95f, 0.6f, 0xFFFFFFFFu, gGame.player.fixedPhysics ?
+            "Press F for float physics (fixed-point on)" : "Press F for fixed-point physics");
+#if FP_LATENCY
+        printText(-0.95f, 0.5f, 0xFFFFFFFFu, "Press L to print jump latency");
+#endif
+        printText(-0.95f, 0.4f, 0xFFFFFFFFu, "Press ESC to return to menu");
+    }
 
-        PlayerDraw(gGame.player);
+    // -------------------------------------------------------------------
+    // setGrid
+    // -------------------------------------------------------------------
+    void SummerS1::setGrid(int cols, int rows)
+    {
+        gridCols = cols;
+        gridRows = rows;
+
+        // Row 0 sits on the player's floor at the bottom of the start view;
+        // wider or taller levels carry on past it and the camera follows.
+        gridOriginX = -view::kVirtualWidth * 0.5f;
+        gridOriginY = -view::kVirtualHeight * 0.5f;
+        cellW = kTileSize;
+        cellH = kTileSize;
+    }
+
+    // -------------------------------------------------------------------
+    // updateCamera - follow the player, kept inside the level
+    // -------------------------------------------------------------------
+    void SummerS1::updateCamera()
+    {
+        const view::Metrics& m = view::metrics();
+        auto follow = [](float target, float lo, float hi, float half)
+        {
+            // A level narrower than the view stays centred in it.
+            if (hi - lo <= 2.0f * half)
+                return (lo + hi) * 0.5f;
+            return std::min(std::max(target, lo + half), hi - half);
+        };
+
+        const gfx::Vec2 target = gGame.player.pos;
+        view::setCamera(gfx::Vec2{
+            follow(target.x, gridOriginX, gridOriginX + gridCols * cellW, (m.maxX - m.minX) * 0.5f),
+            follow(target.y, gridOriginY, gridOriginY + gridRows * cellH, (m.maxY - m.minY) * 0.5f) });
+
+        // Weather keeps falling in from just above the view.
+        particles.move(weatherEmitter, gfx::Vec2{ view::camera().x, m.maxY + 20.0f });
     }
 
     // -------------------------------------------------------------------
@@ -130,18 +565,22 @@ namespace game
     // -------------------------------------------------------------------
     void SummerS1::gridToWorld(int col, int row,
         float& xWorld, float& yWorld,
-        float& cellW, float& cellH) const
+        float& outCellW, float& outCellH) const
     {
-        float minX = AEGfxGetWinMinX();
-        float maxX = AEGfxGetWinMaxX();
-        float minY = AEGfxGetWinMinY();
-        float maxY = AEGfxGetWinMaxY();
+        outCellW = cellW;
+        outCellH = cellH;
 
-        cellW = (maxX - minX) / static_cast<float>(gridCols);
-        cellH = (maxY - minY) / static_cast<float>(gridRows);
+        xWorld = gridOriginX + col * cellW;
+        yWorld = gridOriginY + row * cellH;
+    }
 
-        xWorld = minX + col * cellW;
-        yWorld = minY + row * cellH;
+    // -------------------------------------------------------------------
+    // worldToGrid - inverse of gridToWorld (fractional tile coordinates)
+    // -------------------------------------------------------------------
+    void SummerS1::worldToGrid(float xWorld, float yWorld, float& col, float& row) const
+    {
+        col = cellW > 0.0f ? (xWorld - gridOriginX) / cellW : 0.0f;
+        row = cellH > 0.0f ? (yWorld - gridOriginY) / cellH : 0.0f;
     }
 
 
@@ -150,19 +589,7 @@ namespace game
     // drawTiles
     // -------------------------------------------------------------------
     void game::SummerS1::drawTiles() const {
-        for (int row = 0; row < gridRows; ++row) {
-            for (int col = 0; col < gridCols; ++col) {
-                int tileType = tileMap[row][col];
-                if (tileType > 0) {
-                    u32 tileColor = getTileColor(tileType);
-                    float xWorld, yWorld, cellW, cellH;
-                    gridToWorld(col, row, xWorld, yWorld, cellW, cellH);
-                    gfx::Vec2 pos{ xWorld + cellW * 0.5f, yWorld + cellH * 0.5f };
-                    gfx::Vec2 size{ cellW, cellH };
-                    gfx::drawRectangle(pos, 0.0f, size, tileColor);
-                }
-            }
-        }
+        tileRenderer.draw(gridOriginX, gridOriginY, cellW, cellH, gfx::kLayerTiles, sight());
     }
 
 
@@ -172,15 +599,15 @@ namespace game
     // -------------------------------------------------------------------
     void SummerS1::drawGrid() const
     {
-        const u32 gridColor = 0x80FFFFFF;
+        if (!debugdraw::enabled(debugdraw::Category::Grid))
+            return;
 
-        float minX = AEGfxGetWinMinX();
-        float maxX = AEGfxGetWinMaxX();
-        float minY = AEGfxGetWinMinY();
-        float maxY = AEGfxGetWinMaxY();
+        const u32 gridColor = 0x80FFFFFF;
 
-        float cellW = (maxX - minX) / static_cast<float>(gridCols);
-        float cellH = (maxY - minY) / static_cast<float>(gridRows);
+        const float minX = gridOriginX;
+        const float maxX = gridOriginX + gridCols * cellW;
+        const float minY = gridOriginY;
+        const float maxY = gridOriginY + gridRows * cellH;
 
         float thickness = (cellW < cellH ? cellW : cellH) * 0.04f;
 
@@ -188,18 +615,16 @@ namespace game
         for (int col = 0; col <= gridCols; ++col)
         {
             float x = minX + col * cellW;
-            gfx::Vec2 pos{ x, (minY + maxY) * 0.5f };
-            gfx::Vec2 size{ thickness, maxY - minY };
-            gfx::drawRectangle(pos, 0.0f, size, gridColor);
+            debugdraw::line(gfx::Vec2{ x, minY }, gfx::Vec2{ x, maxY }, gridColor,
+                debugdraw::Category::Grid, thickness);
         }
 
         // Horizontal lines.
         for (int row = 0; row <= gridRows; ++row)
         {
             float y = minY + row * cellH;
-            gfx::Vec2 pos{ (minX + maxX) * 0.5f, y };
-            gfx::Vec2 size{ maxX - minX, thickness };
-            gfx::drawRectangle(pos, 0.0f, size, gridColor);
+            debugdraw::line(gfx::Vec2{ minX, y }, gfx::Vec2{ maxX, y }, gridColor,
+                debugdraw::Category::Grid, thickness);
         }
     }
 }
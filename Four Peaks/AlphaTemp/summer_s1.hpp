@@ -3,34 +3,103 @@
 
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include "level_format.hpp"
+#include "tilemap.hpp"
+#include "tile_renderer.hpp"
+#include "job_system.hpp"
+#include "level_stream.hpp"
+#include "light_map.hpp"
+#include "particles.hpp"
+#include "visibility.hpp"
+#include "state_manager.hpp"
 
 typedef uint32_t u32;
 
 namespace game {
-    class SummerS1 {
+    class SummerS1 : public State {
     public:
-        SummerS1();
+        explicit SummerS1(JobSystem& jobSystem);
         ~SummerS1();
         SummerS1(const SummerS1&) = delete;
-        int update(float dt);
-        void draw() const;
+
+        // Level data and player sprite sheets.
+        void declareResources(std::vector<ResourceRequest>& out) const override;
+
+        // The level is loaded on enter and dropped on exit; ESC returns to
+        // the menu.
+        void enter() override;
+        void exit() override;
+        void update(float dt) override;
+        void draw() const override;
 
     private:
-        bool gridVisible;
+        JobSystem& jobs;           // chunk decoding and mesh baking
 
-        // Grid dimensions - 32 columns width x 20 rows height.
-        static const int gridCols = 32;
-        static const int gridRows = 20;
+        // Grid dimensions, read from the level file (summer_s1 is 32x20).
+        // Tiles are a fixed size in world units on every level, so levels
+        // larger than the view scroll: the camera follows the player.
+        int gridCols;
+        int gridRows;
+        float gridOriginX;         // world position of tile (0,0)'s bottom-left
+        float gridOriginY;
+        float cellW;
+        float cellH;
+        void setGrid(int cols, int rows);
+        void updateCamera();
 
 
         // Tile map: 0=empty, 1=ground, 2=spikes, etc.
-        int tileMap[gridRows][gridCols];
+        // Sparse 32x32 chunks, row 0 = bottom.
+        TileMap tileMap;
+        TileRenderer tileRenderer; // one baked mesh per chunk
+        LevelStreamer streamer;    // pages tileMap chunks around the player
+        int lookAheadKnob;         // quality governor handle, 0 = none
         u32 getTileColor(int tileType) const;
 
+        // Entity spawns read from the level file.
+        std::vector<LevelSpawn> spawns;
+
+        // Levels with light spawns are dark: ambient light only, plus the
+        // level's lights and a torch carried by the player. Blackout levels
+        // are dark too, and only draw what the player has line of sight to.
+        LightMap lightMap;
+        int torchLight;            // LightMap handle, 0 = none
+        int lightInterval;         // relight every Nth frame (quality knob)
+        int lightCountdown;
+        int lightKnob;             // quality governor handles, 0 = none
+        int particleKnob;
+        Visibility visibility;     // empty unless blackout
+        void setupLights(Season season);
+        // Line of sight mask for drawing, nullptr when everything is seen.
+        const Visibility* sight() const { return visibility.empty() ? nullptr : &visibility; }
+
+        // Weather for the level's season (Assets/effects/seasons.fx), and
+        // dust where the player lands.
+        ParticleSystem particles;
+        int weatherEmitter;        // ParticleSystem handle, 0 = none
+        bool wasGrounded;
+        void setupWeather(Season season);
+
+        bool loadLevel(const char* path);
+        // Moves the player to the level's player spawn (on load, not on
+        // hot reload) and the camera with it.
+        void placePlayer();
+        // Frees baked meshes and stops streaming.
+        void unload();
+
+        // Hot reload of the level (.lvl and its .txt source).
+        int levelWatch;
+        int sourceWatch;
+        void watchLevel(const std::string& path, bool streamed);
+        void applyReloadedLevel(std::shared_ptr<LevelFile> file, std::shared_ptr<TileMap> staging);
+
 
         void drawGrid() const;
         void drawTiles() const;
         void gridToWorld(int col, int row, float& xWorld, float& yWorld, float& cellW, float& cellH) const;
+        void worldToGrid(float xWorld, float yWorld, float& col, float& row) const;
     };
 }
 
@@ -0,0 +1,197 @@
+// ---------------------------------------------------------------------------
+// tile_renderer.cpp
+// ---------------------------------------------------------------------------
+
+#include "tile_renderer.hpp"
+#include "math2d.hpp"
+#include "visibility.hpp"
+#include <cstring>
+
+namespace game
+{
+    TileRenderer::TileRenderer()
+        : chunkCols(0)
+        , chunkRows(0)
+    {
+        std::memset(palette, 0, sizeof(palette));
+    }
+
+    TileRenderer::~TileRenderer()
+    {
+        clear();
+    }
+
+    void TileRenderer::setPalette(const u32* colors, int count)
+    {
+        std::memset(palette, 0, sizeof(palette));
+        for (int i = 0; i < count && i < 256; ++i)
+            palette[i] = colors[i];
+
+        // Colors are baked into the vertices, so everything must rebuild.
+        for (ChunkMeshes& chunk : meshes)
+            freeMeshes(chunk);
+        chunkCols = chunkRows = -1;
+    }
+
+    void TileRenderer::freeMeshes(ChunkMeshes& chunk)
+    {
+        if (chunk.opaque) { AEGfxMeshFree(chunk.opaque); chunk.opaque = nullptr; }
+        if (chunk.blended) { AEGfxMeshFree(chunk.blended); chunk.blended = nullptr; }
+    }
+
+    void TileRenderer::clear()
+    {
+        for (ChunkMeshes& chunk : meshes)
+            freeMeshes(chunk);
+        meshes.clear();
+        chunkCols = 0;
+        chunkRows = 0;
+    }
+
+    void TileRenderer::releaseChunk(int cx, int cy)
+    {
+        if (cx < 0 || cy < 0 || cx >= chunkCols || cy >= chunkRows)
+            return;
+
+        freeMeshes(meshes[cy * chunkCols + cx]);
+    }
+
+    // -------------------------------------------------------------------
+    // sync
+    // -------------------------------------------------------------------
+    void TileRenderer::sync(TileMap& map, JobSystem& jobs)
+    {
+        const bool resized = (chunkCols != map.chunkCols() || chunkRows != map.chunkRows());
+        if (resized)
+        {
+            clear();
+            chunkCols = map.chunkCols();
+            chunkRows = map.chunkRows();
+            meshes.assign(static_cast<size_t>(chunkCols) * chunkRows, ChunkMeshes{ nullptr, nullptr });
+        }
+
+        size_t count = 0;
+        for (int cy = 0; cy < chunkRows; ++cy)
+        {
+            for (int cx = 0; cx < chunkCols; ++cx)
+            {
+                if (!resized && !(map.dirtyFlags(cx, cy) & TileMap::DirtyRender))
+                    continue;
+
+                if (bakes.size() <= count)
+                    bakes.resize(count + 1);
+                bakes[count].cx = cx;
+                bakes[count].cy = cy;
+                ++count;
+                map.clearDirty(cx, cy, TileMap::DirtyRender);
+            }
+        }
+
+        // Scan tiles in parallel; the map isn't touched again until we return.
+        const TileMap& source = map;
+        jobs.parallelFor(0, count, 1, [this, &source](size_t i) { buildQuads(source, bakes[i]); });
+
+        for (size_t i = 0; i < count; ++i)
+            uploadChunk(bakes[i]);
+    }
+
+    // -------------------------------------------------------------------
+    // buildQuads - job; reads the chunk and palette only
+    // -------------------------------------------------------------------
+    void TileRenderer::buildQuads(const TileMap& map, Bake& bake) const
+    {
+        bake.quads.clear();
+
+        const TileMap::Chunk* chunk = map.chunk(bake.cx, bake.cy);
+        if (!chunk)
+            return;
+
+        for (int ly = 0; ly < TileMap::kChunkSize; ++ly)
+        {
+            for (int lx = 0; lx < TileMap::kChunkSize; ++lx)
+            {
+                u8 tile = chunk->tiles[(ly << TileMap::kChunkShift) | lx];
+                u32 c = palette[tile];
+                if (tile == 0 || (c >> 24) == 0)
+                    continue;
+
+                bake.quads.push_back(Quad{ static_cast<u8>(lx), static_cast<u8>(ly), c });
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // uploadChunk - main thread
+    // -------------------------------------------------------------------
+    AEGfxVertexList* TileRenderer::buildMesh(const std::vector<Quad>& quads, bool opaque)
+    {
+        bool any = false;
+        for (const Quad& q : quads)
+        {
+            const bool quadOpaque = (q.color >> 24) == 0xFF;
+            if (quadOpaque != opaque)
+                continue;
+
+            if (!any)
+            {
+                AEGfxMeshStart();
+                any = true;
+            }
+
+            const u32 c = q.color;
+            f32 x0 = static_cast<f32>(q.lx);
+            f32 y0 = static_cast<f32>(q.ly);
+            f32 x1 = x0 + 1.0f;
+            f32 y1 = y0 + 1.0f;
+
+            AEGfxTriAdd(x0, y0, c, 0.0f, 0.0f,
+                x1, y0, c, 1.0f, 0.0f,
+                x1, y1, c, 1.0f, 1.0f);
+            AEGfxTriAdd(x0, y0, c, 0.0f, 0.0f,
+                x1, y1, c, 1.0f, 1.0f,
+                x0, y1, c, 0.0f, 1.0f);
+        }
+        return any ? AEGfxMeshEnd() : nullptr;
+    }
+
+    void TileRenderer::uploadChunk(const Bake& bake)
+    {
+        releaseChunk(bake.cx, bake.cy);
+        if (bake.quads.empty())
+            return;
+
+        ChunkMeshes& chunk = meshes[bake.cy * chunkCols + bake.cx];
+        chunk.opaque = buildMesh(bake.quads, true);
+        chunk.blended = buildMesh(bake.quads, false);
+    }
+
+    // -------------------------------------------------------------------
+    // draw
+    // -------------------------------------------------------------------
+    void TileRenderer::draw(f32 originX, f32 originY, f32 cellW, f32 cellH, s32 layer,
+        const Visibility* visibility) const
+    {
+        const f32 chunkW = cellW * TileMap::kChunkSize;
+        const f32 chunkH = cellH * TileMap::kChunkSize;
+
+        for (int cy = 0; cy < chunkRows; ++cy)
+        {
+            for (int cx = 0; cx < chunkCols; ++cx)
+            {
+                const ChunkMeshes& chunk = meshes[cy * chunkCols + cx];
+                if (!chunk.opaque && !chunk.blended)
+                    continue;
+                if (visibility && !visibility->chunkVisible(cx, cy))
+                    continue;
+
+                // scale to cell size, then move to the chunk's corner
+                const gfx::Vec2 corner{ originX + cx * chunkW, originY + cy * chunkH };
+                const gfx::Mat2x3 m = gfx::Mat2x3::trs(corner, 0.0f, gfx::Vec2{ cellW, cellH });
+
+                // Baked vertex colors, untouched.
+                gfx::submit(gfx::vertexColors(gfx::Opacity::Opaque), chunk.opaque, m, layer);
+                gfx::submit(gfx::vertexColors(gfx::Opacity::Blended), chunk.blended, m, layer);
+            }
+        }
+    }
+}
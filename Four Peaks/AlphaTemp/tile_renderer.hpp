@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------------
+// tile_renderer.hpp
+// ---------------------------------------------------------------------------
+//
+// Bakes each TileMap chunk into one AE mesh (two triangles per solid tile,
+// colored per tile id) so a whole 32x32 chunk is a single draw call instead
+// of one drawRectangle per tile. Only chunks flagged DirtyRender are rebuilt.
+//
+// Meshes are built in tile units (1 tile = 1x1, chunk-local) and scaled to
+// the current cell size at draw time. Dirty chunks are scanned in parallel
+// on the JobSystem; only the AE mesh calls stay on the main thread.
+//
+// Tiles with an opaque palette color go in one mesh per chunk and the
+// translucent ones in another, so draw() can queue the first for the
+// opaque pass (render_queue.hpp) and only the second is blended. One
+// renderer per tile layer, each drawn on its own queue layer.
+//
+
+#ifndef TILE_RENDERER_HPP
+#define TILE_RENDERER_HPP
+
+#include "AEEngine.h"
+#include "job_system.hpp"
+#include "render_queue.hpp"
+#include "tilemap.hpp"
+#include <vector>
+
+namespace game
+{
+    class Visibility;
+
+    class TileRenderer
+    {
+    public:
+        TileRenderer();
+        ~TileRenderer();
+        TileRenderer(const TileRenderer&) = delete;
+        TileRenderer& operator=(const TileRenderer&) = delete;
+
+        // ARGB color per tile id; alpha 0 = not drawn.
+        void setPalette(const u32* colors, int count);
+
+        // Rebuilds meshes for chunks flagged DirtyRender and clears the flag.
+        void sync(TileMap& map, JobSystem& jobs);
+
+        // Queues the chunks on layer. originX/Y = world position of tile
+        // (0,0)'s bottom-left corner. With `visibility`, chunks without a
+        // visible tile are skipped.
+        void draw(f32 originX, f32 originY, f32 cellW, f32 cellH, s32 layer = gfx::kLayerTiles,
+            const Visibility* visibility = nullptr) const;
+
+        void releaseChunk(int cx, int cy);
+        void clear();
+
+    private:
+        int chunkCols;
+        int chunkRows;
+        struct ChunkMeshes
+        {
+            AEGfxVertexList* opaque;    // nullptr = nothing to draw
+            AEGfxVertexList* blended;
+        };
+        std::vector<ChunkMeshes> meshes;
+        u32 palette[256];
+
+        // One per solid tile, filled by the bake jobs.
+        struct Quad
+        {
+            u8 lx, ly;
+            u32 color;
+        };
+
+        struct Bake
+        {
+            int cx, cy;
+            std::vector<Quad> quads;
+        };
+        std::vector<Bake> bakes;        // reused between syncs
+
+        void buildQuads(const TileMap& map, Bake& bake) const;
+        void uploadChunk(const Bake& bake);
+        static AEGfxVertexList* buildMesh(const std::vector<Quad>& quads, bool opaque);
+        static void freeMeshes(ChunkMeshes& chunk);
+    };
+}
+
+#endif // TILE_RENDERER_HPP
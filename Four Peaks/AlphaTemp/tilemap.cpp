@@ -0,0 +1,243 @@
+// ---------------------------------------------------------------------------
+// tilemap.cpp
+// ---------------------------------------------------------------------------
+
+#include "tilemap.hpp"
+#include <cstring>
+
+namespace game
+{
+    TileMap::TileMap()
+        : numCols(0)
+        , numRows(0)
+        , numChunkCols(0)
+        , numChunkRows(0)
+        , allocated(0)
+    {
+    }
+
+    void TileMap::resize(int cols, int rows)
+    {
+        numCols = cols > 0 ? cols : 0;
+        numRows = rows > 0 ? rows : 0;
+        numChunkCols = (numCols + kChunkMask) >> kChunkShift;
+        numChunkRows = (numRows + kChunkMask) >> kChunkShift;
+
+        chunks.clear();
+        chunks.resize(static_cast<size_t>(numChunkCols) * numChunkRows);
+        dirty.assign(chunks.size(), DirtyAll);
+        allocated = 0;
+    }
+
+    void TileMap::clear()
+    {
+        resize(0, 0);
+    }
+
+    TileMap::Chunk* TileMap::acquireChunk(int cx, int cy)
+    {
+        std::unique_ptr<Chunk>& slot = chunks[chunkIndex(cx, cy)];
+        if (!slot)
+        {
+            slot.reset(new Chunk());
+            std::memset(slot->tiles, 0, sizeof(slot->tiles));
+            slot->filled = 0;
+            ++allocated;
+        }
+        return slot.get();
+    }
+
+    // -------------------------------------------------------------------
+    // set
+    // -------------------------------------------------------------------
+    void TileMap::set(int col, int row, u8 tile)
+    {
+        if (!inBounds(col, row))
+            return;
+
+        const int cx = col >> kChunkShift;
+        const int cy = row >> kChunkShift;
+        std::unique_ptr<Chunk>& slot = chunks[chunkIndex(cx, cy)];
+
+        // Writing air into air: nothing to allocate.
+        if (!slot && tile == 0)
+            return;
+
+        Chunk* c = acquireChunk(cx, cy);
+        u8& t = c->tiles[localIndex(col, row)];
+        if (t == tile)
+            return;
+
+        if (t == 0) ++c->filled;
+        if (tile == 0) --c->filled;
+        t = tile;
+
+        markDirty(cx, cy, DirtyAll);
+
+        if (c->filled == 0)
+        {
+            slot.reset();
+            --allocated;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // writeSpan - one row segment that never crosses a chunk edge
+    // -------------------------------------------------------------------
+    void TileMap::writeSpan(int col, int row, const u8* tiles, u8 fill, int count)
+    {
+        const int cx = col >> kChunkShift;
+        const int cy = row >> kChunkShift;
+
+        if (!tiles && fill == 0 && !chunks[chunkIndex(cx, cy)])
+            return;
+
+        Chunk* c = acquireChunk(cx, cy);
+        u8* dst = c->tiles + localIndex(col, row);
+
+        for (int i = 0; i < count; ++i)
+        {
+            u8 tile = tiles ? tiles[i] : fill;
+            if (dst[i] == 0 && tile != 0) ++c->filled;
+            if (dst[i] != 0 && tile == 0) --c->filled;
+            dst[i] = tile;
+        }
+
+        markDirty(cx, cy, DirtyAll);
+
+        if (c->filled == 0)
+        {
+            chunks[chunkIndex(cx, cy)].reset();
+            --allocated;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // fillLinear / writeLinear
+    // -------------------------------------------------------------------
+    void TileMap::fillLinear(size_t start, u8 tile, size_t count)
+    {
+        if (numCols == 0)
+            return;
+
+        while (count > 0)
+        {
+            int row = static_cast<int>(start / numCols);
+            int col = static_cast<int>(start % numCols);
+            if (row >= numRows)
+                return;
+
+            int rowLeft = numCols - col;
+            int chunkLeft = kChunkSize - (col & kChunkMask);
+            int n = rowLeft < chunkLeft ? rowLeft : chunkLeft;
+            if (static_cast<size_t>(n) > count) n = static_cast<int>(count);
+
+            writeSpan(col, row, nullptr, tile, n);
+            start += n;
+            count -= n;
+        }
+    }
+
+    void TileMap::writeLinear(size_t start, const u8* tiles, size_t count)
+    {
+        if (numCols == 0)
+            return;
+
+        while (count > 0)
+        {
+            int row = static_cast<int>(start / numCols);
+            int col = static_cast<int>(start % numCols);
+            if (row >= numRows)
+                return;
+
+            int rowLeft = numCols - col;
+            int chunkLeft = kChunkSize - (col & kChunkMask);
+            int n = rowLeft < chunkLeft ? rowLeft : chunkLeft;
+            if (static_cast<size_t>(n) > count) n = static_cast<int>(count);
+
+            writeSpan(col, row, tiles, 0, n);
+            tiles += n;
+            start += n;
+            count -= n;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // releaseChunk / installChunk
+    // -------------------------------------------------------------------
+    void TileMap::releaseChunk(int cx, int cy)
+    {
+        std::unique_ptr<Chunk>& slot = chunks[chunkIndex(cx, cy)];
+        if (slot)
+        {
+            slot.reset();
+            --allocated;
+        }
+        markDirty(cx, cy, DirtyAll);
+    }
+
+    void TileMap::installChunk(int cx, int cy, const u8* tiles)
+    {
+        u16 filled = 0;
+        for (int i = 0; i < kChunkTiles; ++i)
+            filled = static_cast<u16>(filled + (tiles[i] != 0));
+
+        if (filled == 0)
+        {
+            releaseChunk(cx, cy);
+            return;
+        }
+
+        Chunk* c = acquireChunk(cx, cy);
+        std::memcpy(c->tiles, tiles, sizeof(c->tiles));
+        c->filled = filled;
+        markDirty(cx, cy, DirtyAll);
+    }
+
+    bool TileMap::updateChunk(int cx, int cy, const u8* tiles)
+    {
+        const Chunk* c = chunk(cx, cy);
+        if (c)
+        {
+            if (std::memcmp(c->tiles, tiles, sizeof(c->tiles)) == 0)
+                return false;
+        }
+        else
+        {
+            bool empty = true;
+            for (int i = 0; i < kChunkTiles && empty; ++i)
+                empty = tiles[i] == 0;
+            if (empty)
+                return false;
+        }
+
+        installChunk(cx, cy, tiles);
+        return true;
+    }
+
+    int TileMap::assignChanged(const TileMap& other)
+    {
+        if (other.numCols != numCols || other.numRows != numRows)
+            return -1;
+
+        static const u8 kEmpty[kChunkTiles] = {};
+        int changed = 0;
+
+        for (int cy = 0; cy < numChunkRows; ++cy)
+        {
+            for (int cx = 0; cx < numChunkCols; ++cx)
+            {
+                const Chunk* src = other.chunk(cx, cy);
+                if (updateChunk(cx, cy, src ? src->tiles : kEmpty))
+                    ++changed;
+            }
+        }
+        return changed;
+    }
+
+    size_t TileMap::memoryUsage() const
+    {
+        return allocated * sizeof(Chunk) +
+            chunks.size() * (sizeof(std::unique_ptr<Chunk>) + sizeof(u8));
+    }
+}
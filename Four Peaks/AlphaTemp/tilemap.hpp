@@ -0,0 +1,129 @@
+// ---------------------------------------------------------------------------
+// tilemap.hpp
+// ---------------------------------------------------------------------------
+//
+// Sparse chunked tile storage.
+//
+// Tiles are 8-bit ids (0 = empty air) grouped into 32x32 chunks. Only chunks
+// that contain at least one non-empty tile are allocated, so open sky costs a
+// single null pointer per chunk. Each chunk slot carries dirty flags so the
+// renderer / collision builder / light map / line of sight only rebuild
+// what changed.
+//
+// Coordinates follow the level convention: col grows right, row grows up,
+// row 0 = bottom of the level.
+//
+
+#ifndef TILEMAP_HPP
+#define TILEMAP_HPP
+
+#include <AETypes.h>   // u8, u16
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace game
+{
+    class TileMap
+    {
+    public:
+        static const int kChunkShift = 5;
+        static const int kChunkSize = 1 << kChunkShift;   // 32 tiles
+        static const int kChunkMask = kChunkSize - 1;
+        static const int kChunkTiles = kChunkSize * kChunkSize;
+
+        enum DirtyFlags : u8
+        {
+            DirtyRender = 1 << 0,
+            DirtyCollision = 1 << 1,
+            DirtyLight = 1 << 2,
+            DirtyVision = 1 << 3,
+            DirtyAll = DirtyRender | DirtyCollision | DirtyLight | DirtyVision
+        };
+
+        struct Chunk
+        {
+            u8  tiles[kChunkTiles]; // row-major inside the chunk
+            u16 filled;             // number of non-empty tiles
+        };
+
+        TileMap();
+
+        // Clears everything and sets the level size in tiles.
+        void resize(int cols, int rows);
+        void clear();
+
+        int cols() const { return numCols; }
+        int rows() const { return numRows; }
+        int chunkCols() const { return numChunkCols; }
+        int chunkRows() const { return numChunkRows; }
+
+        bool inBounds(int col, int row) const
+        {
+            return col >= 0 && row >= 0 && col < numCols && row < numRows;
+        }
+
+        // Returns 0 for out-of-bounds or unallocated tiles.
+        u8 get(int col, int row) const
+        {
+            if (!inBounds(col, row))
+                return 0;
+            const Chunk* c = chunks[chunkIndex(col >> kChunkShift, row >> kChunkShift)].get();
+            return c ? c->tiles[localIndex(col, row)] : 0;
+        }
+
+        void set(int col, int row, u8 tile);
+
+        // Bulk writes along one level row (linear index = row * cols + col,
+        // may span several rows). Used by the level decoder so runs of air
+        // never allocate chunks.
+        void fillLinear(size_t start, u8 tile, size_t count);
+        void writeLinear(size_t start, const u8* tiles, size_t count);
+
+        // Chunk access by chunk coordinate (nullptr = empty air).
+        const Chunk* chunk(int cx, int cy) const { return chunks[chunkIndex(cx, cy)].get(); }
+        const Chunk* chunkForTile(int col, int row) const
+        {
+            return inBounds(col, row) ? chunk(col >> kChunkShift, row >> kChunkShift) : nullptr;
+        }
+
+        // Drops a chunk's tiles (streaming eviction). Marks it dirty.
+        void releaseChunk(int cx, int cy);
+        // Installs a full chunk of tiles (streaming load). Marks it dirty.
+        void installChunk(int cx, int cy, const u8* tiles);
+        // Like installChunk, but only touches (and dirties) the chunk if its
+        // contents differ. Returns true if it changed.
+        bool updateChunk(int cx, int cy, const u8* tiles);
+        // Copies `other` (same size) chunk by chunk, dirtying only the
+        // chunks whose contents differ. Returns the number changed.
+        int assignChanged(const TileMap& other);
+
+        u8 dirtyFlags(int cx, int cy) const { return dirty[chunkIndex(cx, cy)]; }
+        void markDirty(int cx, int cy, u8 flags) { dirty[chunkIndex(cx, cy)] |= flags; }
+        void clearDirty(int cx, int cy, u8 flags) { dirty[chunkIndex(cx, cy)] &= static_cast<u8>(~flags); }
+
+        size_t allocatedChunks() const { return allocated; }
+        size_t memoryUsage() const;
+
+    private:
+        int numCols;
+        int numRows;
+        int numChunkCols;
+        int numChunkRows;
+        size_t allocated;
+
+        std::vector<std::unique_ptr<Chunk>> chunks; // chunkRows * chunkCols directory
+        std::vector<u8> dirty;                      // one DirtyFlags byte per slot
+
+        int chunkIndex(int cx, int cy) const { return cy * numChunkCols + cx; }
+        static int localIndex(int col, int row)
+        {
+            return ((row & kChunkMask) << kChunkShift) | (col & kChunkMask);
+        }
+
+        Chunk* acquireChunk(int cx, int cy);
+        void writeSpan(int col, int row, const u8* tiles, u8 fill, int count);
+    };
+}
+
+#endif // TILEMAP_HPP
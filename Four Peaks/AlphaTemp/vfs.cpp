@@ -0,0 +1,285 @@
+// ---------------------------------------------------------------------------
+// vfs.cpp
+// ---------------------------------------------------------------------------
+
+#include "vfs.hpp"
+#include "asset_manifest.hpp"
+#include "asset_pack.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>   // _mkdir
+#endif
+
+namespace vfs
+{
+    namespace
+    {
+        struct Mount
+        {
+            std::string path;
+            std::unique_ptr<game::PackFile> pack;
+        };
+
+        std::vector<Mount> mounts;   // searched back to front
+        game::AssetManifest cooked;
+        std::mutex extractLock;      // resolvePath may run on loader threads
+
+#ifdef _DEBUG
+        bool looseFirst = true;
+#else
+        bool looseFirst = false;
+#endif
+
+        bool looseExists(const char* path)
+        {
+#ifdef _WIN32
+            struct _stat64 st {};
+            return _stat64(path, &st) == 0 && (st.st_mode & _S_IFREG);
+#else
+            struct stat st {};
+            return stat(path, &st) == 0 && S_ISREG(st.st_mode);
+#endif
+        }
+
+        void makeDir(const std::string& dir)
+        {
+#ifdef _WIN32
+            _mkdir(dir.c_str());
+#else
+            mkdir(dir.c_str(), 0755);
+#endif
+        }
+
+        bool findEntry(u64 id, const game::PackFile*& pack, const game::PackEntry*& entry, size_t& mountIndex)
+        {
+            for (size_t i = mounts.size(); i-- > 0;)
+            {
+                const game::PackEntry* e = mounts[i].pack->find(id);
+                if (e)
+                {
+                    pack = mounts[i].pack.get();
+                    entry = e;
+                    mountIndex = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Path of an ID for the loose-file lookups: the cooked manifest
+        // knows every shipped asset, the debug name table covers the rest.
+        const char* loosePath(game::AssetId id)
+        {
+            const game::AssetManifest::Entry* e = cooked.find(id.value());
+            return e ? e->path.c_str() : game::assetName(id);
+        }
+    }
+
+    // ===================================================================
+    // File
+    // ===================================================================
+
+    File::File()
+        : bytes(nullptr)
+        , length(0)
+        , entryType(0)
+        , packed(false)
+    {
+    }
+
+    void File::close()
+    {
+        mapped.close();
+        storage.clear();
+        storage.shrink_to_fit();
+        bytes = nullptr;
+        length = 0;
+        entryType = 0;
+        packed = false;
+    }
+
+    // ===================================================================
+    // mounting
+    // ===================================================================
+
+    bool mount(const char* packPath)
+    {
+        std::unique_ptr<game::PackFile> pack(new game::PackFile());
+        if (!pack->open(packPath))
+            return false;
+
+        Mount m;
+        m.path = packPath;
+        m.pack = std::move(pack);
+        mounts.push_back(std::move(m));
+        return true;
+    }
+
+    void unmountAll()
+    {
+        mounts.clear();
+        cooked.clear();
+    }
+
+    void setLooseOverride(bool enabled) { looseFirst = enabled; }
+    bool looseOverride() { return looseFirst; }
+
+    // ===================================================================
+    // lookup
+    // ===================================================================
+
+    bool loadManifest()
+    {
+        return cooked.load(game::kManifestPath) && !cooked.empty();
+    }
+
+    const game::AssetManifest& manifest()
+    {
+        return cooked;
+    }
+
+    bool exists(const char* path)
+    {
+        return exists(game::AssetId(game::hashAssetPath(path)), path);
+    }
+
+    bool exists(game::AssetId id)
+    {
+        return exists(id, loosePath(id));
+    }
+
+    bool exists(game::AssetId id, const char* path)
+    {
+        if (!looseFirst && !cooked.empty())
+            return cooked.find(id.value()) != nullptr;
+
+        const game::PackFile* pack = nullptr;
+        const game::PackEntry* entry = nullptr;
+        size_t index = 0;
+        return (path && looseExists(path)) || findEntry(id.value(), pack, entry, index);
+    }
+
+    bool open(const char* path, File& out)
+    {
+        return open(game::AssetId(game::hashAssetPath(path)), path, out);
+    }
+
+    bool open(game::AssetId id, File& out)
+    {
+        return open(id, loosePath(id), out);
+    }
+
+    // -------------------------------------------------------------------
+    // open
+    // -------------------------------------------------------------------
+    bool open(game::AssetId id, const char* path, File& out)
+    {
+        out.close();
+
+        if (looseFirst && path && out.mapped.open(path))
+        {
+            out.bytes = out.mapped.data();
+            out.length = out.mapped.size();
+            return true;
+        }
+
+        const game::PackFile* pack = nullptr;
+        const game::PackEntry* entry = nullptr;
+        size_t index = 0;
+        if (findEntry(id.value(), pack, entry, index))
+        {
+            out.packed = true;
+            out.entryType = entry->type;
+
+            if (entry->compression == static_cast<u16>(game::PackCompression::Raw))
+            {
+                // zero-copy: straight from the pack mapping
+                out.bytes = pack->entryData(*entry);
+                out.length = entry->size;
+                return true;
+            }
+
+            out.storage.resize(entry->rawSize);
+            if (!pack->extract(*entry, out.storage.data()))
+            {
+                out.close();
+                return false;
+            }
+            out.bytes = out.storage.data();
+            out.length = out.storage.size();
+            return true;
+        }
+
+        if (!looseFirst && path && out.mapped.open(path))
+        {
+            out.bytes = out.mapped.data();
+            out.length = out.mapped.size();
+            return true;
+        }
+
+        return false;
+    }
+
+    std::string resolvePath(const char* path)
+    {
+        return resolvePath(game::AssetId(game::hashAssetPath(path)), path);
+    }
+
+    std::string resolvePath(game::AssetId id)
+    {
+        return resolvePath(id, loosePath(id));
+    }
+
+    // -------------------------------------------------------------------
+    // resolvePath
+    // -------------------------------------------------------------------
+    std::string resolvePath(game::AssetId id, const char* path)
+    {
+        if (looseFirst && path && looseExists(path))
+            return path;
+
+        const game::PackFile* pack = nullptr;
+        const game::PackEntry* entry = nullptr;
+        size_t index = 0;
+        if (!findEntry(id.value(), pack, entry, index))
+            return (path && looseExists(path)) ? std::string(path) : std::string();
+
+        // <pack>.cache/<hash><ext>; the extension keeps loaders that sniff
+        // it (audio) happy.
+        std::string name(path ? path : pack->entryName(*entry));
+        size_t dot = name.find_last_of('.');
+        size_t slash = name.find_last_of("/\\");
+        std::string ext = (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+            ? name.substr(dot) : std::string();
+
+        char hashText[17];
+        std::snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(entry->hash));
+
+        const std::string dir = mounts[index].path + ".cache";
+        const std::string cached = dir + "/" + hashText + ext;
+
+        std::lock_guard<std::mutex> guard(extractLock);
+
+        // Re-extract if missing, a different size or older than the pack
+        // (rebuilt since; an edit can keep the size).
+        struct stat st {};
+        struct stat packSt {};
+        if (stat(cached.c_str(), &st) == 0 && static_cast<u32>(st.st_size) == entry->rawSize &&
+            stat(mounts[index].path.c_str(), &packSt) == 0 && st.st_mtime >= packSt.st_mtime)
+            return cached;
+
+        std::vector<u8> bytes(entry->rawSize);
+        if (!pack->extract(*entry, bytes.data()))
+            return std::string();
+
+        makeDir(dir);
+        std::ofstream out(cached.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return out ? cached : std::string();
+    }
+}
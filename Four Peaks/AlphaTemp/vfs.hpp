@@ -0,0 +1,96 @@
+// ---------------------------------------------------------------------------
+// vfs.hpp
+// ---------------------------------------------------------------------------
+//
+// Virtual file system over mounted .pak archives and loose files.
+//
+// All asset reads go through vfs::open, either with a compile-time AssetId
+// (asset_ids.hpp) or with the usual "Assets/..." path, which is hashed to the
+// same ID. Pack lookups only compare IDs.
+// Lookup order:
+//   1. loose file on disk, if loose override is on (default in debug builds,
+//      so edited files win over the pack during development);
+//   2. mounted packs, most recently mounted first;
+//   3. loose file on disk (fallback, e.g. running without a pack).
+//
+// Loose files are memory-mapped and uncompressed pack entries point straight
+// into the pack's mapping, so both are zero-copy; LZ4 entries are
+// decompressed into memory owned by the File.
+//
+// This part is engine-free (shared with the tools); the Alpha Engine loader
+// helpers are in vfs_loaders.hpp.
+//
+
+#ifndef VFS_HPP
+#define VFS_HPP
+
+#include "asset_id.hpp"
+#include "mapped_file.hpp"
+#include <AETypes.h>   // u8, s8
+#include <string>
+#include <vector>
+
+namespace game
+{
+    class AssetManifest;
+}
+
+namespace vfs
+{
+    class File
+    {
+    public:
+        File();
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        bool isOpen() const { return bytes != nullptr; }
+        const u8* data() const { return bytes; }
+        size_t size() const { return length; }
+        u16 type() const { return entryType; }   // game::PackEntryType
+        bool fromPack() const { return packed; }
+        void close();
+
+    private:
+        friend bool open(game::AssetId id, const char* path, File& out);
+
+        game::MappedFile mapped;    // loose file
+        std::vector<u8> storage;    // decompressed pack entry
+        const u8* bytes;
+        size_t length;
+        u16 entryType;
+        bool packed;
+    };
+
+    // Mounts a pack. Later mounts take priority over earlier ones.
+    bool mount(const char* packPath);
+    void unmountAll();
+
+    void setLooseOverride(bool enabled);
+    bool looseOverride();
+
+    // Loads the cooked asset manifest (game::kManifestPath). Once loaded,
+    // exists() answers from it instead of asking the file system, unless
+    // loose override is on.
+    bool loadManifest();
+    const game::AssetManifest& manifest();
+
+    // The AssetId overloads find loose files through the manifest or the
+    // debug name table; the (id, path) forms skip that lookup.
+    bool exists(const char* path);
+    bool exists(game::AssetId id);
+    bool exists(game::AssetId id, const char* path);
+
+    bool open(const char* path, File& out);
+    bool open(game::AssetId id, File& out);
+    bool open(game::AssetId id, const char* path, File& out);
+
+    // For loaders that only accept a file name (fonts, audio): returns the
+    // loose path if present, otherwise extracts the pack entry once into a
+    // cache folder next to the pack and returns that path. Empty if missing.
+    std::string resolvePath(const char* path);
+    std::string resolvePath(game::AssetId id);
+    std::string resolvePath(game::AssetId id, const char* path);
+}
+
+#endif // VFS_HPP
@@ -0,0 +1,81 @@
+// ---------------------------------------------------------------------------
+// vfs_loaders.cpp
+// ---------------------------------------------------------------------------
+
+#include "vfs_loaders.hpp"
+#include "asset_pack.hpp"
+#include <cstring>
+#include <string>
+
+namespace vfs
+{
+    AEGfxTexture* textureFromFile(const File& file)
+    {
+        if (file.type() != static_cast<u16>(game::PackEntryType::Texture) ||
+            file.size() < sizeof(game::TextureBlobHeader))
+            return nullptr;
+
+        game::TextureBlobHeader hdr{};
+        std::memcpy(&hdr, file.data(), sizeof(hdr));
+
+        const size_t pixelBytes = static_cast<size_t>(hdr.width) * hdr.height * 4;
+        if (std::memcmp(hdr.magic, game::kTextureMagic, sizeof(hdr.magic)) != 0 ||
+            hdr.format != 0 || file.size() - sizeof(hdr) < pixelBytes)
+            return nullptr;
+
+        // AE copies the pixels to the GPU, it never writes them.
+        u8* pixels = const_cast<u8*>(file.data() + sizeof(hdr));
+        return AEGfxTextureLoadFromMemory(pixels, hdr.width, hdr.height);
+    }
+
+    AEGfxTexture* loadTexture(const char* path)
+    {
+        return loadTexture(game::AssetId(game::hashAssetPath(path)), path);
+    }
+
+    AEGfxTexture* loadTexture(game::AssetId id, const char* path)
+    {
+        File file;
+        const bool found = path ? open(id, path, file) : open(id, file);
+        if (found)
+        {
+            if (AEGfxTexture* tex = textureFromFile(file))
+                return tex;
+        }
+
+        std::string real = path ? resolvePath(id, path) : resolvePath(id);
+        return real.empty() ? nullptr : AEGfxTextureLoad(real.c_str());
+    }
+
+    s8 createFont(const char* path, int size)
+    {
+        std::string real = resolvePath(path);
+        return real.empty() ? static_cast<s8>(-1) : AEGfxCreateFont(real.c_str(), size);
+    }
+
+    s8 createFont(game::AssetId id, int size)
+    {
+        std::string real = resolvePath(id);
+        return real.empty() ? static_cast<s8>(-1) : AEGfxCreateFont(real.c_str(), size);
+    }
+
+    AEAudio loadSound(const char* path)
+    {
+        return AEAudioLoadSound(resolvePath(path).c_str());
+    }
+
+    AEAudio loadSound(game::AssetId id)
+    {
+        return AEAudioLoadSound(resolvePath(id).c_str());
+    }
+
+    AEAudio loadMusic(const char* path)
+    {
+        return AEAudioLoadMusic(resolvePath(path).c_str());
+    }
+
+    AEAudio loadMusic(game::AssetId id)
+    {
+        return AEAudioLoadMusic(resolvePath(id).c_str());
+    }
+}
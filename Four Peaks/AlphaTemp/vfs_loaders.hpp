@@ -0,0 +1,37 @@
+// ---------------------------------------------------------------------------
+// vfs_loaders.hpp
+// ---------------------------------------------------------------------------
+//
+// Alpha Engine resource loaders that read through the VFS.
+//
+// Cooked texture entries (PackEntryType::Texture) upload straight from the
+// mapped pack with AEGfxTextureLoadFromMemory. Fonts, audio and plain image
+// files can only be loaded by AE from a file name, so those go through
+// vfs::resolvePath (loose file, or a one-time extraction from the pack).
+//
+
+#ifndef VFS_LOADERS_HPP
+#define VFS_LOADERS_HPP
+
+#include "AEEngine.h"
+#include "vfs.hpp"
+
+namespace vfs
+{
+    // Uploads a cooked texture entry (PackEntryType::Texture) straight
+    // from the file's memory; nullptr if the file isn't one.
+    AEGfxTexture* textureFromFile(const File& file);
+
+    AEGfxTexture* loadTexture(const char* path);
+    AEGfxTexture* loadTexture(game::AssetId id, const char* path = nullptr);
+
+    s8 createFont(const char* path, int size);
+    s8 createFont(game::AssetId id, int size);
+
+    AEAudio loadSound(const char* path);
+    AEAudio loadSound(game::AssetId id);
+    AEAudio loadMusic(const char* path);
+    AEAudio loadMusic(game::AssetId id);
+}
+
+#endif // VFS_LOADERS_HPP
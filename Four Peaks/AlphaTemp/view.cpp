@@ -0,0 +1,85 @@
+// ---------------------------------------------------------------------------
+// view.cpp
+// ---------------------------------------------------------------------------
+
+#include "view.hpp"
+
+namespace view
+{
+    namespace
+    {
+        Metrics gMetrics{ static_cast<s32>(kVirtualWidth), static_cast<s32>(kVirtualHeight), 1.0f,
+            gfx::Mat2x3::identity(), gfx::Mat2x3::identity(),
+            -kVirtualWidth * 0.5f, kVirtualWidth * 0.5f, -kVirtualHeight * 0.5f, kVirtualHeight * 0.5f };
+        gfx::Vec2 gCamera;
+        bool gDirty = true;
+
+        void rebuild(s32 width, s32 height)
+        {
+            Metrics& m = gMetrics;
+            m.windowWidth = width;
+            m.windowHeight = height;
+
+            // Fit the virtual rect, keep the aspect.
+            const f32 sx = width / kVirtualWidth;
+            const f32 sy = height / kVirtualHeight;
+            m.scale = sx < sy ? sx : sy;
+
+            // AE window coordinates are pixels around its camera (origin).
+            m.worldToScreen = gfx::Mat2x3::scale(gfx::Vec2{ m.scale, m.scale }) *
+                gfx::Mat2x3::translation(-gCamera);
+            m.screenToWorld = gfx::inverse(m.worldToScreen);
+
+            const f32 halfW = width * 0.5f / m.scale;
+            const f32 halfH = height * 0.5f / m.scale;
+            m.minX = gCamera.x - halfW;
+            m.maxX = gCamera.x + halfW;
+            m.minY = gCamera.y - halfH;
+            m.maxY = gCamera.y + halfH;
+        }
+    }
+
+    void update()
+    {
+        s32 width = AEGfxGetWindowWidth();
+        s32 height = AEGfxGetWindowHeight();
+        if (width <= 0 || height <= 0)
+        {
+            // Minimised: keep the last mapping.
+            width = gMetrics.windowWidth;
+            height = gMetrics.windowHeight;
+        }
+
+        if (gDirty || width != gMetrics.windowWidth || height != gMetrics.windowHeight)
+        {
+            rebuild(width, height);
+            gDirty = false;
+        }
+    }
+
+    const Metrics& metrics()
+    {
+        return gMetrics;
+    }
+
+    void setCamera(gfx::Vec2 center)
+    {
+        // Rebuilt now, so draws later this frame already use it.
+        if (center.x != gCamera.x || center.y != gCamera.y)
+        {
+            gCamera = center;
+            rebuild(gMetrics.windowWidth, gMetrics.windowHeight);
+        }
+    }
+
+    gfx::Vec2 camera()
+    {
+        return gCamera;
+    }
+
+    gfx::Vec2 toNormalized(gfx::Vec2 world)
+    {
+        const gfx::Vec2 s = toScreen(world);
+        return gfx::Vec2{ s.x * 2.0f / gMetrics.windowWidth, s.y * 2.0f / gMetrics.windowHeight };
+    }
+}
@@ -0,0 +1,57 @@
+// ---------------------------------------------------------------------------
+// view.hpp
+// ---------------------------------------------------------------------------
+//
+// Virtual resolution: gameplay works in fixed world units, whatever the
+// window size.
+//
+// The view shows at least kVirtualWidth x kVirtualHeight world units around
+// the camera, scaled uniformly to fit the window (a window with a different
+// aspect sees a bit more along one axis). update() reads the window size
+// once per frame and only rebuilds the mapping when it or the camera
+// changed; everything else reads the cached metrics instead of asking the
+// AE DLL.
+//
+// The render queue and debug draw apply worldToScreen, so callers submit
+// world coordinates. AE's own camera stays at the origin.
+//
+
+#ifndef VIEW_HPP
+#define VIEW_HPP
+
+#include "AEEngine.h"
+#include "math2d.hpp"
+
+namespace view
+{
+    // The window the game was laid out for; one world unit = one pixel there.
+    static const f32 kVirtualWidth = 1600.0f;
+    static const f32 kVirtualHeight = 900.0f;
+
+    struct Metrics
+    {
+        s32 windowWidth;            // pixels
+        s32 windowHeight;
+        f32 scale;                  // pixels per world unit
+        gfx::Mat2x3 worldToScreen;  // to AE window coordinates
+        gfx::Mat2x3 screenToWorld;
+        f32 minX, maxX;             // visible world rect
+        f32 minY, maxY;
+    };
+
+    // Main thread, once per frame after AESysFrameStart().
+    void update();
+
+    const Metrics& metrics();
+
+    void setCamera(gfx::Vec2 center);
+    gfx::Vec2 camera();
+
+    inline gfx::Vec2 toScreen(gfx::Vec2 world) { return gfx::transformPoint(metrics().worldToScreen, world); }
+    inline gfx::Vec2 toWorld(gfx::Vec2 screen) { return gfx::transformPoint(metrics().screenToWorld, screen); }
+
+    // -1..1 across the window (AEGfxPrint).
+    gfx::Vec2 toNormalized(gfx::Vec2 world);
+}
+
+#endif // VIEW_HPP
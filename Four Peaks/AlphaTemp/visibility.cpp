@@ -0,0 +1,243 @@
+// ---------------------------------------------------------------------------
+// visibility.cpp
+// ---------------------------------------------------------------------------
+
+#include "visibility.hpp"
+#include <algorithm>
+
+namespace game
+{
+    namespace
+    {
+        // Rounding of exact fractions (b > 0).
+        int floorDiv(int a, int b)
+        {
+            return a >= 0 ? a / b : -((-a + b - 1) / b);
+        }
+
+        int ceilDiv(int a, int b)
+        {
+            return -floorDiv(-a, b);
+        }
+    }
+
+    Visibility::Visibility()
+        : cols(0)
+        , rows(0)
+        , chunkCols(0)
+        , chunkRows(0)
+        , radius(0)
+        , originCol(0)
+        , originRow(0)
+        , valid(false)
+    {
+    }
+
+    void Visibility::reset(const TileMap& map, int sightRadius)
+    {
+        cols = map.cols();
+        rows = map.rows();
+        chunkCols = map.chunkCols();
+        chunkRows = map.chunkRows();
+        radius = sightRadius;
+        valid = false;
+
+        const size_t tiles = static_cast<size_t>(cols) * rows;
+        mask.assign(tiles, 0);
+        solid.assign(tiles, 0);
+        chunkCounts.assign(static_cast<size_t>(chunkCols) * chunkRows, 0);
+        chunkTouched.assign(chunkCounts.size(), 0);
+
+        for (int cy = 0; cy < chunkRows; ++cy)
+            for (int cx = 0; cx < chunkCols; ++cx)
+                readChunk(map, cx, cy);
+    }
+
+    void Visibility::clear()
+    {
+        cols = rows = 0;
+        chunkCols = chunkRows = 0;
+        valid = false;
+        mask.clear();
+        solid.clear();
+        chunkCounts.clear();
+        chunkTouched.clear();
+    }
+
+    void Visibility::readChunk(const TileMap& map, int cx, int cy)
+    {
+        // Streamed-out chunks read as open air.
+        const TileMap::Chunk* chunk = map.chunk(cx, cy);
+        for (int ly = 0; ly < TileMap::kChunkSize; ++ly)
+        {
+            const int row = (cy << TileMap::kChunkShift) + ly;
+            for (int lx = 0; lx < TileMap::kChunkSize; ++lx)
+            {
+                const int col = (cx << TileMap::kChunkShift) + lx;
+                if (col < cols && row < rows)
+                    solid[row * cols + col] = chunk && chunk->tiles[(ly << TileMap::kChunkShift) | lx] != 0;
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // update
+    // -------------------------------------------------------------------
+    bool Visibility::update(TileMap& map, int col, int row)
+    {
+        // A resized map needs a reset() first.
+        if (empty() || map.cols() != cols || map.rows() != rows)
+            return false;
+
+        bool stale = !valid || col != originCol || row != originRow;
+
+        // Edits outside the sight box only update the solid copy.
+        const int sx0 = (originCol - radius) >> TileMap::kChunkShift;
+        const int sx1 = (originCol + radius) >> TileMap::kChunkShift;
+        const int sy0 = (originRow - radius) >> TileMap::kChunkShift;
+        const int sy1 = (originRow + radius) >> TileMap::kChunkShift;
+        for (int cy = 0; cy < chunkRows; ++cy)
+        {
+            for (int cx = 0; cx < chunkCols; ++cx)
+            {
+                if (!(map.dirtyFlags(cx, cy) & TileMap::DirtyVision))
+                    continue;
+                map.clearDirty(cx, cy, TileMap::DirtyVision);
+
+                readChunk(map, cx, cy);
+                stale = stale || (cx >= sx0 && cx <= sx1 && cy >= sy0 && cy <= sy1);
+            }
+        }
+
+        std::fill(chunkTouched.begin(), chunkTouched.end(), static_cast<u8>(0));
+        if (!stale)
+            return false;
+
+        // Everything visible is inside the old box.
+        if (valid)
+        {
+            touchBox(originCol, originRow);
+            const int r0 = std::max(originRow - radius, 0), r1 = std::min(originRow + radius, rows - 1);
+            const int c0 = std::max(originCol - radius, 0), c1 = std::min(originCol + radius, cols - 1);
+            for (int r = r0; r <= r1; ++r)
+            {
+                for (int c = c0; c <= c1; ++c)
+                {
+                    u8& m = mask[r * cols + c];
+                    if (m)
+                    {
+                        m = 0;
+                        --chunkCounts[(r >> TileMap::kChunkShift) * chunkCols + (c >> TileMap::kChunkShift)];
+                    }
+                }
+            }
+        }
+
+        originCol = col;
+        originRow = row;
+        valid = true;
+        recompute();
+        return true;
+    }
+
+    void Visibility::touchBox(int col, int row)
+    {
+        // One tile wider: a chunk's light texture borders on its neighbours.
+        const int reach = radius + 1;
+        const int cx0 = std::max((col - reach) >> TileMap::kChunkShift, 0);
+        const int cx1 = std::min((col + reach) >> TileMap::kChunkShift, chunkCols - 1);
+        const int cy0 = std::max((row - reach) >> TileMap::kChunkShift, 0);
+        const int cy1 = std::min((row + reach) >> TileMap::kChunkShift, chunkRows - 1);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx)
+                chunkTouched[cy * chunkCols + cx] = 1;
+    }
+
+    // -------------------------------------------------------------------
+    // shadowcasting
+    // -------------------------------------------------------------------
+    void Visibility::recompute()
+    {
+        touchBox(originCol, originRow);
+        reveal(0, 0, 0);
+
+        // Each quadrant starts one row out, spanning -45..45 degrees.
+        for (int q = 0; q < 4; ++q)
+            scan(q, 1, Slope{ -1, 1 }, Slope{ 1, 1 });
+    }
+
+    void Visibility::toMap(int q, int depth, int offset, int& col, int& row) const
+    {
+        switch (q)
+        {
+        case 0:  col = originCol + offset; row = originRow + depth; break;  // up
+        case 1:  col = originCol + offset; row = originRow - depth; break;  // down
+        case 2:  col = originCol + depth; row = originRow + offset; break;  // right
+        default: col = originCol - depth; row = originRow + offset; break;  // left
+        }
+    }
+
+    bool Visibility::blocks(int q, int depth, int offset) const
+    {
+        int col, row;
+        toMap(q, depth, offset, col, row);
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return true;
+        return solid[row * cols + col] != 0;
+    }
+
+    void Visibility::reveal(int q, int depth, int offset)
+    {
+        // Round sight, not a square.
+        if (depth * depth + offset * offset > radius * radius + radius)
+            return;
+
+        int col, row;
+        toMap(q, depth, offset, col, row);
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return;
+
+        u8& m = mask[row * cols + col];
+        if (!m)
+        {
+            m = 1;
+            ++chunkCounts[(row >> TileMap::kChunkShift) * chunkCols + (col >> TileMap::kChunkShift)];
+        }
+    }
+
+    void Visibility::scan(int q, int depth, Slope start, Slope end)
+    {
+        if (depth > radius)
+            return;
+
+        // Tiles whose centre line falls inside [start, end], ties rounded
+        // inwards.
+        const int first = floorDiv(2 * depth * start.num + start.den, 2 * start.den);
+        const int last = ceilDiv(2 * depth * end.num - end.den, 2 * end.den);
+
+        int prev = -1;      // -1 none yet, 0 floor, 1 wall
+        for (int offset = first; offset <= last; ++offset)
+        {
+            const bool wall = blocks(q, depth, offset);
+
+            // Floor tiles only count if their centre is inside the slopes;
+            // that's what makes the result symmetric.
+            const bool centred = offset * start.den >= depth * start.num &&
+                offset * end.den <= depth * end.num;
+            if (wall || centred)
+                reveal(q, depth, offset);
+
+            // Slope through the near edge of this tile.
+            const Slope edge{ 2 * offset - 1, 2 * depth };
+            if (prev == 1 && !wall)
+                start = edge;
+            if (prev == 0 && wall)
+                scan(q, depth + 1, start, edge);
+
+            prev = wall ? 1 : 0;
+        }
+
+        if (prev == 0)
+            scan(q, depth + 1, start, end);
+    }
+}
@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------------
+// visibility.hpp
+// ---------------------------------------------------------------------------
+//
+// Line of sight from one tile over the TileMap, for blackout stages.
+//
+// Symmetric shadowcasting: each of the four quadrants around the origin is
+// scanned row by row outwards, and every run of floor tiles recurses into
+// the next row with its slopes narrowed by the walls at its ends. Slopes are
+// kept as exact fractions, so the result doesn't depend on float rounding,
+// and it is symmetric: if A sees B, B sees A. Walls bounding a visible area
+// are visible too.
+//
+// The mask is cached. update() only recomputes it when the origin moved to
+// another tile or a tile inside the sight radius changed (chunks flagged
+// DirtyVision), and then only clears the previous sight box, not the map.
+//
+
+#ifndef VISIBILITY_HPP
+#define VISIBILITY_HPP
+
+#include "tilemap.hpp"
+#include <vector>
+
+namespace game
+{
+    class Visibility
+    {
+    public:
+        Visibility();
+
+        // Sizes to the map; nothing visible until the next update().
+        void reset(const TileMap& map, int radius);
+        void clear();
+        bool empty() const { return cols == 0; }
+
+        // Returns true if the mask was recomputed. Clears DirtyVision.
+        bool update(TileMap& map, int col, int row);
+
+        bool visible(int col, int row) const
+        {
+            return col >= 0 && row >= 0 && col < cols && row < rows && mask[row * cols + col] != 0;
+        }
+
+        // Any visible tile in the chunk (draw culling).
+        bool chunkVisible(int cx, int cy) const { return chunkCounts[cy * chunkCols + cx] != 0; }
+        // Chunks whose mask may have changed in the last recompute.
+        bool chunkChanged(int cx, int cy) const { return chunkTouched[cy * chunkCols + cx] != 0; }
+
+    private:
+        // Slope as an exact fraction, den > 0.
+        struct Slope
+        {
+            int num;
+            int den;
+        };
+
+        int cols;
+        int rows;
+        int chunkCols;
+        int chunkRows;
+        int radius;
+        int originCol;
+        int originRow;
+        bool valid;                 // mask matches origin and map
+
+        std::vector<u8> mask;       // cols * rows, 1 = visible
+        std::vector<u8> solid;      // cols * rows, 1 = blocks sight
+        std::vector<u16> chunkCounts;
+        std::vector<u8> chunkTouched;
+
+        void readChunk(const TileMap& map, int cx, int cy);
+        void recompute();
+        void touchBox(int col, int row);
+
+        // Quadrant q, distance `depth` out, `offset` across -> map tile.
+        void toMap(int q, int depth, int offset, int& col, int& row) const;
+        bool blocks(int q, int depth, int offset) const;
+        void reveal(int q, int depth, int offset);
+        void scan(int q, int depth, Slope start, Slope end);
+    };
+}
+
+#endif // VISIBILITY_HPP
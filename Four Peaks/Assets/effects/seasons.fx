@@ -0,0 +1,98 @@
+# Weather and impact particles.
+#
+# emitter <name>
+#   texture <asset path>        optional; flat colored quads without one
+#   layer   back|front          behind the tiles or over the entities
+#   rate    <per second>        while started
+#   burst   <count>             per burst()
+#   life    <min> <max>         seconds
+#   area    <w> <h>             spawn box, world units, centred on the emitter
+#   angle   <degrees> <spread>  0 = right, 90 = up
+#   speed   <min> <max>
+#   gravity <x> <y>
+#   drag    <0..1>              velocity lost per second
+#   size    <start> <end>
+#   color   <start> <end>       ARGB hex
+# end
+#
+# The stage starts the emitter named after the level's season along the top
+# of the view, so weather needs to fall at least 900 units in its life.
+
+emitter winter
+layer front
+rate 220
+life 9 14
+area 1800 0
+angle 270 20
+speed 40 90
+gravity 6 -6
+drag 0.1
+size 6 4
+color E0FFFFFF 00FFFFFF
+end
+
+emitter autumn
+layer front
+rate 30
+life 8 12
+area 1800 0
+angle 250 30
+speed 60 120
+gravity 10 -12
+drag 0.05
+size 12 10
+color FFD2691E 00A0522D
+end
+
+emitter spring
+layer front
+rate 24
+life 9 13
+area 1800 0
+angle 260 25
+speed 50 100
+gravity 8 -8
+drag 0.05
+size 8 6
+color F0FFB7C5 00FFC0CB
+end
+
+# Drifts down slowly; much of it fades out on the way.
+emitter summer
+layer back
+rate 60
+life 6 10
+area 1800 0
+angle 270 60
+speed 10 40
+gravity 4 -6
+drag 0.2
+size 4 4
+color C0FFF176 00FFF176
+end
+
+emitter dust_land
+layer front
+burst 16
+life 0.25 0.5
+area 24 0
+angle 90 70
+speed 60 160
+gravity 0 -300
+drag 0.9
+size 6 12
+color C0B8A27A 00B8A27A
+end
+
+emitter spike_hit
+layer front
+burst 24
+life 0.2 0.4
+area 16 0
+angle 90 50
+speed 150 300
+gravity 0 -600
+drag 0.5
+size 5 2
+color FFFF4040 00801010
+end
@@ -0,0 +1,888 @@
+// ---------------------------------------------------------------------------
+// assetcook.cpp
+// ---------------------------------------------------------------------------
+//
+// Incremental asset cook: Assets/ -> Cooked/ -> Assets.pak.
+//
+// Every source file is matched to a cook rule by extension:
+//
+//   *.png               texture   decoded to a TextureBlobHeader + RGBA8 blob
+//   levels/*.txt        level     converted to the binary .lvl format
+//   *.anim              anim      frames trimmed to their visible pixels and
+//                                 packed into one atlas (see anim_format.hpp)
+//   anything else       copy      stored as is (fonts, audio, ...)
+//
+// A source is only recooked when the hash of its bytes, of the files it
+// reads (an anim's sprite sheets) or of its cook parameters (rule, rule
+// version, output format version) differs from the last cook, or when its
+// cooked output is missing or was modified. The
+// hashes live in Cooked/cook.cache. Independent jobs run in parallel on all
+// cores.
+//
+// The results are listed in an asset manifest (AlphaTemp/asset_manifest.hpp)
+// which is packed together with the cooked files, so the runtime never has
+// to look at the source files. The pack is only rewritten when the manifest
+// changed.
+//
+// With -g it also regenerates the AssetId header (AlphaTemp/asset_ids.hpp):
+// one constexpr ID per cooked asset plus the debug reverse-name table. The
+// header is only rewritten when its contents change.
+//
+// Usage (from the game's working directory):
+//   assetcook [-j jobs] [-o Assets.pak] [-c Cooked] [-g header] [-f] [Assets]
+//     -f   ignore the cache and recook everything
+//
+// Build (from this folder):
+//   g++ -std=c++17 -O2 -pthread -I../../AlphaTemp -I../../Extern/AlphaEngine/include
+//       assetcook.cpp png.cpp ../../AlphaTemp/anim_format.cpp ../../AlphaTemp/asset_id.cpp
+//       ../../AlphaTemp/asset_manifest.cpp ../../AlphaTemp/asset_pack.cpp ../../AlphaTemp/job_system.cpp
+//       ../../AlphaTemp/level_format.cpp ../../AlphaTemp/lz4.cpp ../../AlphaTemp/mapped_file.cpp
+//       ../../AlphaTemp/tilemap.cpp ../../AlphaTemp/vfs.cpp
+//       -o assetcook
+//   cl /std:c++17 /O2 /EHsc /I..\..\AlphaTemp /I..\..\Extern\AlphaEngine\include
+//       assetcook.cpp png.cpp ..\..\AlphaTemp\anim_format.cpp ..\..\AlphaTemp\asset_id.cpp
+//       ..\..\AlphaTemp\asset_manifest.cpp ..\..\AlphaTemp\asset_pack.cpp ..\..\AlphaTemp\job_system.cpp
+//       ..\..\AlphaTemp\level_format.cpp ..\..\AlphaTemp\lz4.cpp ..\..\AlphaTemp\mapped_file.cpp
+//       ..\..\AlphaTemp\tilemap.cpp ..\..\AlphaTemp\vfs.cpp
+// ---------------------------------------------------------------------------
+
+#include "anim_format.hpp"
+#include "asset_manifest.hpp"
+#include "asset_pack.hpp"
+#include "job_system.hpp"
+#include "level_format.hpp"
+#include "png.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Bump to force a full recook after changing this tool in a way that
+// affects its output.
+static const u32 kCookVersion = 1;
+static const int kCacheVersion = 1;
+
+// ---------------------------------------------------------------------------
+// rules
+// ---------------------------------------------------------------------------
+
+struct CookInput
+{
+    std::vector<u8> source;
+    std::vector<std::vector<u8>> deps;  // the files named by the rule's dependencies(), in order
+};
+
+struct CookRule
+{
+    const char* name;
+    u32 version;                // bump when this rule's output changes
+    u32 formatVersion;          // runtime format the output targets
+    game::PackEntryType type;
+    bool (*cook)(const CookInput& in, std::vector<u8>& out, std::string& error);
+
+    // Other files the output is built from (paths from the working
+    // directory); nullptr if none.
+    void (*dependencies)(const std::vector<u8>& src, std::vector<std::string>& paths);
+};
+
+static bool cookTexture(const CookInput& in, std::vector<u8>& out, std::string& error)
+{
+    uint32_t width = 0, height = 0;
+    std::vector<uint8_t> pixels;
+    if (!png::decode(in.source.data(), in.source.size(), width, height, pixels, error))
+        return false;
+
+    game::TextureBlobHeader hdr{};
+    std::memcpy(hdr.magic, game::kTextureMagic, sizeof(hdr.magic));
+    hdr.width = width;
+    hdr.height = height;
+    hdr.format = 0;
+
+    out.resize(sizeof(hdr) + pixels.size());
+    std::memcpy(out.data(), &hdr, sizeof(hdr));
+    std::memcpy(out.data() + sizeof(hdr), pixels.data(), pixels.size());
+    return true;
+}
+
+static bool cookLevel(const CookInput& in, std::vector<u8>& out, std::string& error)
+{
+    game::LevelSource level;
+    std::string text(in.source.begin(), in.source.end());
+    if (!game::parseLevelText(text, level, error))
+        return false;
+
+    game::buildLevelImage(level, out);
+
+    // Same check levelconv does: the runtime loader must accept it.
+    game::LevelFile check;
+    if (!check.openMemory(out))
+    {
+        error = "cooked level failed validation";
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// anim: trim and pack sprite frames
+// ---------------------------------------------------------------------------
+
+// Transparent gap around every packed frame, so filtering at a frame's edge
+// blends with nothing but transparency, as it did in the sheet.
+static const u32 kAtlasPadding = 2;
+
+struct TrimmedFrame
+{
+    const uint8_t* pixels;      // top left of the visible rect in its sheet
+    u32 stride;                 // sheet row, bytes
+    u32 width, height;          // visible rect
+    u64 hash;                   // of the visible pixels, for sharing
+    u32 atlasX = 0, atlasY = 0;
+    u32 shared = ~0u;           // same pixels as this earlier frame
+};
+
+// Sheets in order of first use; shared by the dependency list and the cook.
+static std::vector<std::string> animSheets(const game::AnimSource& anim)
+{
+    std::vector<std::string> sheets;
+    for (const game::AnimClipSource& c : anim.clips)
+    {
+        if (std::find(sheets.begin(), sheets.end(), c.sheet) == sheets.end())
+            sheets.push_back(c.sheet);
+    }
+    return sheets;
+}
+
+static void animDependencies(const std::vector<u8>& src, std::vector<std::string>& paths)
+{
+    game::AnimSource anim;
+    std::string error;
+    if (game::parseAnimText(std::string(src.begin(), src.end()), anim, error))
+        paths = animSheets(anim);
+}
+
+static bool samePixels(const TrimmedFrame& a, const TrimmedFrame& b)
+{
+    if (a.hash != b.hash || a.width != b.width || a.height != b.height)
+        return false;
+    for (u32 y = 0; y < a.height; ++y)
+    {
+        if (std::memcmp(a.pixels + y * a.stride, b.pixels + y * b.stride, a.width * 4) != 0)
+            return false;
+    }
+    return true;
+}
+
+static bool cookAnim(const CookInput& in, std::vector<u8>& out, std::string& error)
+{
+    game::AnimSource anim;
+    if (!game::parseAnimText(std::string(in.source.begin(), in.source.end()), anim, error))
+        return false;
+
+    const std::vector<std::string> sheetPaths = animSheets(anim);
+    if (in.deps.size() != sheetPaths.size())
+    {
+        error = "sprite sheet list changed while cooking";
+        return false;
+    }
+
+    struct Sheet
+    {
+        uint32_t width = 0, height = 0;
+        std::vector<uint8_t> pixels;
+    };
+    std::vector<Sheet> sheets(sheetPaths.size());
+    for (size_t i = 0; i < sheets.size(); ++i)
+    {
+        if (!png::decode(in.deps[i].data(), in.deps[i].size(), sheets[i].width, sheets[i].height,
+            sheets[i].pixels, error))
+        {
+            error = sheetPaths[i] + ": " + error;
+            return false;
+        }
+    }
+
+    // Trim every frame to the bounding box of its non-transparent pixels
+    // and record where that box sits in the untrimmed frame.
+    std::vector<TrimmedFrame> trimmed(anim.frames.size());
+    for (game::AnimClipSource& c : anim.clips)
+    {
+        const size_t s = std::find(sheetPaths.begin(), sheetPaths.end(), c.sheet) - sheetPaths.begin();
+        const Sheet& sheet = sheets[s];
+        c.sheet.clear();    // everything ends up in the atlas
+
+        for (u32 i = c.firstFrame; i < c.firstFrame + c.frameCount; ++i)
+        {
+            game::AnimFrame& f = anim.frames[i];
+            const long x0 = std::lround(f.u0 * sheet.width), x1 = std::lround(f.u1 * sheet.width);
+            const long y0 = std::lround(f.v0 * sheet.height), y1 = std::lround(f.v1 * sheet.height);
+            if (x0 < 0 || y0 < 0 || x1 > static_cast<long>(sheet.width) || y1 > static_cast<long>(sheet.height) ||
+                x1 <= x0 || y1 <= y0)
+            {
+                error = "clip '" + c.name + "': frame " + std::to_string(i - c.firstFrame) +
+                    " is not a rect inside " + sheetPaths[s];
+                return false;
+            }
+
+            const u32 stride = sheet.width * 4;
+            u32 minX = ~0u, minY = ~0u, maxX = 0, maxY = 0;
+            for (long y = y0; y < y1; ++y)
+            {
+                const uint8_t* row = sheet.pixels.data() + y * stride;
+                for (long x = x0; x < x1; ++x)
+                {
+                    if (row[x * 4 + 3] == 0)
+                        continue;
+                    minX = std::min(minX, static_cast<u32>(x));
+                    maxX = std::max(maxX, static_cast<u32>(x));
+                    minY = std::min(minY, static_cast<u32>(y));
+                    maxY = std::max(maxY, static_cast<u32>(y));
+                }
+            }
+            if (minX == ~0u)
+            {
+                // Fully transparent: keep one texel so the frame still has a quad.
+                minX = maxX = static_cast<u32>(x0);
+                minY = maxY = static_cast<u32>(y0);
+            }
+
+            TrimmedFrame& t = trimmed[i];
+            t.stride = stride;
+            t.pixels = sheet.pixels.data() + minY * stride + minX * 4;
+            t.width = maxX - minX + 1;
+            t.height = maxY - minY + 1;
+            t.hash = 0;
+            for (u32 y = 0; y < t.height; ++y)
+                t.hash = t.hash * 31 + game::hashBytes(t.pixels + y * stride, t.width * 4);
+
+            // y up, like the quad the frame is drawn on.
+            const f32 fw = static_cast<f32>(x1 - x0), fh = static_cast<f32>(y1 - y0);
+            f.width = t.width / fw;
+            f.height = t.height / fh;
+            f.offsetX = ((minX - x0) + t.width * 0.5f) / fw - 0.5f;
+            f.offsetY = 0.5f - ((minY - y0) + t.height * 0.5f) / fh;
+        }
+    }
+
+    // Frames that are pixel for pixel the same share one atlas rect.
+    std::vector<u32> order;
+    u64 area = 0;
+    u32 widest = 1;
+    for (u32 i = 0; i < trimmed.size(); ++i)
+    {
+        for (u32 j = 0; j < i && trimmed[i].shared == ~0u; ++j)
+        {
+            if (trimmed[j].shared == ~0u && samePixels(trimmed[i], trimmed[j]))
+                trimmed[i].shared = j;
+        }
+        if (trimmed[i].shared != ~0u)
+            continue;
+        order.push_back(i);
+        area += static_cast<u64>(trimmed[i].width + kAtlasPadding) * (trimmed[i].height + kAtlasPadding);
+        widest = std::max(widest, trimmed[i].width + kAtlasPadding * 2);
+    }
+
+    // Shelf packing, tallest first, into a roughly square atlas.
+    std::stable_sort(order.begin(), order.end(),
+        [&](u32 a, u32 b) { return trimmed[a].height > trimmed[b].height; });
+
+    u32 atlasWidth = std::max(widest, static_cast<u32>(std::ceil(std::sqrt(static_cast<double>(area)))));
+    u32 x = kAtlasPadding, y = kAtlasPadding, shelf = 0;
+    for (u32 i : order)
+    {
+        TrimmedFrame& t = trimmed[i];
+        if (x + t.width + kAtlasPadding > atlasWidth)
+        {
+            x = kAtlasPadding;
+            y += shelf + kAtlasPadding;
+            shelf = 0;
+        }
+        t.atlasX = x;
+        t.atlasY = y;
+        x += t.width + kAtlasPadding;
+        shelf = std::max(shelf, t.height);
+    }
+    const u32 atlasHeight = y + shelf + kAtlasPadding;
+
+    std::vector<u8> atlas(sizeof(game::TextureBlobHeader) + static_cast<size_t>(atlasWidth) * atlasHeight * 4, 0);
+    game::TextureBlobHeader hdr{};
+    std::memcpy(hdr.magic, game::kTextureMagic, sizeof(hdr.magic));
+    hdr.width = atlasWidth;
+    hdr.height = atlasHeight;
+    hdr.format = 0;
+    std::memcpy(atlas.data(), &hdr, sizeof(hdr));
+
+    u8* atlasPixels = atlas.data() + sizeof(hdr);
+    for (u32 i : order)
+    {
+        const TrimmedFrame& t = trimmed[i];
+        for (u32 row = 0; row < t.height; ++row)
+        {
+            std::memcpy(atlasPixels + (static_cast<size_t>(t.atlasY + row) * atlasWidth + t.atlasX) * 4,
+                t.pixels + row * t.stride, t.width * 4);
+        }
+    }
+
+    for (u32 i = 0; i < trimmed.size(); ++i)
+    {
+        const TrimmedFrame& t = trimmed[trimmed[i].shared != ~0u ? trimmed[i].shared : i];
+        game::AnimFrame& f = anim.frames[i];
+        f.u0 = static_cast<f32>(t.atlasX) / atlasWidth;
+        f.u1 = static_cast<f32>(t.atlasX + t.width) / atlasWidth;
+        f.v0 = static_cast<f32>(t.atlasY) / atlasHeight;
+        f.v1 = static_cast<f32>(t.atlasY + t.height) / atlasHeight;
+    }
+
+    if (!game::buildAnimImage(anim, atlas, out, error))
+        return false;
+
+    // The runtime loader must accept it.
+    game::AnimSource check;
+    const u8* checkAtlas = nullptr;
+    size_t checkSize = 0;
+    if (!game::readAnimImage(out.data(), out.size(), check, checkAtlas, checkSize, error))
+    {
+        error = "cooked animation failed validation: " + error;
+        return false;
+    }
+    return true;
+}
+
+static bool cookCopy(const CookInput& in, std::vector<u8>& out, std::string&)
+{
+    out = in.source;
+    return true;
+}
+
+static const CookRule kTextureRule = { "texture", 1, 0, game::PackEntryType::Texture, cookTexture, nullptr };
+static const CookRule kLevelRule = { "level", 1, game::kLevelVersion, game::PackEntryType::Blob, cookLevel, nullptr };
+static const CookRule kAnimRule = { "anim", 1, game::kAnimVersion, game::PackEntryType::Blob, cookAnim, animDependencies };
+static const CookRule kCopyRule = { "copy", 1, 0, game::PackEntryType::Blob, cookCopy, nullptr };
+
+static u64 paramsHash(const CookRule& rule)
+{
+    char text[128];
+    std::snprintf(text, sizeof(text), "%u|%s|%u|%u|%u", kCookVersion, rule.name,
+        rule.version, rule.formatVersion, static_cast<unsigned>(rule.type));
+    return game::hashBytes(reinterpret_cast<const u8*>(text), std::strlen(text));
+}
+
+// ---------------------------------------------------------------------------
+// cache
+// ---------------------------------------------------------------------------
+
+struct CacheEntry
+{
+    u64 sourceHash = 0;
+    u64 paramsHash = 0;
+    u64 outputHash = 0;
+    u64 outputSize = 0;
+};
+
+typedef std::map<std::string, CacheEntry> CookCache;
+
+static void loadCache(const fs::path& path, CookCache& cache)
+{
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != "version " + std::to_string(kCacheVersion))
+        return;
+
+    while (std::getline(in, line))
+    {
+        CacheEntry e;
+        unsigned long long a, b, c, d;
+        int consumed = 0;
+        if (std::sscanf(line.c_str(), "%llx\t%llx\t%llx\t%llu\t%n", &a, &b, &c, &d, &consumed) != 4 ||
+            consumed == 0)
+            continue;
+        e.sourceHash = a;
+        e.paramsHash = b;
+        e.outputHash = c;
+        e.outputSize = d;
+        cache[line.substr(consumed)] = e;
+    }
+}
+
+static bool saveCache(const fs::path& path, const CookCache& cache)
+{
+    fs::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        out << "version " << kCacheVersion << "\n";
+        char buf[96];
+        for (const auto& kv : cache)
+        {
+            std::snprintf(buf, sizeof(buf), "%016llx\t%016llx\t%016llx\t%llu\t",
+                static_cast<unsigned long long>(kv.second.sourceHash),
+                static_cast<unsigned long long>(kv.second.paramsHash),
+                static_cast<unsigned long long>(kv.second.outputHash),
+                static_cast<unsigned long long>(kv.second.outputSize));
+            out << buf << kv.first << "\n";
+        }
+        if (!out)
+            return false;
+    }
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    return !ec;
+}
+
+// ---------------------------------------------------------------------------
+// jobs
+// ---------------------------------------------------------------------------
+
+enum class JobResult
+{
+    Cached,
+    Cooked,
+    Failed
+};
+
+struct CookJob
+{
+    fs::path source;
+    std::string asset;          // runtime path, e.g. "Assets/levels/a.lvl"
+    fs::path output;            // cooked file
+    const CookRule* rule = nullptr;
+
+    // filled in by the worker
+    JobResult result = JobResult::Failed;
+    CacheEntry cache;
+    std::vector<u8> bytes;      // cooked output, kept for packing
+    std::string error;
+};
+
+static bool readFile(const fs::path& path, std::vector<u8>& out)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+
+    std::streamsize size = in.tellg();
+    in.seekg(0);
+    out.resize(static_cast<size_t>(size));
+    return size == 0 || in.read(reinterpret_cast<char*>(out.data()), size).good();
+}
+
+static bool writeFileAtomic(const fs::path& path, const std::vector<u8>& bytes)
+{
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+
+    fs::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+            return false;
+    }
+    fs::rename(temp, path, ec);
+    return !ec;
+}
+
+static void runJob(CookJob& job, const CookCache& previous, bool force)
+{
+    CookInput in;
+    if (!readFile(job.source, in.source))
+    {
+        job.error = "cannot read source";
+        return;
+    }
+
+    job.cache.sourceHash = game::hashBytes(in.source.data(), in.source.size());
+    if (job.rule->dependencies)
+    {
+        // Folded into the source hash, so editing a dependency recooks.
+        std::vector<std::string> paths;
+        job.rule->dependencies(in.source, paths);
+        std::vector<u64> hashes(1, job.cache.sourceHash);
+        in.deps.resize(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            if (!readFile(paths[i], in.deps[i]))
+            {
+                job.error = "cannot read " + paths[i];
+                return;
+            }
+            hashes.push_back(game::hashBytes(in.deps[i].data(), in.deps[i].size()));
+        }
+        job.cache.sourceHash = game::hashBytes(reinterpret_cast<const u8*>(hashes.data()), hashes.size() * sizeof(u64));
+    }
+
+    job.cache.paramsHash = paramsHash(*job.rule);
+
+    // Up to date if the inputs match and the cooked file is still what we
+    // wrote last time.
+    auto it = previous.find(job.asset);
+    if (!force && it != previous.end() &&
+        it->second.sourceHash == job.cache.sourceHash &&
+        it->second.paramsHash == job.cache.paramsHash &&
+        readFile(job.output, job.bytes) &&
+        job.bytes.size() == it->second.outputSize &&
+        game::hashBytes(job.bytes.data(), job.bytes.size()) == it->second.outputHash)
+    {
+        job.cache = it->second;
+        job.result = JobResult::Cached;
+        return;
+    }
+
+    job.bytes.clear();
+    if (!job.rule->cook(in, job.bytes, job.error))
+        return;
+
+    if (!writeFileAtomic(job.output, job.bytes))
+    {
+        job.error = "cannot write " + job.output.generic_string();
+        return;
+    }
+
+    job.cache.outputHash = game::hashBytes(job.bytes.data(), job.bytes.size());
+    job.cache.outputSize = job.bytes.size();
+    job.result = JobResult::Cooked;
+}
+
+static void runJobs(std::vector<CookJob>& jobs, const CookCache& previous, bool force, unsigned threadCount)
+{
+    if (threadCount <= 1)
+    {
+        for (CookJob& job : jobs)
+            runJob(job, previous, force);
+        return;
+    }
+
+    // The main thread helps while it waits, so threadCount - 1 workers.
+    game::JobSystem workers(threadCount - 1);
+    workers.parallelFor(0, jobs.size(), 1, [&](size_t i) { runJob(jobs[i], previous, force); });
+}
+
+// ---------------------------------------------------------------------------
+// scanning
+// ---------------------------------------------------------------------------
+
+static const CookRule* pickRule(const fs::path& path)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (ext == ".png")
+        return &kTextureRule;
+    if (ext == ".txt" && path.parent_path().filename() == "levels")
+        return &kLevelRule;
+    if (ext == ".anim")
+        return &kAnimRule;
+    return &kCopyRule;
+}
+
+static bool scanSources(const std::string& root, const fs::path& cacheDir, std::vector<CookJob>& jobs)
+{
+    std::error_code ec;
+    std::vector<fs::path> files;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec))
+    {
+        const std::string name = it->path().filename().string();
+        if (it->is_regular_file() && !name.empty() && name[0] != '.')
+            files.push_back(it->path());
+    }
+    if (ec)
+    {
+        std::fprintf(stderr, "assetcook: cannot read %s: %s\n", root.c_str(), ec.message().c_str());
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const fs::path& file : files)
+    {
+        CookJob job;
+        job.source = file;
+        job.rule = pickRule(file);
+
+        fs::path asset = file;
+        if (job.rule == &kLevelRule)
+            asset.replace_extension(".lvl");
+        else if (file.extension() == ".lvl")
+        {
+            // A checked-in .lvl next to its text source is a levelconv
+            // output; the text source wins.
+            fs::path text = file;
+            if (fs::exists(text.replace_extension(".txt")))
+                continue;
+        }
+
+        job.asset = asset.generic_string();
+        job.output = cacheDir / asset;
+        jobs.push_back(std::move(job));
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// AssetId header
+// ---------------------------------------------------------------------------
+
+// "Assets/player/male_hero-idle.png" -> "kPlayerMaleHeroIdle"
+static std::string constantName(const std::string& asset, bool withExtension)
+{
+    std::string path = asset;
+    if (path.compare(0, 7, "Assets/") == 0)
+        path.erase(0, 7);
+    if (!withExtension)
+    {
+        size_t dot = path.find_last_of('.');
+        if (dot != std::string::npos && path.find('/', dot) == std::string::npos)
+            path.erase(dot);
+    }
+
+    std::string name = "k";
+    bool upper = true;
+    for (char c : path)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(c)))
+        {
+            upper = true;
+            continue;
+        }
+        name += upper ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : c;
+        upper = false;
+    }
+    return name;
+}
+
+static std::string generateIdHeader(const game::AssetManifest& manifest)
+{
+    std::vector<const game::AssetManifest::Entry*> byPath;
+    std::map<std::string, int> nameUses;
+    for (size_t i = 0; i < manifest.count(); ++i)
+    {
+        byPath.push_back(&manifest.entry(i));
+        nameUses[constantName(manifest.entry(i).path, false)]++;
+    }
+    std::sort(byPath.begin(), byPath.end(),
+        [](const game::AssetManifest::Entry* a, const game::AssetManifest::Entry* b) { return a->path < b->path; });
+
+    std::string out =
+        "// ---------------------------------------------------------------------------\n"
+        "// asset_ids.hpp\n"
+        "// ---------------------------------------------------------------------------\n"
+        "//\n"
+        "// Generated by Tools/assetcook from the asset manifest. Do not edit, rerun\n"
+        "//   assetcook -g AlphaTemp/asset_ids.hpp\n"
+        "// after adding, renaming or removing assets.\n"
+        "//\n"
+        "\n"
+        "#ifndef ASSET_IDS_HPP\n"
+        "#define ASSET_IDS_HPP\n"
+        "\n"
+        "#include \"asset_id.hpp\"\n"
+        "\n"
+        "namespace assets\n"
+        "{\n";
+
+    for (const auto* e : byPath)
+    {
+        // Two assets that differ only by extension keep it in the name.
+        std::string name = constantName(e->path, nameUses[constantName(e->path, false)] > 1);
+        out += "    constexpr game::AssetId " + name + " = game::assetId(\"" + e->path + "\");\n";
+    }
+
+    out +=
+        "}\n"
+        "\n"
+        "#endif // ASSET_IDS_HPP\n"
+        "\n"
+        "// Reverse table for game::assetName(); only asset_id.cpp asks for it.\n"
+        "#if defined(ASSET_IDS_NAME_TABLE) && !defined(ASSET_IDS_NAME_TABLE_DEFINED)\n"
+        "#define ASSET_IDS_NAME_TABLE_DEFINED\n"
+        "\n"
+        "namespace assets\n"
+        "{\n"
+        "    struct NameEntry\n"
+        "    {\n"
+        "        u64 id;\n"
+        "        const char* path;\n"
+        "    };\n"
+        "\n"
+        "    // sorted by id\n"
+        "    static const NameEntry kNameTable[] =\n"
+        "    {\n";
+
+    // manifest entries are already in id order
+    char buf[64];
+    for (size_t i = 0; i < manifest.count(); ++i)
+    {
+        std::snprintf(buf, sizeof(buf), "        { 0x%016llxull, \"",
+            static_cast<unsigned long long>(manifest.entry(i).id));
+        out += buf + manifest.entry(i).path + "\" },\n";
+    }
+
+    out +=
+        "    };\n"
+        "}\n"
+        "\n"
+        "#endif // ASSET_IDS_NAME_TABLE\n";
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    std::string root = "Assets";
+    std::string packPath = "Assets.pak";
+    fs::path cacheDir = "Cooked";
+    std::string headerPath;
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    bool force = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            packPath = argv[++i];
+        else if (std::strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            cacheDir = argv[++i];
+        else if (std::strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+            headerPath = argv[++i];
+        else if (std::strcmp(argv[i], "-f") == 0)
+            force = true;
+        else if (argv[i][0] == '-')
+        {
+            std::fprintf(stderr, "usage: assetcook [-j jobs] [-o out.pak] [-c cachedir] [-g header] [-f] [folder]\n");
+            return 2;
+        }
+        else
+            root = argv[i];
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<CookJob> jobs;
+    if (!scanSources(root, cacheDir, jobs))
+        return 1;
+
+    const fs::path cachePath = cacheDir / "cook.cache";
+    CookCache previous;
+    loadCache(cachePath, previous);
+
+    runJobs(jobs, previous, force, threadCount);
+
+    // New cache: only sources that still exist, so deleted assets drop out.
+    CookCache cache;
+    int cooked = 0, cached = 0, failed = 0;
+    for (const CookJob& job : jobs)
+    {
+        if (job.result == JobResult::Failed)
+        {
+            std::fprintf(stderr, "assetcook: %s: %s\n", job.source.generic_string().c_str(), job.error.c_str());
+            ++failed;
+            continue;
+        }
+        if (job.result == JobResult::Cooked)
+        {
+            std::printf("  cooked %s (%s)\n", job.asset.c_str(), job.rule->name);
+            ++cooked;
+        }
+        else
+            ++cached;
+        cache[job.asset] = job.cache;
+    }
+
+    std::error_code ec;
+    for (const auto& kv : previous)
+    {
+        if (cache.find(kv.first) == cache.end())
+            fs::remove(cacheDir / kv.first, ec);
+    }
+
+    fs::create_directories(cacheDir, ec);
+    if (!saveCache(cachePath, cache))
+        std::fprintf(stderr, "assetcook: cannot write %s\n", cachePath.generic_string().c_str());
+
+    if (failed > 0)
+    {
+        std::fprintf(stderr, "assetcook: %d failed, pack not written\n", failed);
+        return 1;
+    }
+
+    // Manifest of the cooked set. It goes in the pack and next to the
+    // cooked files (for tools).
+    game::AssetManifest manifest;
+    for (const CookJob& job : jobs)
+    {
+        game::AssetManifest::Entry e;
+        e.id = game::hashAssetPath(job.asset.c_str());
+        e.type = static_cast<u16>(job.rule->type);
+        e.size = static_cast<u32>(job.bytes.size());
+        e.contentHash = job.cache.outputHash;
+        e.path = job.asset;
+        manifest.add(e);
+    }
+    const std::string manifestText = manifest.serialise();
+    const std::vector<u8> manifestBytes(manifestText.begin(), manifestText.end());
+
+    if (!headerPath.empty())
+    {
+        // Only touch the header when it changes, it is included everywhere.
+        const std::string header = generateIdHeader(manifest);
+        std::vector<u8> oldHeader;
+        const std::vector<u8> headerBytes(header.begin(), header.end());
+        if (!readFile(headerPath, oldHeader) || oldHeader != headerBytes)
+        {
+            if (!writeFileAtomic(headerPath, headerBytes))
+            {
+                std::fprintf(stderr, "assetcook: cannot write %s\n", headerPath.c_str());
+                return 1;
+            }
+            std::printf("  wrote %s\n", headerPath.c_str());
+        }
+    }
+
+    const fs::path manifestPath = cacheDir / "assets.manifest";
+    std::vector<u8> oldManifest;
+    const bool unchanged = !force && readFile(manifestPath, oldManifest) &&
+        oldManifest == manifestBytes && fs::exists(packPath);
+
+    if (!unchanged)
+    {
+        game::PackWriter writer;
+        for (const CookJob& job : jobs)
+        {
+            if (!writer.add(job.asset, job.bytes, job.rule->type))
+            {
+                std::fprintf(stderr, "assetcook: hash collision on %s\n", job.asset.c_str());
+                return 1;
+            }
+        }
+        writer.add(game::kManifestPath, manifestBytes);
+
+        std::string error;
+        if (!writer.write(packPath.c_str(), error))
+        {
+            std::fprintf(stderr, "assetcook: %s\n", error.c_str());
+            return 1;
+        }
+        writeFileAtomic(manifestPath, manifestBytes);
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::printf("assetcook: %zu assets, %d cooked, %d up to date, %s %s (%u threads, %.0f ms)\n",
+        jobs.size(), cooked, cached, packPath.c_str(), unchanged ? "unchanged" : "written",
+        threadCount, ms);
+    return 0;
+}
@@ -0,0 +1,424 @@
+// ---------------------------------------------------------------------------
+// png.cpp
+// ---------------------------------------------------------------------------
+
+#include "png.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace png
+{
+    namespace
+    {
+        // ---------------------------------------------------------------
+        // inflate (RFC 1951)
+        // ---------------------------------------------------------------
+        struct Huffman
+        {
+            uint16_t counts[16];    // codes per length
+            uint16_t symbols[288];  // symbols ordered by code
+        };
+
+        struct BitReader
+        {
+            const uint8_t* data;
+            size_t size;
+            size_t pos;
+            uint32_t bitBuf;
+            int bitCount;
+            bool overrun;
+
+            int bits(int need)
+            {
+                uint32_t val = bitBuf;
+                while (bitCount < need)
+                {
+                    if (pos >= size)
+                    {
+                        overrun = true;
+                        return 0;
+                    }
+                    val |= static_cast<uint32_t>(data[pos++]) << bitCount;
+                    bitCount += 8;
+                }
+                bitBuf = val >> need;
+                bitCount -= need;
+                return static_cast<int>(val & ((1u << need) - 1));
+            }
+        };
+
+        bool buildHuffman(Huffman& h, const uint8_t* lengths, int n)
+        {
+            std::memset(h.counts, 0, sizeof(h.counts));
+            for (int i = 0; i < n; ++i)
+                h.counts[lengths[i]]++;
+            h.counts[0] = 0;
+
+            int left = 1;
+            for (int len = 1; len < 16; ++len)
+            {
+                left <<= 1;
+                left -= h.counts[len];
+                if (left < 0)
+                    return false;   // over-subscribed
+            }
+
+            uint16_t offs[16];
+            offs[1] = 0;
+            for (int len = 1; len < 15; ++len)
+                offs[len + 1] = offs[len] + h.counts[len];
+            for (int i = 0; i < n; ++i)
+            {
+                if (lengths[i])
+                    h.symbols[offs[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+            return true;
+        }
+
+        int decodeSymbol(BitReader& br, const Huffman& h)
+        {
+            int code = 0, first = 0, index = 0;
+            for (int len = 1; len < 16; ++len)
+            {
+                code |= br.bits(1);
+                int count = h.counts[len];
+                if (code - count < first)
+                    return h.symbols[index + (code - first)];
+                index += count;
+                first += count;
+                first <<= 1;
+                code <<= 1;
+                if (br.overrun)
+                    return -1;
+            }
+            return -1;
+        }
+
+        const uint16_t kLenBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        const uint8_t kLenExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        const uint16_t kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        const uint8_t kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        bool inflateCodes(BitReader& br, std::vector<uint8_t>& out, const Huffman& lit, const Huffman& dist)
+        {
+            for (;;)
+            {
+                int sym = decodeSymbol(br, lit);
+                if (sym < 0)
+                    return false;
+                if (sym < 256)
+                {
+                    out.push_back(static_cast<uint8_t>(sym));
+                    continue;
+                }
+                if (sym == 256)
+                    return true;
+
+                sym -= 257;
+                if (sym >= 29)
+                    return false;
+                size_t len = kLenBase[sym] + br.bits(kLenExtra[sym]);
+
+                int dsym = decodeSymbol(br, dist);
+                if (dsym < 0 || dsym >= 30)
+                    return false;
+                size_t d = kDistBase[dsym] + br.bits(kDistExtra[dsym]);
+                if (br.overrun || d > out.size())
+                    return false;
+
+                size_t from = out.size() - d;
+                for (size_t i = 0; i < len; ++i)
+                    out.push_back(out[from + i]);
+            }
+        }
+
+        bool inflateDynamic(BitReader& br, std::vector<uint8_t>& out)
+        {
+            static const uint8_t kOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            int nlen = br.bits(5) + 257;
+            int ndist = br.bits(5) + 1;
+            int ncode = br.bits(4) + 4;
+            if (nlen > 286 || ndist > 30)
+                return false;
+
+            uint8_t lengths[320] = {};
+            for (int i = 0; i < ncode; ++i)
+                lengths[kOrder[i]] = static_cast<uint8_t>(br.bits(3));
+
+            Huffman codeLen;
+            if (!buildHuffman(codeLen, lengths, 19))
+                return false;
+
+            int index = 0;
+            while (index < nlen + ndist)
+            {
+                int sym = decodeSymbol(br, codeLen);
+                if (sym < 0)
+                    return false;
+                if (sym < 16)
+                {
+                    lengths[index++] = static_cast<uint8_t>(sym);
+                    continue;
+                }
+
+                uint8_t value = 0;
+                int repeat = 0;
+                if (sym == 16)
+                {
+                    if (index == 0)
+                        return false;
+                    value = lengths[index - 1];
+                    repeat = 3 + br.bits(2);
+                }
+                else if (sym == 17)
+                    repeat = 3 + br.bits(3);
+                else
+                    repeat = 11 + br.bits(7);
+
+                if (index + repeat > nlen + ndist)
+                    return false;
+                while (repeat--)
+                    lengths[index++] = value;
+            }
+
+            Huffman lit, dist;
+            if (!buildHuffman(lit, lengths, nlen) || !buildHuffman(dist, lengths + nlen, ndist))
+                return false;
+            return inflateCodes(br, out, lit, dist);
+        }
+
+        bool inflateFixed(BitReader& br, std::vector<uint8_t>& out)
+        {
+            static Huffman lit, dist;
+            static bool built = false;
+            if (!built)
+            {
+                uint8_t lengths[288];
+                for (int i = 0; i < 144; ++i) lengths[i] = 8;
+                for (int i = 144; i < 256; ++i) lengths[i] = 9;
+                for (int i = 256; i < 280; ++i) lengths[i] = 7;
+                for (int i = 280; i < 288; ++i) lengths[i] = 8;
+                buildHuffman(lit, lengths, 288);
+                for (int i = 0; i < 30; ++i) lengths[i] = 5;
+                buildHuffman(dist, lengths, 30);
+                built = true;
+            }
+            return inflateCodes(br, out, lit, dist);
+        }
+
+        uint32_t readBE32(const uint8_t* p)
+        {
+            return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                (static_cast<uint32_t>(p[2]) << 8) | p[3];
+        }
+
+        int paeth(int a, int b, int c)
+        {
+            int p = a + b - c;
+            int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+            if (pa <= pb && pa <= pc)
+                return a;
+            return pb <= pc ? b : c;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // inflateZlib
+    // -------------------------------------------------------------------
+    bool inflateZlib(const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error)
+    {
+        if (size < 2 || (data[0] & 0x0F) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20))
+        {
+            error = "bad zlib header";
+            return false;
+        }
+
+        BitReader br{ data + 2, size - 2, 0, 0, 0, false };
+        int last = 0;
+        do
+        {
+            last = br.bits(1);
+            int type = br.bits(2);
+            bool ok = false;
+
+            if (type == 0)
+            {
+                // Stored block: byte aligned LEN / NLEN then raw bytes.
+                br.bitBuf = 0;
+                br.bitCount = 0;
+                if (br.pos + 4 > br.size)
+                {
+                    error = "truncated stored block";
+                    return false;
+                }
+                size_t len = br.data[br.pos] | (br.data[br.pos + 1] << 8);
+                size_t nlen = br.data[br.pos + 2] | (br.data[br.pos + 3] << 8);
+                br.pos += 4;
+                ok = len == (~nlen & 0xFFFF) && br.pos + len <= br.size;
+                if (ok)
+                {
+                    out.insert(out.end(), br.data + br.pos, br.data + br.pos + len);
+                    br.pos += len;
+                }
+            }
+            else if (type == 1)
+                ok = inflateFixed(br, out);
+            else if (type == 2)
+                ok = inflateDynamic(br, out);
+
+            if (!ok || br.overrun)
+            {
+                error = "corrupt deflate stream";
+                return false;
+            }
+        } while (!last);
+
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // decode
+    // -------------------------------------------------------------------
+    bool decode(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height,
+        std::vector<uint8_t>& rgba, std::string& error)
+    {
+        static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        if (size < 8 || std::memcmp(data, kSignature, 8) != 0)
+        {
+            error = "not a PNG file";
+            return false;
+        }
+
+        uint8_t colorType = 0, bitDepth = 0, interlace = 0;
+        std::vector<uint8_t> idat;
+        std::vector<uint8_t> palette;   // RGBA
+        width = height = 0;
+
+        size_t pos = 8;
+        while (pos + 12 <= size)
+        {
+            uint32_t len = readBE32(data + pos);
+            const uint8_t* type = data + pos + 4;
+            const uint8_t* body = data + pos + 8;
+            if (len > size - pos - 12)
+            {
+                error = "truncated chunk";
+                return false;
+            }
+
+            if (std::memcmp(type, "IHDR", 4) == 0 && len >= 13)
+            {
+                width = readBE32(body);
+                height = readBE32(body + 4);
+                bitDepth = body[8];
+                colorType = body[9];
+                interlace = body[12];
+            }
+            else if (std::memcmp(type, "PLTE", 4) == 0)
+            {
+                palette.assign(256 * 4, 255);
+                for (uint32_t i = 0; i < len / 3 && i < 256; ++i)
+                    std::memcpy(&palette[i * 4], body + i * 3, 3);
+            }
+            else if (std::memcmp(type, "tRNS", 4) == 0 && colorType == 3 && !palette.empty())
+            {
+                for (uint32_t i = 0; i < len && i < 256; ++i)
+                    palette[i * 4 + 3] = body[i];
+            }
+            else if (std::memcmp(type, "IDAT", 4) == 0)
+                idat.insert(idat.end(), body, body + len);
+            else if (std::memcmp(type, "IEND", 4) == 0)
+                break;
+
+            pos += 12 + len;
+        }
+
+        int channels = 0;
+        switch (colorType)
+        {
+        case 0: channels = 1; break;
+        case 2: channels = 3; break;
+        case 3: channels = 1; break;
+        case 4: channels = 2; break;
+        case 6: channels = 4; break;
+        default: break;
+        }
+
+        if (width == 0 || height == 0 || width > 16384 || height > 16384)
+        {
+            error = "bad image size";
+            return false;
+        }
+        if (channels == 0 || bitDepth != 8 || interlace != 0 || (colorType == 3 && palette.empty()))
+        {
+            error = "unsupported PNG format (need 8-bit, non-interlaced)";
+            return false;
+        }
+
+        std::vector<uint8_t> raw;
+        raw.reserve(static_cast<size_t>(width * channels + 1) * height);
+        if (!inflateZlib(idat.data(), idat.size(), raw, error))
+            return false;
+
+        const size_t stride = static_cast<size_t>(width) * channels;
+        if (raw.size() < (stride + 1) * height)
+        {
+            error = "image data too short";
+            return false;
+        }
+
+        // Undo the per-row filters in place.
+        std::vector<uint8_t> prevRow(stride, 0);
+        std::vector<uint8_t> pixels(stride * height);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const uint8_t filter = raw[y * (stride + 1)];
+            const uint8_t* src = &raw[y * (stride + 1) + 1];
+            uint8_t* row = &pixels[y * stride];
+
+            for (size_t x = 0; x < stride; ++x)
+            {
+                int a = x >= static_cast<size_t>(channels) ? row[x - channels] : 0;
+                int b = prevRow[x];
+                int c = x >= static_cast<size_t>(channels) ? prevRow[x - channels] : 0;
+                int v = src[x];
+                switch (filter)
+                {
+                case 0: break;
+                case 1: v += a; break;
+                case 2: v += b; break;
+                case 3: v += (a + b) >> 1; break;
+                case 4: v += paeth(a, b, c); break;
+                default:
+                    error = "bad row filter";
+                    return false;
+                }
+                row[x] = static_cast<uint8_t>(v);
+            }
+            std::memcpy(prevRow.data(), row, stride);
+        }
+
+        // Expand to RGBA8.
+        rgba.resize(static_cast<size_t>(width) * height * 4);
+        const size_t count = static_cast<size_t>(width) * height;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint8_t* p = &pixels[i * channels];
+            uint8_t* o = &rgba[i * 4];
+            switch (colorType)
+            {
+            case 0: o[0] = o[1] = o[2] = p[0]; o[3] = 255; break;
+            case 2: o[0] = p[0]; o[1] = p[1]; o[2] = p[2]; o[3] = 255; break;
+            case 3: std::memcpy(o, &palette[p[0] * 4], 4); break;
+            case 4: o[0] = o[1] = o[2] = p[0]; o[3] = p[1]; break;
+            case 6: std::memcpy(o, p, 4); break;
+            }
+        }
+        return true;
+    }
+}
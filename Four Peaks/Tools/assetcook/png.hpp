@@ -0,0 +1,26 @@
+// ---------------------------------------------------------------------------
+// png.hpp
+// ---------------------------------------------------------------------------
+//
+// Minimal PNG decoder for the cook tool: 8-bit grey, grey+alpha, RGB, RGBA
+// and palette images, non-interlaced. Always outputs RGBA8, rows top first.
+//
+
+#ifndef PNG_HPP
+#define PNG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace png
+{
+    bool decode(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height,
+        std::vector<uint8_t>& rgba, std::string& error);
+
+    // zlib stream -> bytes (used by decode, exposed for tests / other formats).
+    bool inflateZlib(const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error);
+}
+
+#endif // PNG_HPP
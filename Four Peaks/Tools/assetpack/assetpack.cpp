@@ -0,0 +1,153 @@
+// ---------------------------------------------------------------------------
+// assetpack.cpp
+// ---------------------------------------------------------------------------
+//
+// Packs an asset folder into a .pak archive (see AlphaTemp/asset_pack.hpp).
+//
+// Usage (from the game's working directory):
+//   assetpack [-o Assets.pak] [-a <alignment>] [Assets]
+//   assetpack -l Assets.pak                        lists the entries
+//
+// Entries are stored under their path relative to the working directory
+// ("Assets/..."), which is what the game passes to vfs::open. Level text
+// sources are skipped, the converted .lvl files are packed instead.
+//
+// Build (from this folder):
+//   g++ -std=c++17 -O2 -I../../AlphaTemp -I../../Extern/AlphaEngine/include
+//       assetpack.cpp ../../AlphaTemp/asset_pack.cpp ../../AlphaTemp/lz4.cpp
+//       ../../AlphaTemp/mapped_file.cpp
+//       -o assetpack
+//   cl /std:c++17 /O2 /EHsc /I..\..\AlphaTemp /I..\..\Extern\AlphaEngine\include
+//       assetpack.cpp ..\..\AlphaTemp\asset_pack.cpp ..\..\AlphaTemp\lz4.cpp
+//       ..\..\AlphaTemp\mapped_file.cpp
+// ---------------------------------------------------------------------------
+
+#include "asset_pack.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool readFile(const fs::path& path, std::vector<u8>& out)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+
+    std::streamsize size = in.tellg();
+    in.seekg(0);
+    out.resize(static_cast<size_t>(size));
+    return size == 0 || in.read(reinterpret_cast<char*>(out.data()), size).good();
+}
+
+static bool skipFile(const fs::path& path)
+{
+    // Level sources live next to their .lvl; only the binary ships.
+    if (path.extension() == ".txt" && path.parent_path().filename() == "levels")
+        return true;
+    const std::string name = path.filename().string();
+    return name.empty() || name[0] == '.';
+}
+
+static int listPack(const char* path)
+{
+    game::PackFile pack;
+    if (!pack.open(path))
+    {
+        std::fprintf(stderr, "assetpack: cannot open %s\n", path);
+        return 1;
+    }
+
+    for (size_t i = 0; i < pack.entryCount(); ++i)
+    {
+        const game::PackEntry& e = pack.entry(i);
+        std::printf("%016llx %10u %10u %s %s\n",
+            static_cast<unsigned long long>(e.hash), e.rawSize, e.size,
+            e.compression == static_cast<u16>(game::PackCompression::Lz4) ? "lz4" : "raw",
+            pack.entryName(e));
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    std::string output = "Assets.pak";
+    std::string root = "Assets";
+    u32 alignment = 16;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+            return listPack(argv[i + 1]);
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (std::strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+            alignment = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        else if (argv[i][0] == '-')
+        {
+            std::fprintf(stderr, "usage: assetpack [-o out.pak] [-a alignment] [folder] | -l <pak>\n");
+            return 2;
+        }
+        else
+            root = argv[i];
+    }
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        std::fprintf(stderr, "assetpack: alignment must be a power of two\n");
+        return 2;
+    }
+
+    std::error_code ec;
+    std::vector<fs::path> files;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (it->is_regular_file() && !skipFile(it->path()))
+            files.push_back(it->path());
+    }
+    if (ec)
+    {
+        std::fprintf(stderr, "assetpack: cannot read %s: %s\n", root.c_str(), ec.message().c_str());
+        return 1;
+    }
+
+    // Stable input order so identical folders give identical packs.
+    std::sort(files.begin(), files.end());
+
+    game::PackWriter writer(alignment);
+    size_t rawTotal = 0;
+    for (const fs::path& file : files)
+    {
+        std::vector<u8> bytes;
+        if (!readFile(file, bytes))
+        {
+            std::fprintf(stderr, "assetpack: cannot read %s\n", file.string().c_str());
+            return 1;
+        }
+
+        const std::string name = file.generic_string();
+        if (!writer.add(name, bytes))
+        {
+            std::fprintf(stderr, "assetpack: hash collision on %s\n", name.c_str());
+            return 1;
+        }
+        rawTotal += bytes.size();
+    }
+
+    std::string error;
+    if (!writer.write(output.c_str(), error))
+    {
+        std::fprintf(stderr, "assetpack: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::printf("%s: %zu files, %zu bytes -> %llu bytes\n", output.c_str(), files.size(),
+        rawTotal, static_cast<unsigned long long>(fs::file_size(output, ec)));
+    return 0;
+}
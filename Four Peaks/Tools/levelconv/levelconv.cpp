@@ -0,0 +1,85 @@
+// ---------------------------------------------------------------------------
+// levelconv.cpp
+// ---------------------------------------------------------------------------
+//
+// Converts level text sources (Assets/levels/*.txt) into binary .lvl files.
+//
+// Usage:
+//   levelconv <source.txt> [<more.txt> ...]     writes <source>.lvl next to each
+//   levelconv -o <out.lvl> <source.txt>
+//
+// Build (from this folder):
+//   g++ -std=c++17 -O2 -I../../AlphaTemp -I../../Extern/AlphaEngine/include
+//       levelconv.cpp ../../AlphaTemp/level_format.cpp ../../AlphaTemp/mapped_file.cpp
+//       ../../AlphaTemp/tilemap.cpp ../../AlphaTemp/vfs.cpp ../../AlphaTemp/asset_pack.cpp
+//       ../../AlphaTemp/lz4.cpp ../../AlphaTemp/asset_id.cpp ../../AlphaTemp/asset_manifest.cpp
+//       -o levelconv
+//   cl /std:c++17 /O2 /EHsc /I..\..\AlphaTemp /I..\..\Extern\AlphaEngine\include
+//       levelconv.cpp ..\..\AlphaTemp\level_format.cpp ..\..\AlphaTemp\mapped_file.cpp
+//       ..\..\AlphaTemp\tilemap.cpp ..\..\AlphaTemp\vfs.cpp ..\..\AlphaTemp\asset_pack.cpp
+//       ..\..\AlphaTemp\lz4.cpp ..\..\AlphaTemp\asset_id.cpp ..\..\AlphaTemp\asset_manifest.cpp
+// ---------------------------------------------------------------------------
+
+#include "level_format.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static std::string replaceExtension(const std::string& path, const char* ext)
+{
+    size_t slash = path.find_last_of("/\\");
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return path + ext;
+    return path.substr(0, dot) + ext;
+}
+
+static bool convertOne(const std::string& src, const std::string& dst)
+{
+    std::string error;
+    if (!game::convertLevelText(src.c_str(), dst.c_str(), error))
+    {
+        std::fprintf(stderr, "levelconv: %s\n", error.c_str());
+        return false;
+    }
+
+    // Round-trip through the runtime loader so a bad file never ships.
+    game::LevelFile check;
+    if (!check.open(dst.c_str()))
+    {
+        std::fprintf(stderr, "levelconv: %s failed validation\n", dst.c_str());
+        return false;
+    }
+
+    std::printf("%s -> %s (%dx%d, %d layers, %d spawns)\n",
+        src.c_str(), dst.c_str(), check.cols(), check.rows(),
+        check.layerCount(), check.spawnCount());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: levelconv <source.txt>... | -o <out.lvl> <source.txt>\n");
+        return 2;
+    }
+
+    if (std::strcmp(argv[1], "-o") == 0)
+    {
+        if (argc != 4)
+        {
+            std::fprintf(stderr, "usage: levelconv -o <out.lvl> <source.txt>\n");
+            return 2;
+        }
+        return convertOne(argv[3], argv[2]) ? 0 : 1;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!convertOne(argv[i], replaceExtension(argv[i], ".lvl")))
+            ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}